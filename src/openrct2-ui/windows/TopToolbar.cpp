@@ -27,6 +27,7 @@
 #include <openrct2/ParkImporter.h>
 #include <openrct2/actions/BannerPlaceAction.hpp>
 #include <openrct2/actions/BannerSetColourAction.hpp>
+#include <openrct2/actions/BatchAction.hpp>
 #include <openrct2/actions/ClearAction.hpp>
 #include <openrct2/actions/FootpathSceneryPlaceAction.hpp>
 #include <openrct2/actions/LandLowerAction.hpp>
@@ -64,6 +65,7 @@
 #include <openrct2/world/Surface.h>
 #include <openrct2/world/Wall.h>
 #include <string>
+#include <vector>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Ui;
@@ -1733,6 +1735,29 @@ static void sub_6E1F34(
     }
 }
 
+/**
+ * A small scenery placement of a cluster that has been queried but not placed yet.
+ */
+struct ClusterPiece
+{
+    int16_t X;
+    int16_t Y;
+    uint8_t BaseHeight;
+    uint8_t ClearanceHeight;
+    uint8_t QuarterTileOccupied;
+
+    static ClusterPiece FromResult(int16_t x, int16_t y, const SmallSceneryPlaceActionResult& result)
+    {
+        return { x, y, result.BaseHeight, result.ClearanceHeight, result.QuarterTileOccupied };
+    }
+
+    bool Overlaps(const ClusterPiece& other) const
+    {
+        return X == other.X && Y == other.Y && (QuarterTileOccupied & other.QuarterTileOccupied) != 0
+            && BaseHeight < other.ClearanceHeight && other.BaseHeight < ClearanceHeight;
+    }
+};
+
 /**
  *
  *  rct2: 0x006E2CC6
@@ -1779,6 +1804,10 @@ static void window_top_toolbar_scenery_tool_down(int16_t x, int16_t y, rct_windo
             }
 
             bool forceError = true;
+            // The placements of a cluster are run as a single action
+            BatchAction clusterAction;
+            money32 clusterCost = 0;
+            std::vector<ClusterPiece> clusterPieces;
             for (int32_t q = 0; q < quantity; q++)
             {
                 int32_t zCoordinate = gSceneryPlaceZ;
@@ -1815,6 +1844,7 @@ static void window_top_toolbar_scenery_tool_down(int16_t x, int16_t y, rct_windo
                 uint8_t secondaryColour = (parameter_3 >> 16) & 0xFF;
                 uint8_t type = (parameter_1 >> 8) & 0xFF;
                 auto success = GA_ERROR::UNKNOWN;
+                money32 cost = 0;
                 // Try find a valid z coordinate
                 for (; zAttemptRange != 0; zAttemptRange--)
                 {
@@ -1823,8 +1853,25 @@ static void window_top_toolbar_scenery_tool_down(int16_t x, int16_t y, rct_windo
                         secondaryColour);
                     auto res = GameActions::Query(&smallSceneryPlaceAction);
                     success = res->Error;
-                    if (res->Error == GA_ERROR::OK)
+                    if (res->Error == GA_ERROR::OK && isCluster)
+                    {
+                        // The earlier pieces of the cluster are not on the map yet, so they are checked here
+                        auto piece = ClusterPiece::FromResult(
+                            cur_grid_x, cur_grid_y, *dynamic_cast<SmallSceneryPlaceActionResult*>(res.get()));
+                        if (std::any_of(clusterPieces.begin(), clusterPieces.end(), [&piece](const ClusterPiece& other) {
+                                return piece.Overlaps(other);
+                            }))
+                        {
+                            success = GA_ERROR::NO_CLEARANCE;
+                        }
+                        else
+                        {
+                            clusterPieces.push_back(piece);
+                        }
+                    }
+                    if (success == GA_ERROR::OK)
                     {
+                        cost = res->Cost;
                         break;
                     }
 
@@ -1838,8 +1885,22 @@ static void window_top_toolbar_scenery_tool_down(int16_t x, int16_t y, rct_windo
                     }
                 }
 
+                if (isCluster && success == GA_ERROR::OK)
+                {
+                    // Only add what can be paid for along with the rest of the cluster
+                    if (!finance_check_affordability(clusterCost + cost, 0))
+                    {
+                        gSceneryPlaceZ = zCoordinate;
+                        break;
+                    }
+                    clusterCost += cost;
+                    clusterAction.AddAction(std::make_unique<SmallSceneryPlaceAction>(
+                        CoordsXYZD{ cur_grid_x, cur_grid_y, gSceneryPlaceZ, gSceneryPlaceRotation }, quadrant, type,
+                        primaryColour, secondaryColour));
+                    forceError = false;
+                }
                 // Actually place
-                if (success == GA_ERROR::OK || ((q + 1 == quantity) && forceError))
+                else if (success == GA_ERROR::OK || ((q + 1 == quantity) && forceError))
                 {
                     auto smallSceneryPlaceAction = SmallSceneryPlaceAction(
                         { cur_grid_x, cur_grid_y, gSceneryPlaceZ, gSceneryPlaceRotation }, quadrant, type, primaryColour,
@@ -1864,6 +1925,17 @@ static void window_top_toolbar_scenery_tool_down(int16_t x, int16_t y, rct_windo
                 }
                 gSceneryPlaceZ = zCoordinate;
             }
+
+            if (!clusterAction.GetActions().empty())
+            {
+                clusterAction.SetCallback([](const GameAction* ga, const GameActionResult* result) {
+                    if (result->Error == GA_ERROR::OK)
+                    {
+                        audio_play_sound_at_location(SoundId::PlaceItem, result->Position);
+                    }
+                });
+                GameActions::Execute(&clusterAction);
+            }
             break;
         }
         case SCENERY_TYPE_PATH_ITEM:
@@ -692,6 +692,8 @@ void game_load_init()
 
     IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
     snapshots->Reset();
+    peep_tick_scheduler_reset();
+    gFootpathNetworkVersion++;
 
     gScreenFlags = SCREEN_FLAGS_PLAYING;
     audio_stop_all_music_and_sounds();
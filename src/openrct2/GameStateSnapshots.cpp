@@ -510,7 +510,7 @@ struct GameStateSnapshots : public IGameStateSnapshots
         return "Unknown";
     }
 
-    virtual bool LogCompareDataToFile(const std::string& fileName, const GameStateCompareData_t& cmpData) const override
+    virtual std::string GetCompareDataText(const GameStateCompareData_t& cmpData) const override
     {
         std::string outputBuffer;
         char tempBuffer[1024] = {};
@@ -557,6 +557,13 @@ struct GameStateSnapshots : public IGameStateSnapshots
             }
         }
 
+        return outputBuffer;
+    }
+
+    virtual bool LogCompareDataToFile(const std::string& fileName, const GameStateCompareData_t& cmpData) const override
+    {
+        std::string outputBuffer = GetCompareDataText(cmpData);
+
         FILE* fp = fopen(fileName.c_str(), "wt");
         if (!fp)
             return false;
@@ -99,6 +99,11 @@ interface IGameStateSnapshots
      */
     virtual GameStateCompareData_t Compare(const GameStateSnapshot_t& base, const GameStateSnapshot_t& cmp) const = 0;
 
+    /*
+     * Returns the GameStateCompareData_t as readable text.
+     */
+    virtual std::string GetCompareDataText(const GameStateCompareData_t& cmpData) const = 0;
+
     /*
      * Writes the GameStateCompareData_t into the specified file as readable text.
      */
@@ -11,6 +11,8 @@
 
 #include "Context.h"
 #include "Game.h"
+#include "GameState.h"
+#include "GameStateSnapshots.h"
 #include "OpenRCT2.h"
 #include "ParkImporter.h"
 #include "PlatformEnvironment.h"
@@ -28,9 +30,11 @@
 #include "object/ObjectManager.h"
 #include "object/ObjectRepository.h"
 #include "rct2/S6Exporter.h"
+#include "scenario/Scenario.h"
 #include "world/Park.h"
 #include "zlib.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <vector>
@@ -74,6 +78,16 @@ namespace OpenRCT2
         MemoryStream data;
     };
 
+    // Full game state captured during the recording so playback can resume from it instead of the start.
+    struct ReplayKeyframe
+    {
+        uint32_t tick;
+        MemoryStream parkData;
+        MemoryStream spriteSpatialData;
+        MemoryStream parkParams;
+        MemoryStream cheatData;
+    };
+
     struct ReplayRecordData
     {
         uint32_t magic;
@@ -91,11 +105,14 @@ namespace OpenRCT2
         std::multiset<ReplayCommand> commands;
         std::vector<std::pair<uint32_t, rct_sprite_checksum>> checksums;
         uint32_t checksumIndex;
+        uint32_t keyframeInterval; // Ticks between keyframes, 0 if the replay has none.
+        std::vector<ReplayKeyframe> keyframes;
     };
 
     class ReplayManager final : public IReplayManager
     {
-        static constexpr uint16_t ReplayVersion = 3;
+        static constexpr uint16_t ReplayVersion = 4;
+        static constexpr uint16_t ReplayVersionKeyframes = 4;
         static constexpr uint32_t ReplayMagic = 0x5243524F; // ORCR.
         static constexpr int ReplayCompressionLevel = 9;
 
@@ -148,6 +165,13 @@ namespace OpenRCT2
             if (_mode == ReplayMode::NONE)
                 return;
 
+            // Checksums and keyframes are captured after the commands of their tick have been executed. When recording
+            // those ran before the tick, when normalising they are replayed here.
+            if (_mode == ReplayMode::NORMALISATION)
+            {
+                ReplayCommands();
+            }
+
             if ((_mode == ReplayMode::RECORDING || _mode == ReplayMode::NORMALISATION) && gCurrentTicks == _nextChecksumTick)
             {
                 rct_sprite_checksum checksum = sprite_checksum();
@@ -156,6 +180,14 @@ namespace OpenRCT2
                 _nextChecksumTick = gCurrentTicks + 1;
             }
 
+            if ((_mode == ReplayMode::RECORDING || _mode == ReplayMode::NORMALISATION)
+                && _currentRecording->keyframeInterval != 0 && gCurrentTicks == _nextKeyframeTick)
+            {
+                AddKeyframe();
+
+                _nextKeyframeTick = gCurrentTicks + _currentRecording->keyframeInterval;
+            }
+
             if (_mode == ReplayMode::RECORDING)
             {
                 if (gCurrentTicks >= _currentRecording->tickEnd)
@@ -166,12 +198,22 @@ namespace OpenRCT2
             }
             else if (_mode == ReplayMode::PLAYING)
             {
+                // The recorded checksum includes the commands of the same tick, except in replays from before keyframes
+                // were added which were normalised with the checksum taken before the commands.
+                bool checksumIncludesCommands = _currentReplay->version >= ReplayVersionKeyframes;
+                if (checksumIncludesCommands)
+                {
+                    ReplayCommands();
+                }
 #ifndef DISABLE_NETWORK
                 // If the network is disabled we will only get a dummy hash which will cause
                 // false positives during replay.
                 CheckState();
 #endif
-                ReplayCommands();
+                if (!checksumIncludesCommands)
+                {
+                    ReplayCommands();
+                }
 
                 // Normal playback will always end at the specific tick.
                 if (gCurrentTicks >= _currentReplay->tickEnd)
@@ -182,8 +224,6 @@ namespace OpenRCT2
             }
             else if (_mode == ReplayMode::NORMALISATION)
             {
-                ReplayCommands();
-
                 // If we run out of commands we can just stop
                 if (_currentReplay->commands.empty())
                 {
@@ -197,7 +237,8 @@ namespace OpenRCT2
             }
         }
 
-        virtual bool StartRecording(const std::string& name, uint32_t maxTicks /*= k_MaxReplayTicks*/) override
+        virtual bool StartRecording(
+            const std::string& name, uint32_t maxTicks /*= k_MaxReplayTicks*/, uint32_t keyframeInterval /*= 0*/) override
         {
             if (_mode != ReplayMode::NONE && _mode != ReplayMode::NORMALISATION)
                 return false;
@@ -208,6 +249,7 @@ namespace OpenRCT2
             replayData->networkId = network_get_version();
             replayData->name = name;
             replayData->tickStart = gCurrentTicks;
+            replayData->keyframeInterval = keyframeInterval;
             if (maxTicks != k_MaxReplayTicks)
                 replayData->tickEnd = gCurrentTicks + maxTicks;
             else
@@ -217,29 +259,16 @@ namespace OpenRCT2
             std::string outPath = GetContext()->GetPlatformEnvironment()->GetDirectoryPath(DIRBASE::USER, DIRID::REPLAY);
             replayData->filePath = Path::Combine(outPath, replayName);
 
-            auto context = GetContext();
-            auto& objManager = context->GetObjectManager();
-            auto objects = objManager.GetPackableObjects();
-
-            auto s6exporter = std::make_unique<S6Exporter>();
-            s6exporter->ExportObjectsList = objects;
-            s6exporter->Export();
-            s6exporter->SaveGame(&replayData->parkData);
-
-            replayData->spriteSpatialData.Write(gSpriteSpatialIndex, sizeof(gSpriteSpatialIndex));
+            CaptureGameState(
+                replayData->parkData, replayData->spriteSpatialData, replayData->parkParams, replayData->cheatData);
             replayData->timeRecorded = std::chrono::seconds(std::time(nullptr)).count();
 
-            DataSerialiser parkParamsDs(true, replayData->parkParams);
-            SerialiseParkParameters(parkParamsDs);
-
-            DataSerialiser cheatDataDs(true, replayData->cheatData);
-            SerialiseCheats(cheatDataDs);
-
             if (_mode != ReplayMode::NORMALISATION)
                 _mode = ReplayMode::RECORDING;
 
             _currentRecording = std::move(replayData);
             _nextChecksumTick = gCurrentTicks + 1;
+            _nextKeyframeTick = gCurrentTicks + keyframeInterval;
 
             return true;
         }
@@ -330,6 +359,7 @@ namespace OpenRCT2
                 info.Ticks = data->tickEnd - data->tickStart;
             info.NumCommands = (uint32_t)data->commands.size();
             info.NumChecksums = (uint32_t)data->checksums.size();
+            info.NumKeyframes = (uint32_t)data->keyframes.size();
 
             return true;
         }
@@ -347,20 +377,13 @@ namespace OpenRCT2
                 return false;
             }
 
-            if (!LoadReplayDataMap(*replayData))
+            if (!LoadReplayState(*replayData, nullptr))
             {
                 log_error("Unable to load map.");
                 return false;
             }
 
-            gCurrentTicks = replayData->tickStart;
-
             _currentReplay = std::move(replayData);
-            _currentReplay->checksumIndex = 0;
-            _faultyChecksumIndex = -1;
-
-            // Make sure game is not paused.
-            gGamePaused = 0;
 
             if (_mode != ReplayMode::NORMALISATION)
                 _mode = ReplayMode::PLAYING;
@@ -400,7 +423,8 @@ namespace OpenRCT2
             return true;
         }
 
-        virtual bool NormaliseReplay(const std::string& file, const std::string& outFile) override
+        virtual bool NormaliseReplay(
+            const std::string& file, const std::string& outFile, uint32_t keyframeInterval /*= 0*/) override
         {
             _mode = ReplayMode::NORMALISATION;
 
@@ -409,7 +433,10 @@ namespace OpenRCT2
                 return false;
             }
 
-            if (!StartRecording(outFile, k_MaxReplayTicks))
+            if (keyframeInterval == 0)
+                keyframeInterval = _currentReplay->keyframeInterval;
+
+            if (!StartRecording(outFile, k_MaxReplayTicks, keyframeInterval))
             {
                 StopPlayback();
                 return false;
@@ -420,38 +447,271 @@ namespace OpenRCT2
             return true;
         }
 
+        virtual bool SeekPlayback(uint32_t tick) override
+        {
+            if (_mode != ReplayMode::PLAYING)
+                return false;
+
+            uint32_t targetTick = _currentReplay->tickStart + tick;
+            if (targetTick > _currentReplay->tickEnd)
+            {
+                log_error("Tick %u is past the end of the replay.", tick);
+                return false;
+            }
+
+            // Commands are discarded once replayed so seeking backwards has to reload the replay, seeking forwards only
+            // reloads it if there is a keyframe closer to the target than the current tick.
+            const ReplayKeyframe* keyframe = FindKeyframe(*_currentReplay, targetTick);
+            if (targetTick < gCurrentTicks || (keyframe != nullptr && keyframe->tick > gCurrentTicks))
+            {
+                auto replayData = std::make_unique<ReplayRecordData>();
+                if (!ReadReplayData(_currentReplay->filePath, *replayData))
+                {
+                    log_error("Unable to read replay data.");
+                    return false;
+                }
+
+                if (!LoadReplayState(*replayData, FindKeyframe(*replayData, targetTick)))
+                {
+                    log_error("Unable to load map.");
+                    StopPlayback();
+                    return false;
+                }
+
+                _currentReplay = std::move(replayData);
+            }
+
+            auto* gameState = GetContext()->GetGameState();
+            while (_mode == ReplayMode::PLAYING && gCurrentTicks < targetTick)
+            {
+                gameState->UpdateLogic();
+            }
+
+            return true;
+        }
+
+        virtual bool VerifyRange(
+            const std::string& file, uint32_t startTick, uint32_t endTick, ReplayVerifyResult& result) override
+        {
+            if (_mode != ReplayMode::NONE)
+                return false;
+
+            auto replayData = std::make_unique<ReplayRecordData>();
+            if (!ReadReplayData(file, *replayData))
+            {
+                log_error("Unable to read replay data.");
+                return false;
+            }
+
+            const uint32_t tickStart = replayData->tickStart;
+            const uint32_t rangeEnd = (uint32_t)std::min<uint64_t>((uint64_t)tickStart + endTick, replayData->tickEnd);
+
+            if (!LoadReplayState(*replayData, FindKeyframe(*replayData, tickStart + startTick)))
+            {
+                log_error("Unable to load map.");
+                return false;
+            }
+
+            result.StartTick = gCurrentTicks - tickStart;
+            result.NumChecksums = 0;
+            result.MismatchTick = k_MaxReplayTicks;
+            result.MismatchDetails.clear();
+
+            _currentReplay = std::move(replayData);
+            _mode = ReplayMode::PLAYING;
+            _numChecksumsVerified = 0;
+
+            // Playback stops by itself once the end of the replay is reached.
+            auto* gameState = GetContext()->GetGameState();
+            while (_mode == ReplayMode::PLAYING && gCurrentTicks <= rangeEnd && _faultyChecksumIndex == -1)
+            {
+                gameState->UpdateLogic();
+            }
+
+            result.EndTick = std::min(gCurrentTicks, rangeEnd) - tickStart;
+            result.NumChecksums = _numChecksumsVerified;
+            if (_faultyChecksumIndex != -1)
+            {
+                result.MismatchTick = _faultyChecksumTick - tickStart;
+                if (_mode == ReplayMode::PLAYING)
+                {
+                    result.MismatchDetails = CompareWithNextKeyframe();
+                }
+            }
+
+            StopPlayback();
+
+            return true;
+        }
+
     private:
-        bool LoadReplayDataMap(ReplayRecordData& data)
+        void CaptureGameState(
+            MemoryStream& parkData, MemoryStream& spriteSpatialData, MemoryStream& parkParams, MemoryStream& cheatData)
+        {
+            auto context = GetContext();
+            auto& objManager = context->GetObjectManager();
+            auto objects = objManager.GetPackableObjects();
+
+            auto s6exporter = std::make_unique<S6Exporter>();
+            s6exporter->ExportObjectsList = objects;
+            s6exporter->Export();
+            s6exporter->SaveGame(&parkData);
+
+            spriteSpatialData.Write(gSpriteSpatialIndex, sizeof(gSpriteSpatialIndex));
+
+            DataSerialiser parkParamsDs(true, parkParams);
+            SerialiseParkParameters(parkParamsDs);
+
+            DataSerialiser cheatDataDs(true, cheatData);
+            SerialiseCheats(cheatDataDs);
+        }
+
+        /**
+         * Only checksums are recorded for most ticks, so the recorded sprites can only be compared at a keyframe.
+         */
+        std::string CompareWithNextKeyframe()
+        {
+            const auto& keyframes = _currentReplay->keyframes;
+            auto keyframe = std::find_if(
+                keyframes.begin(), keyframes.end(), [](const ReplayKeyframe& k) { return k.tick >= gCurrentTicks; });
+            if (keyframe == keyframes.end())
+                return {};
+
+            auto* gameState = GetContext()->GetGameState();
+            while (_mode == ReplayMode::PLAYING && gCurrentTicks < keyframe->tick)
+            {
+                gameState->UpdateLogic();
+            }
+            if (_mode != ReplayMode::PLAYING)
+                return {};
+
+            // Keyframes are captured after the commands of their tick have been executed.
+            ReplayCommands();
+
+            // Loading the keyframe resets the snapshots, so the current state is kept in serialised form until then
+            auto* snapshots = GetContext()->GetGameStateSnapshots();
+            MemoryStream currentData;
+            {
+                auto& current = snapshots->CreateSnapshot();
+                snapshots->Capture(current);
+                snapshots->LinkSnapshot(current, gCurrentTicks, scenario_rand_state().s0);
+                DataSerialiser currentDs(true, currentData);
+                snapshots->SerialiseSnapshot(current, currentDs);
+            }
+
+            auto& state = const_cast<ReplayKeyframe&>(*keyframe);
+            if (!LoadGameState(state.parkData, state.spriteSpatialData, state.parkParams, state.cheatData))
+                return {};
+
+            currentData.SetPosition(0);
+            DataSerialiser currentDs(false, currentData);
+            auto& current = snapshots->CreateSnapshot();
+            snapshots->SerialiseSnapshot(current, currentDs);
+
+            auto& recorded = snapshots->CreateSnapshot();
+            snapshots->Capture(recorded);
+            snapshots->LinkSnapshot(recorded, keyframe->tick, scenario_rand_state().s0);
+
+            auto cmpData = snapshots->Compare(recorded, current);
+            return snapshots->GetCompareDataText(cmpData);
+        }
+
+        void AddKeyframe()
+        {
+            auto& keyframe = _currentRecording->keyframes.emplace_back();
+            keyframe.tick = gCurrentTicks;
+            CaptureGameState(keyframe.parkData, keyframe.spriteSpatialData, keyframe.parkParams, keyframe.cheatData);
+        }
+
+        /**
+         * Returns the last keyframe at or before the given tick, nullptr if playback has to start from the beginning.
+         */
+        const ReplayKeyframe* FindKeyframe(const ReplayRecordData& data, uint32_t tick) const
+        {
+            const ReplayKeyframe* res = nullptr;
+            for (const auto& keyframe : data.keyframes)
+            {
+                if (keyframe.tick > tick)
+                    break;
+                res = &keyframe;
+            }
+            return res;
+        }
+
+        /**
+         * Loads the game state from the start of the replay or from a keyframe and drops everything recorded before it.
+         */
+        bool LoadReplayState(ReplayRecordData& data, const ReplayKeyframe* keyframe)
+        {
+            uint32_t tick = data.tickStart;
+            if (keyframe == nullptr)
+            {
+                if (!LoadGameState(data.parkData, data.spriteSpatialData, data.parkParams, data.cheatData))
+                    return false;
+            }
+            else
+            {
+                auto& state = const_cast<ReplayKeyframe&>(*keyframe);
+                if (!LoadGameState(state.parkData, state.spriteSpatialData, state.parkParams, state.cheatData))
+                    return false;
+
+                // Keyframes are captured after the commands of their tick have been executed.
+                tick = keyframe->tick;
+                while (!data.commands.empty() && data.commands.begin()->tick <= tick)
+                {
+                    data.commands.erase(data.commands.begin());
+                }
+            }
+
+            data.checksumIndex = 0;
+            while (data.checksumIndex < data.checksums.size() && data.checksums[data.checksumIndex].first < tick)
+            {
+                data.checksumIndex++;
+            }
+
+            gCurrentTicks = tick;
+            _faultyChecksumIndex = -1;
+
+            // Make sure game is not paused.
+            gGamePaused = 0;
+
+            return true;
+        }
+
+        bool LoadGameState(
+            MemoryStream& parkData, MemoryStream& spriteSpatialData, MemoryStream& parkParams, MemoryStream& cheatData)
         {
             try
             {
-                data.parkData.SetPosition(0);
+                parkData.SetPosition(0);
 
                 auto context = GetContext();
                 auto& objManager = context->GetObjectManager();
                 auto importer = ParkImporter::CreateS6(context->GetObjectRepository());
 
-                auto loadResult = importer->LoadFromStream(&data.parkData, false);
+                auto loadResult = importer->LoadFromStream(&parkData, false);
                 objManager.LoadObjects(loadResult.RequiredObjects.data(), loadResult.RequiredObjects.size());
 
                 importer->Import();
 
                 sprite_position_tween_reset();
 
-                Guard::Assert(sizeof(gSpriteSpatialIndex) >= data.spriteSpatialData.GetLength());
+                Guard::Assert(sizeof(gSpriteSpatialIndex) >= spriteSpatialData.GetLength());
 
                 // In case the sprite limit will be increased we keep the unused fields cleared.
                 std::fill_n(gSpriteSpatialIndex, std::size(gSpriteSpatialIndex), SPRITE_INDEX_NULL);
-                std::memcpy(gSpriteSpatialIndex, data.spriteSpatialData.GetData(), data.spriteSpatialData.GetLength());
+                std::memcpy(gSpriteSpatialIndex, spriteSpatialData.GetData(), spriteSpatialData.GetLength());
 
                 // Load all map global variables.
-                DataSerialiser parkParamsDs(false, data.parkParams);
+                parkParams.SetPosition(0);
+                DataSerialiser parkParamsDs(false, parkParams);
                 SerialiseParkParameters(parkParamsDs);
 
                 // New cheats might not be serialised, make sure they are using their defaults.
                 CheatsReset();
 
-                DataSerialiser cheatDataDs(false, data.cheatData);
+                cheatData.SetPosition(0);
+                DataSerialiser cheatDataDs(false, cheatData);
                 SerialiseCheats(cheatDataDs);
 
                 game_load_init();
@@ -619,7 +879,9 @@ namespace OpenRCT2
 
         bool Compatible(ReplayRecordData& data)
         {
-            return data.version == ReplayVersion;
+            // Replays from before keyframes were added lack the keyframes and check their checksums before the commands
+            // of the same tick, see Update.
+            return data.version == ReplayVersion || data.version == ReplayVersionKeyframes - 1;
         }
 
         bool Serialise(DataSerialiser& serialiser, ReplayRecordData& data)
@@ -692,15 +954,37 @@ namespace OpenRCT2
                 serialiser << data.checksums[i].second.raw;
             }
 
+            if (data.version < ReplayVersionKeyframes)
+            {
+                data.keyframeInterval = 0;
+                return true;
+            }
+
+            serialiser << data.keyframeInterval;
+
+            uint32_t countKeyframes = (uint32_t)data.keyframes.size();
+            serialiser << countKeyframes;
+
+            if (serialiser.IsLoading())
+            {
+                data.keyframes.resize(countKeyframes);
+            }
+
+            for (auto& keyframe : data.keyframes)
+            {
+                serialiser << keyframe.tick;
+                serialiser << keyframe.parkData;
+                serialiser << keyframe.spriteSpatialData;
+                serialiser << keyframe.parkParams;
+                serialiser << keyframe.cheatData;
+            }
+
             return true;
         }
 
 #ifndef DISABLE_NETWORK
         void CheckState()
         {
-            if (_nextChecksumTick != gCurrentTicks)
-                return;
-
             uint32_t checksumIndex = _currentReplay->checksumIndex;
 
             if (checksumIndex >= _currentReplay->checksums.size())
@@ -720,6 +1004,7 @@ namespace OpenRCT2
                         replayTick, savedChecksum.second.ToString().c_str(), checksum.ToString().c_str());
 
                     _faultyChecksumIndex = checksumIndex;
+                    _faultyChecksumTick = gCurrentTicks;
                 }
                 else
                 {
@@ -729,6 +1014,7 @@ namespace OpenRCT2
                         savedChecksum.second.ToString().c_str(), checksum.ToString().c_str());
                 }
                 _currentReplay->checksumIndex++;
+                _numChecksumsVerified++;
             }
         }
 #endif // DISABLE_NETWORK
@@ -787,6 +1073,9 @@ namespace OpenRCT2
         uint32_t _commandId = 0;
         uint32_t _nextChecksumTick = 0;
         uint32_t _nextReplayTick = 0;
+        uint32_t _nextKeyframeTick = 0;
+        uint32_t _faultyChecksumTick = 0;
+        uint32_t _numChecksumsVerified = 0;
     };
 
     std::unique_ptr<IReplayManager> CreateReplayManager()
@@ -28,10 +28,20 @@ namespace OpenRCT2
         uint64_t TimeRecorded;
         uint32_t NumCommands;
         uint32_t NumChecksums;
+        uint32_t NumKeyframes;
         std::string Name;
         std::string FilePath;
     };
 
+    struct ReplayVerifyResult
+    {
+        uint32_t StartTick;          // Replay tick the verification started from, the nearest keyframe before the range.
+        uint32_t EndTick;            // Replay tick the verification stopped at.
+        uint32_t NumChecksums;       // Number of checksums that were compared.
+        uint32_t MismatchTick;       // First replay tick with a different game state, k_MaxReplayTicks if none.
+        std::string MismatchDetails; // Sprite differences at the next keyframe after the mismatch, if there is one.
+    };
+
     interface IReplayManager
     {
     public:
@@ -45,7 +55,9 @@ namespace OpenRCT2
 
         virtual void AddGameAction(uint32_t tick, const GameAction* action) = 0;
 
-        virtual bool StartRecording(const std::string& name, uint32_t maxTicks = k_MaxReplayTicks) = 0;
+        virtual bool StartRecording(
+            const std::string& name, uint32_t maxTicks = k_MaxReplayTicks, uint32_t keyframeInterval = 0)
+            = 0;
         virtual bool StopRecording() = 0;
         virtual bool GetCurrentReplayInfo(ReplayRecordInfo & info) const = 0;
 
@@ -53,7 +65,15 @@ namespace OpenRCT2
         virtual bool IsPlaybackStateMismatching() const = 0;
         virtual bool StopPlayback() = 0;
 
-        virtual bool NormaliseReplay(const std::string& inputFile, const std::string& outputFile) = 0;
+        // Ticks are relative to the start of the replay, seeking resumes from the nearest keyframe where possible.
+        virtual bool SeekPlayback(uint32_t tick) = 0;
+        virtual bool VerifyRange(const std::string& file, uint32_t startTick, uint32_t endTick, ReplayVerifyResult& result)
+            = 0;
+
+        // A keyframe interval of 0 keeps the keyframe interval of the input.
+        virtual bool NormaliseReplay(
+            const std::string& inputFile, const std::string& outputFile, uint32_t keyframeInterval = 0)
+            = 0;
     };
 
     std::unique_ptr<IReplayManager> CreateReplayManager();
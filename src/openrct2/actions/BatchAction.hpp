@@ -0,0 +1,174 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../localisation/StringIds.h"
+#include "GameAction.h"
+
+#include <vector>
+
+/**
+ * Runs the actions of a tool operation that affects many tiles as one action, so they are validated, sent over the
+ * network and executed together in the same tick rather than as one action each.
+ */
+DEFINE_GAME_ACTION(BatchAction, GAME_COMMAND_BATCH, GameActionResult)
+{
+public:
+    static constexpr size_t MaxActions = 1024;
+
+private:
+    std::vector<GameAction::Ptr> _actions;
+    bool _invalid = false;
+
+public:
+    BatchAction()
+    {
+    }
+
+    void AddAction(GameAction::Ptr && action)
+    {
+        _actions.push_back(std::move(action));
+    }
+
+    const std::vector<GameAction::Ptr>& GetActions() const
+    {
+        return _actions;
+    }
+
+    void Serialise(DataSerialiser & stream) override
+    {
+        GameAction::Serialise(stream);
+
+        uint16_t count = (uint16_t)_actions.size();
+        stream << DS_TAG(count);
+
+        if (stream.IsLoading())
+        {
+            _actions.clear();
+            _invalid = false;
+            if (count > MaxActions)
+            {
+                _invalid = true;
+                return;
+            }
+        }
+
+        for (uint16_t i = 0; i < count; i++)
+        {
+            uint32_t type = stream.IsLoading() ? 0 : _actions[i]->GetType();
+            stream << DS_TAG(type);
+
+            if (stream.IsLoading())
+            {
+                // Nothing after an unknown action can be read
+                auto action = type != GAME_COMMAND_BATCH ? GameActions::Create(type) : nullptr;
+                if (action == nullptr)
+                {
+                    _invalid = true;
+                    return;
+                }
+                _actions.push_back(std::move(action));
+            }
+            _actions[i]->Serialise(stream);
+        }
+    }
+
+    GameActionResult::Ptr Query() const override
+    {
+        if (_invalid || _actions.empty() || _actions.size() > MaxActions)
+        {
+            return MakeResult(GA_ERROR::INVALID_PARAMETERS, STR_NONE);
+        }
+
+        // Each action is validated on its own, the invalid ones are skipped as if they had been sent one by one. The batch
+        // only fails if none of its actions are valid.
+        auto result = MakeResult();
+        GameActionResult::Ptr firstError;
+        bool anyValid = false;
+        for (const auto& action : _actions)
+        {
+            PrepareAction(*action);
+
+            // Nested actions skip the paused check done for the top level action
+            GameActionResult::Ptr actionResult;
+            if (!GameActions::CheckActionInPausedMode(action->GetActionFlags()))
+            {
+                actionResult = MakeResult(GA_ERROR::GAME_PAUSED, STR_CONSTRUCTION_NOT_POSSIBLE_WHILE_GAME_IS_PAUSED);
+            }
+            else
+            {
+                actionResult = GameActions::QueryNested(action.get());
+            }
+
+            if (actionResult->Error == GA_ERROR::OK)
+            {
+                AddActionResult(*result, *actionResult);
+                anyValid = true;
+            }
+            else if (firstError == nullptr)
+            {
+                firstError = std::move(actionResult);
+            }
+        }
+
+        if (!anyValid && firstError != nullptr)
+        {
+            return firstError;
+        }
+        return result;
+    }
+
+    GameActionResult::Ptr Execute() const override
+    {
+        // An action can still fail if an earlier action of the batch changed what it depends on, as it would have if
+        // they were run one after another.
+        auto result = MakeResult();
+        GameActionResult::Ptr firstError;
+        bool anyExecuted = false;
+        for (const auto& action : _actions)
+        {
+            PrepareAction(*action);
+            auto actionResult = GameActions::ExecuteNested(action.get());
+            if (actionResult->Error == GA_ERROR::OK)
+            {
+                AddActionResult(*result, *actionResult);
+                anyExecuted = true;
+            }
+            else if (firstError == nullptr)
+            {
+                firstError = std::move(actionResult);
+            }
+        }
+
+        if (!anyExecuted && firstError != nullptr)
+        {
+            return firstError;
+        }
+        return result;
+    }
+
+private:
+    void PrepareAction(GameAction & action) const
+    {
+        action.SetFlags(action.GetFlags() | GetFlags());
+        action.SetPlayer(GetPlayer());
+    }
+
+    static void AddActionResult(GameActionResult & result, const GameActionResult& actionResult)
+    {
+        if (result.Position.x == LOCATION_NULL)
+        {
+            result.Position = actionResult.Position;
+            result.ExpenditureType = actionResult.ExpenditureType;
+            result.ErrorTitle = actionResult.ErrorTitle;
+        }
+        result.Cost += actionResult.Cost;
+    }
+};
@@ -196,6 +196,7 @@ private:
         }
         pathElement->SetAddition(0);
         pathElement->SetIsBroken(false);
+        gFootpathNetworkVersion++;
 
         RemoveIntersectingWalls(pathElement);
         return res;
@@ -20,9 +20,12 @@
 #include "../scenario/Scenario.h"
 #include "../world/Park.h"
 #include "../world/Scenery.h"
+#include "BatchAction.hpp"
 
 #include <algorithm>
+#include <deque>
 #include <iterator>
+#include <vector>
 
 GameActionResult::GameActionResult(GA_ERROR error, rct_string_id message)
 {
@@ -59,22 +62,22 @@ namespace GameActions
             , action(std::move(ga))
         {
         }
+    };
 
-        bool operator<(const QueuedGameAction& comp) const
-        {
-            // First sort by tick
-            if (tick < comp.tick)
-                return true;
-            if (tick > comp.tick)
-                return false;
-
-            // If the ticks are equal sort by commandIndex
-            return uniqueId < comp.uniqueId;
-        }
+    // The queued actions of one tick in the order they were queued, which is also the order of their unique ids.
+    struct QueuedGameActionBucket
+    {
+        uint32_t tick = 0;
+        size_t next = 0;
+        std::vector<QueuedGameAction> actions;
     };
 
+    // Emptied action lists are kept for reuse so that queueing does not allocate once the queue has warmed up.
+    static constexpr size_t MaxPooledActionLists = 16;
+
     static GameActionFactory _actions[GAME_COMMAND_COUNT];
-    static std::multiset<QueuedGameAction> _actionQueue;
+    static std::deque<QueuedGameActionBucket> _actionQueue;
+    static std::vector<std::vector<QueuedGameAction>> _actionListPool;
     static uint32_t _nextUniqueId = 0;
     static bool _suspended = false;
 
@@ -106,6 +109,40 @@ namespace GameActions
         _suspended = false;
     }
 
+    static std::vector<QueuedGameAction>& GetQueueBucket(uint32_t tick)
+    {
+        // Actions are nearly always queued for the last tick in the queue, so search from the back.
+        auto it = _actionQueue.end();
+        while (it != _actionQueue.begin() && std::prev(it)->tick > tick)
+        {
+            it--;
+        }
+        if (it != _actionQueue.begin() && std::prev(it)->tick == tick)
+        {
+            return std::prev(it)->actions;
+        }
+
+        QueuedGameActionBucket bucket;
+        bucket.tick = tick;
+        if (!_actionListPool.empty())
+        {
+            bucket.actions = std::move(_actionListPool.back());
+            _actionListPool.pop_back();
+        }
+        return _actionQueue.insert(it, std::move(bucket))->actions;
+    }
+
+    static void PopQueueBucket()
+    {
+        auto& actions = _actionQueue.front().actions;
+        if (_actionListPool.size() < MaxPooledActionLists)
+        {
+            actions.clear();
+            _actionListPool.push_back(std::move(actions));
+        }
+        _actionQueue.pop_front();
+    }
+
     void Enqueue(const GameAction* ga, uint32_t tick)
     {
         auto action = Clone(ga);
@@ -120,7 +157,27 @@ namespace GameActions
             // as that normally happens when receiving them over network.
             ga->SetPlayer(network_get_current_player_id());
         }
-        _actionQueue.emplace(tick, std::move(ga), _nextUniqueId++);
+        GetQueueBucket(tick).emplace_back(tick, std::move(ga), _nextUniqueId++);
+    }
+
+    static bool PlacesScenery(const GameAction& action)
+    {
+        switch (action.GetType())
+        {
+            case GAME_COMMAND_PLACE_WALL:
+            case GAME_COMMAND_PLACE_LARGE_SCENERY:
+            case GAME_COMMAND_PLACE_BANNER:
+            case GAME_COMMAND_PLACE_SCENERY:
+                return true;
+            case GAME_COMMAND_BATCH:
+            {
+                const auto& actions = static_cast<const BatchAction&>(action).GetActions();
+                return std::any_of(
+                    actions.begin(), actions.end(), [](const GameAction::Ptr& nested) { return PlacesScenery(*nested); });
+            }
+            default:
+                return false;
+        }
     }
 
     void ProcessQueue()
@@ -133,13 +190,18 @@ namespace GameActions
 
         const uint32_t currentTick = gCurrentTicks;
 
-        while (_actionQueue.begin() != _actionQueue.end())
+        while (!_actionQueue.empty())
         {
-            // run all the game commands at the current tick
-            const QueuedGameAction& queued = *_actionQueue.begin();
+            auto& bucket = _actionQueue.front();
+            if (bucket.next >= bucket.actions.size())
+            {
+                PopQueueBucket();
+                continue;
+            }
 
             if (network_get_mode() == NETWORK_MODE_CLIENT)
             {
+                const QueuedGameAction& queued = bucket.actions[bucket.next];
                 if (queued.tick < currentTick)
                 {
                     // This should never happen.
@@ -156,15 +218,13 @@ namespace GameActions
                 }
             }
 
+            // run all the game commands at the current tick, take the action out first as executing it may queue more
+            QueuedGameAction queued = std::move(bucket.actions[bucket.next++]);
+
             // Remove ghost scenery so it doesn't interfere with incoming network command
-            switch (queued.action->GetType())
+            if (PlacesScenery(*queued.action))
             {
-                case GAME_COMMAND_PLACE_WALL:
-                case GAME_COMMAND_PLACE_LARGE_SCENERY:
-                case GAME_COMMAND_PLACE_BANNER:
-                case GAME_COMMAND_PLACE_SCENERY:
-                    scenery_remove_ghost_tool_placement();
-                    break;
+                scenery_remove_ghost_tool_placement();
             }
 
             GameAction* action = queued.action.get();
@@ -178,14 +238,15 @@ namespace GameActions
                 // Relay this action to all other clients.
                 network_send_game_action(action);
             }
-
-            _actionQueue.erase(_actionQueue.begin());
         }
     }
 
     void ClearQueue()
     {
-        _actionQueue.clear();
+        while (!_actionQueue.empty())
+        {
+            PopQueueBucket();
+        }
     }
 
     void Initialize()
@@ -237,7 +298,7 @@ namespace GameActions
         return ga;
     }
 
-    static bool CheckActionInPausedMode(uint32_t actionFlags)
+    bool CheckActionInPausedMode(uint32_t actionFlags)
     {
         if (gGamePaused == 0)
             return true;
@@ -276,6 +276,7 @@ namespace GameActions
     GameActionResult::Ptr Execute(const GameAction* action);
 
     // This should be used from within game actions.
+    bool CheckActionInPausedMode(uint32_t actionFlags);
     GameActionResult::Ptr QueryNested(const GameAction* action);
     GameActionResult::Ptr ExecuteNested(const GameAction* action);
 
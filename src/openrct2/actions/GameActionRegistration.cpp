@@ -13,6 +13,7 @@
 #include "BannerSetColourAction.hpp"
 #include "BannerSetNameAction.hpp"
 #include "BannerSetStyleAction.hpp"
+#include "BatchAction.hpp"
 #include "ClearAction.hpp"
 #include "ClimateSetAction.hpp"
 #include "FootpathPlaceAction.hpp"
@@ -168,6 +169,7 @@ namespace GameActions
         Register<WaterRaiseAction>();
         Register<GuestSetFlagsAction>();
         Register<ParkSetDateAction>();
+        Register<BatchAction>();
         Register<SetCheatAction>();
     }
 } // namespace GameActions
@@ -49,6 +49,10 @@ public:
 
     uint8_t GroundFlags{ 0 };
     TileElement* tileElement = nullptr;
+    // The space the scenery takes up, so placements that are not on the map yet can be checked against each other
+    uint8_t BaseHeight{ 0 };
+    uint8_t ClearanceHeight{ 0 };
+    uint8_t QuarterTileOccupied{ 0 };
 };
 
 DEFINE_GAME_ACTION(SmallSceneryPlaceAction, GAME_COMMAND_PLACE_SCENERY, SmallSceneryPlaceActionResult)
@@ -288,6 +292,9 @@ public:
         }
 
         res->GroundFlags = gMapGroundFlags & (ELEMENT_IS_ABOVE_GROUND | ELEMENT_IS_UNDERGROUND);
+        res->BaseHeight = zLow;
+        res->ClearanceHeight = zHigh;
+        res->QuarterTileOccupied = quarterTile.GetBaseQuarterOccupied();
 
         res->ExpenditureType = RCT_EXPENDITURE_TYPE_LANDSCAPING;
         res->Cost = (sceneryEntry->small_scenery.price * 10) + clearCost;
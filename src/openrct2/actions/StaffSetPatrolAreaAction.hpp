@@ -69,22 +69,10 @@ public:
             return MakeResult(GA_ERROR::INVALID_PARAMETERS, STR_NONE);
         }
 
-        int32_t patrolOffset = peep->staff_id * STAFF_PATROL_AREA_SIZE;
-
         staff_toggle_patrol_area(peep->staff_id, _loc.x, _loc.y);
 
-        bool isPatrolling = false;
-        for (int32_t i = 0; i < 128; i++)
-        {
-            if (gStaffPatrolAreas[patrolOffset + i])
-            {
-                isPatrolling = true;
-                break;
-            }
-        }
-
         gStaffModes[peep->staff_id] &= ~(1 << 1);
-        if (isPatrolling)
+        if (staff_has_patrol_area(peep->staff_id))
         {
             gStaffModes[peep->staff_id] |= (1 << 1);
         }
@@ -96,7 +84,7 @@ public:
                 map_invalidate_tile_full((_loc.x & 0x1F80) + x, (_loc.y & 0x1F80) + y);
             }
         }
-        staff_update_greyed_patrol_areas();
+        staff_update_greyed_patrol_area(peep->staff_type, _loc.x, _loc.y);
 
         return MakeResult();
     }
@@ -0,0 +1,160 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../OpenRCT2.h"
+#    include "../localisation/Localisation.h"
+#    include "../platform/platform.h"
+
+#    include <benchmark/benchmark.h>
+#    include <memory>
+#    include <string>
+#    include <vector>
+
+struct StringFormatBenchmark
+{
+    const char* Name;
+    rct_string_id Format;
+    std::vector<uint8_t> Args;
+};
+
+static std::vector<StringFormatBenchmark> get_string_format_benchmarks()
+{
+    std::vector<StringFormatBenchmark> benchmarks;
+
+    std::vector<uint8_t> args(16);
+    benchmarks.push_back({ "text", STR_RIDE_LIST_TOTAL_PROFIT, args });
+
+    set_format_arg_on(args.data(), 0, uint16_t, 1234);
+    benchmarks.push_back({ "comma16", STR_GUESTS_IN_PARK_LABEL, args });
+
+    set_format_arg_on(args.data(), 0, int32_t, 1234567);
+    benchmarks.push_back({ "int32", STR_GUEST_X, args });
+    benchmarks.push_back({ "currency", STR_CURRENCY_FORMAT_LABEL, args });
+
+    set_format_arg_on(args.data(), 0, rct_string_id, STR_GUEST_X);
+    set_format_arg_on(args.data(), 2, int32_t, 1234567);
+    benchmarks.push_back({ "nested", STR_BLACK_STRING, args });
+
+    set_format_arg_on(args.data(), 0, rct_string_id, STR_RIDE_LIST_INCOME);
+    set_format_arg_on(args.data(), 2, rct_string_id, STR_GUEST_X);
+    set_format_arg_on(args.data(), 4, int32_t, 1234567);
+    set_format_arg_on(args.data(), 8, uint16_t, 42);
+    benchmarks.push_back({ "tooltip", STR_MAP_TOOLTIP_STRINGID_STRINGID, args });
+    return benchmarks;
+}
+
+static void BM_format_string(benchmark::State& state, rct_string_id format, std::vector<uint8_t> args)
+{
+    char buffer[256];
+    for (auto _ : state)
+    {
+        format_string(buffer, sizeof(buffer), format, args.data());
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// The raw string is decoded every time, as language strings were before they were compiled
+static void BM_format_string_raw(benchmark::State& state, rct_string_id format, std::vector<uint8_t> args)
+{
+    char buffer[256];
+    const utf8* rawString = language_get_string(format);
+    for (auto _ : state)
+    {
+        format_string_raw(buffer, sizeof(buffer), rawString, args.data());
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_format_string_std(benchmark::State& state, rct_string_id format, std::vector<uint8_t> args)
+{
+    for (auto _ : state)
+    {
+        auto result = format_string(format, args.data());
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static int32_t cmdline_for_bench_string_format(int32_t argc, const char** argv)
+{
+    core_init();
+    gOpenRCT2Headless = true;
+    auto context = OpenRCT2::CreateContext();
+    if (!context->Initialise())
+    {
+        log_error("Failed to initialise the game.");
+        return -1;
+    }
+
+    for (const auto& bm : get_string_format_benchmarks())
+    {
+        std::string name = bm.Name;
+        benchmark::RegisterBenchmark(("format_string/" + name).c_str(), BM_format_string, bm.Format, bm.Args);
+        benchmark::RegisterBenchmark(("format_string_raw/" + name).c_str(), BM_format_string_raw, bm.Format, bm.Args);
+        benchmark::RegisterBenchmark(("format_string_std/" + name).c_str(), BM_format_string_std, bm.Format, bm.Args);
+    }
+
+    // Google benchmark reorders the pointers of argv, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+    for (int32_t i = 0; i < argc; i++)
+    {
+        argv_for_benchmark.push_back((char*)argv[i]);
+    }
+    argc = (int32_t)argv_for_benchmark.size();
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchStringFormat(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = (const char**)argEnumerator->GetArguments() + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_string_format(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchStringFormat(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchStringFormatCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchStringFormat),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchStringFormat), CommandTableEnd
+#endif // USE_BENCHMARK
+};
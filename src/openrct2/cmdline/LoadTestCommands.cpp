@@ -0,0 +1,437 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../core/Console.hpp"
+#include "CommandLine.hpp"
+
+#ifndef DISABLE_NETWORK
+
+#    include "../Context.h"
+#    include "../Game.h"
+#    include "../GameState.h"
+#    include "../OpenRCT2.h"
+#    include "../actions/FootpathPlaceAction.hpp"
+#    include "../actions/RideSetPriceAction.hpp"
+#    include "../config/Config.h"
+#    include "../network/NetworkConnection.h"
+#    include "../network/NetworkKey.h"
+#    include "../network/NetworkPacket.h"
+#    include "../network/network.h"
+#    include "../platform/platform.h"
+#    include "../ride/Ride.h"
+#    include "../world/Footpath.h"
+#    include "../world/Map.h"
+
+#    include <algorithm>
+#    include <chrono>
+#    include <cstdlib>
+#    include <memory>
+#    include <string>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+constexpr uint16_t LOADTEST_DEFAULT_PORT = 11754;
+constexpr uint32_t LOADTEST_DEFAULT_ACTION_INTERVAL = 40;
+
+/**
+ * The actions the synthetic clients repeatedly send. Both are picked from the loaded park so that the server runs
+ * them for real rather than rejecting them up front.
+ */
+struct LoadTestTargets
+{
+    ride_id_t RideIndex = RIDE_ID_NULL;
+    money16 RidePrice = 0;
+    bool HasPath = false;
+    CoordsXYZ PathLoc;
+    uint8_t PathSlope = 0;
+    uint8_t PathType = 0;
+};
+
+/**
+ * A client that speaks the multiplayer protocol directly on a NetworkConnection without running a game of its own.
+ */
+class LoadTestClient final
+{
+private:
+    enum class State
+    {
+        Connecting,
+        Joining,
+        Playing,
+        Disconnected,
+    };
+
+    NetworkConnection _connection;
+    NetworkKey _key;
+    std::string _name;
+    State _state = State::Connecting;
+    std::chrono::high_resolution_clock::time_point _connectTime;
+    uint32_t _lastServerTick = 0;
+    uint32_t _nextActionTick = 0;
+    uint32_t _actionIndex = 0;
+
+public:
+    double JoinTime = 0;
+    uint32_t ActionsSent = 0;
+    uint32_t ErrorsReceived = 0;
+    uint32_t TickGaps = 0;
+
+    explicit LoadTestClient(const std::string& name)
+        : _name(name)
+    {
+    }
+
+    bool Connect(uint16_t port)
+    {
+        if (!_key.Generate())
+        {
+            Console::Error::WriteLine("%s: unable to generate key.", _name.c_str());
+            return false;
+        }
+        try
+        {
+            _connection.Socket = CreateTcpSocket();
+            _connection.Socket->Connect("127.0.0.1", port);
+        }
+        catch (const std::exception& e)
+        {
+            Console::Error::WriteLine("%s: %s", _name.c_str(), e.what());
+            _state = State::Disconnected;
+            return false;
+        }
+        _connectTime = std::chrono::high_resolution_clock::now();
+        _connection.AuthStatus = NETWORK_AUTH_REQUESTED;
+
+        std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
+        *packet << (uint32_t)NETWORK_COMMAND_TOKEN;
+        _connection.QueuePacket(std::move(packet));
+        return true;
+    }
+
+    bool IsDisconnected() const
+    {
+        return _state == State::Disconnected;
+    }
+
+    void Update(const LoadTestTargets& targets, uint32_t actionInterval)
+    {
+        if (_state == State::Disconnected)
+        {
+            return;
+        }
+
+        int32_t status;
+        do
+        {
+            status = _connection.ReadPacket();
+            if (status == NETWORK_READPACKET_SUCCESS)
+            {
+                HandlePacket(_connection.InboundPacket);
+                _connection.InboundPacket.Clear();
+            }
+            else if (status == NETWORK_READPACKET_DISCONNECTED)
+            {
+                _state = State::Disconnected;
+                return;
+            }
+        } while (status == NETWORK_READPACKET_SUCCESS || status == NETWORK_READPACKET_MORE_DATA);
+
+        if (_state == State::Playing && actionInterval != 0 && _lastServerTick >= _nextActionTick)
+        {
+            SendAction(targets);
+            _nextActionTick = _lastServerTick + actionInterval;
+        }
+        _connection.SendQueuedPackets();
+    }
+
+private:
+    void HandlePacket(NetworkPacket& packet)
+    {
+        uint32_t command;
+        packet >> command;
+        switch (command)
+        {
+            case NETWORK_COMMAND_TOKEN:
+                HandleToken(packet);
+                break;
+            case NETWORK_COMMAND_AUTH:
+            {
+                uint32_t authStatus;
+                packet >> authStatus;
+                _connection.AuthStatus = (NETWORK_AUTH)authStatus;
+                if (authStatus != NETWORK_AUTH_OK)
+                {
+                    Console::Error::WriteLine("%s: authentication failed (%u).", _name.c_str(), authStatus);
+                    _state = State::Disconnected;
+                }
+                break;
+            }
+            case NETWORK_COMMAND_OBJECTS:
+            {
+                // Claim to have every object, only the map itself is then downloaded
+                std::unique_ptr<NetworkPacket> reply(NetworkPacket::Allocate());
+                *reply << (uint32_t)NETWORK_COMMAND_OBJECTS << (uint32_t)0;
+                _connection.QueuePacket(std::move(reply));
+                _state = State::Joining;
+                break;
+            }
+            case NETWORK_COMMAND_MAP:
+            {
+                uint32_t size, offset;
+                packet >> size >> offset;
+                size_t chunkSize = packet.Size - packet.BytesRead;
+                if (_state == State::Joining && offset + chunkSize >= size)
+                {
+                    auto elapsed = std::chrono::high_resolution_clock::now() - _connectTime;
+                    JoinTime = std::chrono::duration<double, std::milli>(elapsed).count();
+                    _state = State::Playing;
+                }
+                break;
+            }
+            case NETWORK_COMMAND_FRAME:
+            {
+                uint32_t tick;
+                if (!packet.ReadVarInt(tick))
+                {
+                    break;
+                }
+                if (_lastServerTick != 0 && tick != _lastServerTick + 1)
+                {
+                    TickGaps++;
+                }
+                _lastServerTick = tick;
+                break;
+            }
+            case NETWORK_COMMAND_PING:
+            {
+                std::unique_ptr<NetworkPacket> reply(NetworkPacket::Allocate());
+                *reply << (uint32_t)NETWORK_COMMAND_PING;
+                _connection.QueuePacket(std::move(reply));
+                break;
+            }
+            case NETWORK_COMMAND_SHOWERROR:
+                ErrorsReceived++;
+                break;
+        }
+    }
+
+    void HandleToken(NetworkPacket& packet)
+    {
+        uint32_t challengeSize;
+        packet >> challengeSize;
+        const uint8_t* challenge = packet.Read(challengeSize);
+        std::vector<uint8_t> signature;
+        if (challenge == nullptr || !_key.Sign(challenge, challengeSize, signature))
+        {
+            Console::Error::WriteLine("%s: unable to sign the server challenge.", _name.c_str());
+            _state = State::Disconnected;
+            return;
+        }
+
+        std::unique_ptr<NetworkPacket> reply(NetworkPacket::Allocate());
+        *reply << (uint32_t)NETWORK_COMMAND_AUTH;
+        reply->WriteString(network_get_version().c_str());
+        reply->WriteString(_name.c_str());
+        reply->WriteString("");
+        reply->WriteString(_key.PublicKeyString().c_str());
+        *reply << (uint32_t)signature.size();
+        reply->Write(signature.data(), signature.size());
+        _connection.QueuePacket(std::move(reply));
+    }
+
+    void SendAction(const LoadTestTargets& targets)
+    {
+        std::unique_ptr<GameAction> action;
+        if ((_actionIndex++ & 1) == 0 && targets.RideIndex != RIDE_ID_NULL)
+        {
+            action = std::make_unique<RideSetPriceAction>(targets.RideIndex, targets.RidePrice, true);
+        }
+        else if (targets.HasPath)
+        {
+            action = std::make_unique<FootpathPlaceAction>(targets.PathLoc, targets.PathSlope, targets.PathType);
+        }
+        if (action == nullptr)
+        {
+            return;
+        }
+
+        DataSerialiser stream(true);
+        action->Serialise(stream);
+
+        std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
+        *packet << (uint32_t)NETWORK_COMMAND_GAME_ACTION << _lastServerTick << action->GetType() << stream;
+        _connection.QueuePacket(std::move(packet));
+        ActionsSent++;
+    }
+};
+
+static LoadTestTargets GetLoadTestTargets()
+{
+    LoadTestTargets targets;
+    for (auto& ride : GetRideManager())
+    {
+        targets.RideIndex = ride.id;
+        targets.RidePrice = ride.price;
+        break;
+    }
+
+    tile_element_iterator it;
+    tile_element_iterator_begin(&it);
+    while (tile_element_iterator_next(&it))
+    {
+        if (it.element->GetType() == TILE_ELEMENT_TYPE_PATH && !it.element->AsPath()->IsQueue())
+        {
+            auto pathElement = it.element->AsPath();
+            targets.HasPath = true;
+            targets.PathLoc = { it.x * 32, it.y * 32, pathElement->base_height * 8 };
+            targets.PathSlope = pathElement->IsSloped()
+                ? FOOTPATH_PROPERTIES_FLAG_IS_SLOPED | pathElement->GetSlopeDirection()
+                : 0;
+            targets.PathType = pathElement->GetPathEntryIndex();
+            break;
+        }
+    }
+    return targets;
+}
+
+static double GetPercentile(const std::vector<double>& sortedValues, double percentile)
+{
+    if (sortedValues.empty())
+    {
+        return 0;
+    }
+    size_t index = (size_t)(percentile / 100.0 * (sortedValues.size() - 1) + 0.5);
+    return sortedValues[std::min(index, sortedValues.size() - 1)];
+}
+
+static exitcode_t HandleLoadTest(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = (const char**)argEnumerator->GetArguments() + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 3)
+    {
+        Console::Error::WriteLine("Missing arguments <sv6-file> <clients> <ticks> [action-interval] [port].");
+        return EXITCODE_FAIL;
+    }
+
+    core_init();
+
+    const char* inputPath = argv[0];
+    int32_t numClients = std::max(atoi(argv[1]), 1);
+    uint32_t ticks = atol(argv[2]);
+    uint32_t actionInterval = argc >= 4 ? atol(argv[3]) : LOADTEST_DEFAULT_ACTION_INTERVAL;
+    uint16_t port = argc >= 5 ? (uint16_t)atoi(argv[4]) : LOADTEST_DEFAULT_PORT;
+
+    gOpenRCT2Headless = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+    if (!context->LoadParkFromFile(inputPath))
+    {
+        return EXITCODE_FAIL;
+    }
+
+    // Keep the server to the loopback interface and off the master server list
+    gConfigNetwork.advertise = false;
+    gConfigNetwork.known_keys_only = false;
+    gConfigNetwork.maxplayers = std::max(gConfigNetwork.maxplayers, numClients + 1);
+    network_set_password("");
+    if (!network_begin_server(port, "127.0.0.1"))
+    {
+        Console::Error::WriteLine("Unable to start server on port %u.", port);
+        return EXITCODE_FAIL;
+    }
+
+    auto targets = GetLoadTestTargets();
+    std::vector<std::unique_ptr<LoadTestClient>> clients;
+    for (int32_t i = 0; i < numClients; i++)
+    {
+        auto client = std::make_unique<LoadTestClient>("loadtest-" + std::to_string(i + 1));
+        client->Connect(port);
+        clients.push_back(std::move(client));
+    }
+
+    Console::WriteLine("Running %u ticks with %d clients...", ticks, numClients);
+    std::vector<double> tickTimes;
+    tickTimes.reserve(ticks);
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        for (auto& client : clients)
+        {
+            client->Update(targets, actionInterval);
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        context->GetGameState()->UpdateLogic();
+        auto elapsed = std::chrono::high_resolution_clock::now() - startTime;
+        tickTimes.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+    }
+
+    // Report
+    std::sort(tickTimes.begin(), tickTimes.end());
+    Console::WriteLine(
+        "Server tick time (ms): p50 %.3f, p90 %.3f, p99 %.3f, max %.3f", GetPercentile(tickTimes, 50),
+        GetPercentile(tickTimes, 90), GetPercentile(tickTimes, 99), tickTimes.empty() ? 0.0 : tickTimes.back());
+
+    auto stats = network_get_stats();
+    Console::WriteLine(
+        "Bytes per client: %.0f sent, %.0f received",
+        (double)stats.bytesSent[NETWORK_STATISTICS_GROUP_TOTAL] / numClients,
+        (double)stats.bytesReceived[NETWORK_STATISTICS_GROUP_TOTAL] / numClients);
+
+    int32_t numJoined = 0;
+    int32_t numDisconnected = 0;
+    double totalJoinTime = 0;
+    double maxJoinTime = 0;
+    uint32_t actionsSent = 0;
+    uint32_t errorsReceived = 0;
+    uint32_t tickGaps = 0;
+    for (const auto& client : clients)
+    {
+        if (client->JoinTime > 0)
+        {
+            numJoined++;
+            totalJoinTime += client->JoinTime;
+            maxJoinTime = std::max(maxJoinTime, client->JoinTime);
+        }
+        if (client->IsDisconnected())
+        {
+            numDisconnected++;
+        }
+        actionsSent += client->ActionsSent;
+        errorsReceived += client->ErrorsReceived;
+        tickGaps += client->TickGaps;
+    }
+    Console::WriteLine(
+        "Map join time (ms): mean %.1f, max %.1f (%d of %d clients joined)", numJoined > 0 ? totalJoinTime / numJoined : 0.0,
+        maxJoinTime, numJoined, numClients);
+    Console::WriteLine("Game actions sent: %u, errors: %u", actionsSent, errorsReceived);
+    Console::WriteLine("Desync indicators: %d disconnected clients, %u tick stream gaps", numDisconnected, tickGaps);
+
+    network_close();
+    return numDisconnected == 0 ? EXITCODE_OK : EXITCODE_FAIL;
+}
+
+#else
+static exitcode_t HandleLoadTest([[maybe_unused]] CommandLineArgEnumerator* argEnumerator)
+{
+    Console::Error::WriteLine("Sorry, network support is not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // DISABLE_NETWORK
+
+const CommandLineCommand CommandLine::LoadTestCommands[]{
+    DefineCommand("", "<sv6-file> <clients> <ticks> [action-interval] [port]", nullptr, HandleLoadTest), CommandTableEnd
+};
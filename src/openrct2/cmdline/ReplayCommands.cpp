@@ -0,0 +1,495 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../Context.h"
+#include "../OpenRCT2.h"
+#include "../ReplayManager.h"
+#include "../core/Console.hpp"
+#include "../core/File.h"
+#include "../core/FileScanner.h"
+#include "../core/JobPool.hpp"
+#include "../core/Json.hpp"
+#include "../core/Memory.hpp"
+#include "../core/Path.hpp"
+#include "../core/String.hpp"
+#include "../object/ObjectManager.h"
+#include "../platform/Platform2.h"
+#include "../platform/platform.h"
+#include "../rct2/S6Exporter.h"
+#include "CommandLine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+struct ReplayVerifyReport
+{
+    std::string Name;
+    std::string FilePath;
+    bool Passed = false;
+    std::string Error;
+    uint32_t Ticks = 0;
+    double Seconds = 0;
+    uint32_t NumChecksums = 0;
+    uint32_t MismatchTick = k_MaxReplayTicks;
+    std::string MismatchDetails;
+};
+
+static int32_t _jobs = 0;
+static utf8* _jsonReportPath = nullptr;
+static utf8* _junitReportPath = nullptr;
+
+static exitcode_t HandleReplaySeek(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleReplayVerify(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleReplayVerifyRange(CommandLineArgEnumerator* argEnumerator);
+
+// clang-format off
+static constexpr const CommandLineOptionDefinition ReplayVerifyOptions[]
+{
+    { CMDLINE_TYPE_INTEGER, &_jobs,            'j', "jobs",  "number of replays to verify at once (default: number of cores)" },
+    { CMDLINE_TYPE_STRING,  &_jsonReportPath,  NAC, "json",  "path to write a JSON report to"                                 },
+    { CMDLINE_TYPE_STRING,  &_junitReportPath, NAC, "junit", "path to write a JUnit XML report to"                            },
+    OptionTableEnd
+};
+
+const CommandLineCommand CommandLine::ReplayCommands[]
+{
+    // Main commands
+    DefineCommand("seek",         "<replay-file> <tick> <output-sv6>",        nullptr,             HandleReplaySeek       ),
+    DefineCommand("verify",       "<replay-file|directory>",                  ReplayVerifyOptions, HandleReplayVerify     ),
+    DefineCommand("verify-range", "<replay-file> <start-tick> <end-tick>",    nullptr,             HandleReplayVerifyRange),
+    CommandTableEnd
+};
+// clang-format on
+
+static std::unique_ptr<IContext> CreateReplayContext()
+{
+    core_init();
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return nullptr;
+    }
+    return context;
+}
+
+static exitcode_t HandleReplaySeek(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = (const char**)argEnumerator->GetArguments() + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 3)
+    {
+        Console::Error::WriteLine("Missing arguments <replay-file> <tick> <output-sv6>.");
+        return EXITCODE_FAIL;
+    }
+
+    const char* replayPath = argv[0];
+    uint32_t tick = atol(argv[1]);
+    const char* outputPath = argv[2];
+
+    auto context = CreateReplayContext();
+    if (context == nullptr)
+    {
+        return EXITCODE_FAIL;
+    }
+
+    auto* replayManager = context->GetReplayManager();
+    if (!replayManager->StartPlayback(replayPath))
+    {
+        Console::Error::WriteLine("Unable to start replay '%s'.", replayPath);
+        return EXITCODE_FAIL;
+    }
+
+    if (!replayManager->SeekPlayback(tick))
+    {
+        Console::Error::WriteLine("Unable to seek to tick %u.", tick);
+        return EXITCODE_FAIL;
+    }
+
+    try
+    {
+        auto exporter = std::make_unique<S6Exporter>();
+        exporter->ExportObjectsList = context->GetObjectManager().GetPackableObjects();
+        exporter->Export();
+        exporter->SaveGame(outputPath);
+    }
+    catch (const std::exception& e)
+    {
+        Console::Error::WriteLine("Unable to save park: %s", e.what());
+        return EXITCODE_FAIL;
+    }
+
+    Console::WriteLine("Saved tick %u of '%s' to '%s'.", tick, replayPath, outputPath);
+    return EXITCODE_OK;
+}
+
+static exitcode_t HandleReplayVerifyRange(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = (const char**)argEnumerator->GetArguments() + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 3)
+    {
+        Console::Error::WriteLine("Missing arguments <replay-file> <start-tick> <end-tick>.");
+        return EXITCODE_FAIL;
+    }
+
+    const char* replayPath = argv[0];
+    uint32_t startTick = atol(argv[1]);
+    uint32_t endTick = atol(argv[2]);
+
+    auto context = CreateReplayContext();
+    if (context == nullptr)
+    {
+        return EXITCODE_FAIL;
+    }
+
+    ReplayVerifyResult result;
+    if (!context->GetReplayManager()->VerifyRange(replayPath, startTick, endTick, result))
+    {
+        Console::Error::WriteLine("Unable to verify replay '%s'.", replayPath);
+        return EXITCODE_FAIL;
+    }
+
+    if (result.MismatchTick != k_MaxReplayTicks)
+    {
+        Console::WriteLine(
+            "Mismatch at tick %u, verified %u checksums from tick %u.", result.MismatchTick, result.NumChecksums,
+            result.StartTick);
+        return EXITCODE_FAIL;
+    }
+
+    Console::WriteLine(
+        "Ticks %u to %u match, verified %u checksums.", result.StartTick, result.EndTick, result.NumChecksums);
+    return EXITCODE_OK;
+}
+
+static ReplayVerifyReport VerifyReplayFile(const std::string& path)
+{
+    ReplayVerifyReport report;
+    report.Name = Path::GetFileNameWithoutExtension(path);
+    report.FilePath = path;
+
+    auto context = CreateReplayContext();
+    if (context == nullptr)
+    {
+        report.Error = "Context initialization failed.";
+        return report;
+    }
+
+    ReplayVerifyResult result;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (!context->GetReplayManager()->VerifyRange(path, 0, k_MaxReplayTicks, result))
+    {
+        report.Error = "Unable to load replay.";
+        return report;
+    }
+    std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - startTime;
+
+    report.Passed = result.MismatchTick == k_MaxReplayTicks;
+    report.Ticks = result.EndTick - result.StartTick;
+    report.Seconds = duration.count();
+    report.NumChecksums = result.NumChecksums;
+    report.MismatchTick = result.MismatchTick;
+    report.MismatchDetails = result.MismatchDetails;
+    return report;
+}
+
+static std::string GetTempDirectory()
+{
+    for (const char* name : { "TMPDIR", "TEMP", "TMP" })
+    {
+        auto path = Platform::GetEnvironmentVariable(name);
+        if (!path.empty())
+            return path;
+    }
+#ifdef _WIN32
+    return ".";
+#else
+    return "/tmp";
+#endif
+}
+
+static json_t* ReportToJson(const ReplayVerifyReport& report)
+{
+    json_t* jsonReport = json_object();
+    json_object_set_new(jsonReport, "name", json_string(report.Name.c_str()));
+    json_object_set_new(jsonReport, "file", json_string(report.FilePath.c_str()));
+    json_object_set_new(jsonReport, "passed", json_boolean(report.Passed));
+    json_object_set_new(jsonReport, "ticks", json_integer(report.Ticks));
+    json_object_set_new(jsonReport, "seconds", json_real(report.Seconds));
+    json_object_set_new(jsonReport, "ticksPerSecond", json_real(report.Seconds > 0 ? report.Ticks / report.Seconds : 0));
+    json_object_set_new(jsonReport, "checksums", json_integer(report.NumChecksums));
+    if (!report.Error.empty())
+    {
+        json_object_set_new(jsonReport, "error", json_string(report.Error.c_str()));
+    }
+    if (report.MismatchTick != k_MaxReplayTicks)
+    {
+        json_object_set_new(jsonReport, "firstMismatchTick", json_integer(report.MismatchTick));
+        json_object_set_new(jsonReport, "spriteDiff", json_string(report.MismatchDetails.c_str()));
+    }
+    return jsonReport;
+}
+
+static ReplayVerifyReport ReportFromJson(const json_t* jsonReport)
+{
+    auto getString = [jsonReport](const char* name) {
+        auto value = json_string_value(json_object_get(jsonReport, name));
+        return std::string(value != nullptr ? value : "");
+    };
+
+    ReplayVerifyReport report;
+    report.Name = getString("name");
+    report.FilePath = getString("file");
+    report.Passed = json_is_true(json_object_get(jsonReport, "passed"));
+    report.Error = getString("error");
+    report.Ticks = (uint32_t)json_integer_value(json_object_get(jsonReport, "ticks"));
+    report.Seconds = json_number_value(json_object_get(jsonReport, "seconds"));
+    report.NumChecksums = (uint32_t)json_integer_value(json_object_get(jsonReport, "checksums"));
+    auto mismatchTick = json_object_get(jsonReport, "firstMismatchTick");
+    if (mismatchTick != nullptr)
+    {
+        report.MismatchTick = (uint32_t)json_integer_value(mismatchTick);
+        report.MismatchDetails = getString("spriteDiff");
+    }
+    return report;
+}
+
+static void WriteJsonReport(const std::string& path, const std::vector<ReplayVerifyReport>& reports)
+{
+    size_t numFailed = 0;
+    json_t* jsonReplays = json_array();
+    for (const auto& report : reports)
+    {
+        if (!report.Passed)
+            numFailed++;
+        json_array_append_new(jsonReplays, ReportToJson(report));
+    }
+
+    json_t* jsonRoot = json_object();
+    json_object_set_new(jsonRoot, "total", json_integer(reports.size()));
+    json_object_set_new(jsonRoot, "passed", json_integer(reports.size() - numFailed));
+    json_object_set_new(jsonRoot, "failed", json_integer(numFailed));
+    json_object_set_new(jsonRoot, "replays", jsonReplays);
+    Json::WriteToFile(path.c_str(), jsonRoot, JSON_INDENT(4) | JSON_PRESERVE_ORDER);
+    json_decref(jsonRoot);
+}
+
+static std::string EscapeXml(const std::string& text)
+{
+    std::string res;
+    for (char c : text)
+    {
+        switch (c)
+        {
+            case '<':
+                res += "&lt;";
+                break;
+            case '>':
+                res += "&gt;";
+                break;
+            case '&':
+                res += "&amp;";
+                break;
+            case '"':
+                res += "&quot;";
+                break;
+            default:
+                res += c;
+                break;
+        }
+    }
+    return res;
+}
+
+static void WriteJUnitReport(const std::string& path, const std::vector<ReplayVerifyReport>& reports)
+{
+    size_t numFailures = 0;
+    size_t numErrors = 0;
+    double totalSeconds = 0;
+    std::string testCases;
+    for (const auto& report : reports)
+    {
+        totalSeconds += report.Seconds;
+        testCases += String::StdFormat(
+            "    <testcase classname=\"replay\" name=\"%s\" file=\"%s\" time=\"%.3f\">\n",
+            EscapeXml(report.Name).c_str(), EscapeXml(report.FilePath).c_str(), report.Seconds);
+        if (!report.Error.empty())
+        {
+            numErrors++;
+            testCases += String::StdFormat("      <error message=\"%s\"/>\n", EscapeXml(report.Error).c_str());
+        }
+        else if (!report.Passed)
+        {
+            numFailures++;
+            testCases += String::StdFormat(
+                "      <failure message=\"Game state mismatch at tick %u\">%s</failure>\n", report.MismatchTick,
+                EscapeXml(report.MismatchDetails).c_str());
+        }
+        testCases += String::StdFormat(
+            "      <system-out>%u ticks, %.0f ticks/s, %u checksums</system-out>\n", report.Ticks,
+            report.Seconds > 0 ? report.Ticks / report.Seconds : 0, report.NumChecksums);
+        testCases += "    </testcase>\n";
+    }
+
+    FILE* fp = fopen(path.c_str(), "wt");
+    if (fp == nullptr)
+    {
+        Console::Error::WriteLine("Unable to write JUnit report to '%s'.", path.c_str());
+        return;
+    }
+    fputs("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n", fp);
+    fprintf(
+        fp, "  <testsuite name=\"replays\" tests=\"%u\" failures=\"%u\" errors=\"%u\" time=\"%.3f\">\n",
+        (uint32_t)reports.size(), (uint32_t)numFailures, (uint32_t)numErrors, totalSeconds);
+    fputs(testCases.c_str(), fp);
+    fputs("  </testsuite>\n</testsuites>\n", fp);
+    fclose(fp);
+}
+
+/**
+ * Verifies a replay in a separate process, so replays do not share any global game state and a crash only fails the
+ * replay that caused it.
+ */
+static ReplayVerifyReport VerifyReplayInWorker(const std::string& path, size_t index)
+{
+    auto resultPath = Path::Combine(
+        GetTempDirectory(), String::StdFormat("openrct2-replay-%u-%u.json", Platform::GetTicks(), (uint32_t)index));
+
+    int32_t exitCode = Platform::RunProcess(
+        Platform::GetCurrentExecutablePath(), { "replay", "verify", path, "--json=" + resultPath });
+
+    ReplayVerifyReport report;
+    try
+    {
+        json_t* jsonRoot = Json::ReadFromFile(resultPath.c_str());
+        json_t* jsonReplay = json_array_get(json_object_get(jsonRoot, "replays"), 0);
+        if (jsonReplay != nullptr)
+        {
+            report = ReportFromJson(jsonReplay);
+        }
+        json_decref(jsonRoot);
+        File::Delete(resultPath);
+    }
+    catch (const std::exception&)
+    {
+    }
+
+    if (report.FilePath.empty())
+    {
+        report.Name = Path::GetFileNameWithoutExtension(path);
+        report.FilePath = path;
+        report.Error = String::StdFormat("Worker exited with code %d without a result.", exitCode);
+    }
+    return report;
+}
+
+static exitcode_t HandleReplayVerify(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = (const char**)argEnumerator->GetArguments() + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    std::string jsonReportPath = _jsonReportPath != nullptr ? _jsonReportPath : "";
+    std::string junitReportPath = _junitReportPath != nullptr ? _junitReportPath : "";
+    Memory::Free(_jsonReportPath);
+    Memory::Free(_junitReportPath);
+
+    if (argc < 1 || argv[0][0] == '-')
+    {
+        Console::Error::WriteLine("Missing argument <replay-file|directory>.");
+        return EXITCODE_FAIL;
+    }
+
+    std::string path = argv[0];
+    std::vector<ReplayVerifyReport> reports;
+    if (Path::DirectoryExists(path))
+    {
+        std::vector<std::string> files;
+        auto scanner = std::unique_ptr<IFileScanner>(Path::ScanDirectory(Path::Combine(path, "*.sv6r"), true));
+        while (scanner->Next())
+        {
+            files.push_back(scanner->GetPath());
+        }
+        std::sort(files.begin(), files.end());
+
+        reports.resize(files.size());
+        size_t numCompleted = 0;
+
+        JobPool jobPool(_jobs > 0 ? (size_t)_jobs : 255);
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            jobPool.AddTask(
+                [&reports, &files, i]() { reports[i] = VerifyReplayInWorker(files[i], i); },
+                [&reports, &numCompleted, &files, i]() {
+                    const auto& report = reports[i];
+                    numCompleted++;
+                    Console::WriteLine(
+                        "[%u/%u] %s: %s", (uint32_t)numCompleted, (uint32_t)files.size(), report.Passed ? "PASS" : "FAIL",
+                        report.FilePath.c_str());
+                });
+        }
+        jobPool.Join();
+    }
+    else
+    {
+        auto report = VerifyReplayFile(path);
+        if (!report.Error.empty())
+        {
+            Console::Error::WriteLine("%s: %s", path.c_str(), report.Error.c_str());
+        }
+        else if (!report.Passed)
+        {
+            Console::WriteLine("%s: mismatch at tick %u", path.c_str(), report.MismatchTick);
+            if (!report.MismatchDetails.empty())
+            {
+                Console::WriteLine("%s", report.MismatchDetails.c_str());
+            }
+        }
+        else
+        {
+            Console::WriteLine(
+                "%s: %u ticks, %.0f ticks/s", path.c_str(), report.Ticks,
+                report.Seconds > 0 ? report.Ticks / report.Seconds : 0);
+        }
+        reports.push_back(report);
+    }
+
+    try
+    {
+        if (!jsonReportPath.empty())
+        {
+            WriteJsonReport(jsonReportPath, reports);
+        }
+        if (!junitReportPath.empty())
+        {
+            WriteJUnitReport(junitReportPath, reports);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        Console::Error::WriteLine("Unable to write report: %s", e.what());
+        return EXITCODE_FAIL;
+    }
+
+    bool passed = std::all_of(reports.begin(), reports.end(), [](const ReplayVerifyReport& r) { return r.Passed; });
+    return passed ? EXITCODE_OK : EXITCODE_FAIL;
+}
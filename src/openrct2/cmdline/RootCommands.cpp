@@ -136,11 +136,14 @@ const CommandLineCommand CommandLine::RootCommands[]
 #endif
 
     // Sub-commands
-    DefineSubCommand("screenshot",      CommandLine::ScreenshotCommands       ),
-    DefineSubCommand("sprite",          CommandLine::SpriteCommands           ),
-    DefineSubCommand("benchgfx",        CommandLine::BenchGfxCommands         ),
-    DefineSubCommand("benchspritesort", CommandLine::BenchSpriteSortCommands  ),
-    DefineSubCommand("simulate",        CommandLine::SimulateCommands         ),
+    DefineSubCommand("screenshot",        CommandLine::ScreenshotCommands        ),
+    DefineSubCommand("sprite",            CommandLine::SpriteCommands            ),
+    DefineSubCommand("benchgfx",          CommandLine::BenchGfxCommands          ),
+    DefineSubCommand("benchspritesort",   CommandLine::BenchSpriteSortCommands   ),
+    DefineSubCommand("benchstringformat", CommandLine::BenchStringFormatCommands ),
+    DefineSubCommand("simulate",          CommandLine::SimulateCommands          ),
+    DefineSubCommand("loadtest",          CommandLine::LoadTestCommands          ),
+    DefineSubCommand("replay",            CommandLine::ReplayCommands            ),
     CommandTableEnd
 };
 
@@ -7,10 +7,12 @@
  * OpenRCT2 is licensed under the GNU General Public License version 3.
  *****************************************************************************/
 
+#include "../core/Console.hpp"
 #include "../interface/Screenshot.h"
 #include "CommandLine.hpp"
 
 static ScreenshotOptions _options;
+static int32_t _jobs = 0;
 
 // clang-format off
 static constexpr const CommandLineOptionDefinition ScreenshotOptionsDef[]
@@ -28,13 +30,31 @@ static constexpr const CommandLineOptionDefinition ScreenshotOptionsDef[]
     OptionTableEnd
 };
 
+static constexpr const CommandLineOptionDefinition ScreenshotBatchOptionsDef[]
+{
+    { CMDLINE_TYPE_INTEGER, &_jobs,                  'j', "jobs",          "screenshots to render at once with multithreading (default: number of cores)" },
+    { CMDLINE_TYPE_INTEGER, &_options.weather,       NAC, "weather",       "weather to be used (0 = default, 1 = sunny, ..., 6 = thunder)." },
+    { CMDLINE_TYPE_SWITCH,  &_options.hide_guests,   NAC, "no-peeps",      "hide peeps" },
+    { CMDLINE_TYPE_SWITCH,  &_options.hide_sprites,  NAC, "no-sprites",    "hide all sprites (e.g. balloons, vehicles, guests)" },
+    { CMDLINE_TYPE_SWITCH,  &_options.clear_grass,   NAC, "clear-grass",   "set all grass to be clear of weeds" },
+    { CMDLINE_TYPE_SWITCH,  &_options.mowed_grass,   NAC, "mowed-grass",   "set all grass to be mowed" },
+    { CMDLINE_TYPE_SWITCH,  &_options.water_plants,  NAC, "water-plants",  "water plants for the screenshot" },
+    { CMDLINE_TYPE_SWITCH,  &_options.fix_vandalism, NAC, "fix-vandalism", "fix vandalism for the screenshot" },
+    { CMDLINE_TYPE_SWITCH,  &_options.remove_litter, NAC, "remove-litter", "remove litter for the screenshot" },
+    { CMDLINE_TYPE_SWITCH,  &_options.tidy_up_park,  NAC, "tidy-up-park",  "clear grass, water plants, fix vandalism and remove litter" },
+    { CMDLINE_TYPE_SWITCH,  &_options.transparent,   NAC, "transparent",   "make the background transparent" },
+    OptionTableEnd
+};
+
 static exitcode_t HandleScreenshot(CommandLineArgEnumerator *argEnumerator);
+static exitcode_t HandleScreenshotBatch(CommandLineArgEnumerator *argEnumerator);
 
 const CommandLineCommand CommandLine::ScreenshotCommands[]
 {
     // Main commands
     DefineCommand("", "<file> <output_image> <width> <height> [<x> <y> <zoom> <rotation>]", ScreenshotOptionsDef, HandleScreenshot),
     DefineCommand("", "<file> <output_image> giant <zoom> <rotation>",                      ScreenshotOptionsDef, HandleScreenshot),
+    DefineCommand("batch", "<batch_file>",                                                  ScreenshotBatchOptionsDef, HandleScreenshotBatch),
     CommandTableEnd
 };
 // clang-format on
@@ -50,3 +70,22 @@ static exitcode_t HandleScreenshot(CommandLineArgEnumerator* argEnumerator)
     }
     return EXITCODE_OK;
 }
+
+static exitcode_t HandleScreenshotBatch(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* batchPath;
+    if (!argEnumerator->TryPopString(&batchPath))
+    {
+        Console::Error::WriteLine("Expected a batch file with a screenshot on each line:");
+        Console::Error::WriteLine("<file> <output_image> <width> <height> [<x> <y> <zoom> <rotation>]");
+        Console::Error::WriteLine("<file> <output_image> giant <zoom> <rotation>");
+        return EXITCODE_FAIL;
+    }
+
+    int32_t result = cmdline_for_screenshot_batch(batchPath, _jobs, &_options);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
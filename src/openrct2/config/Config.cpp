@@ -208,6 +208,8 @@ namespace Config
             model->show_guest_purchases = reader->GetBoolean("show_guest_purchases", false);
             model->show_real_names_of_guests = reader->GetBoolean("show_real_names_of_guests", true);
             model->allow_early_completion = reader->GetBoolean("allow_early_completion", false);
+            model->peep_slot_scheduler = reader->GetBoolean("peep_slot_scheduler", false);
+            model->peep_tick_budget = reader->GetInt32("peep_tick_budget", 0);
             model->transparent_screenshot = reader->GetBoolean("transparent_screenshot", true);
         }
     }
@@ -281,6 +283,8 @@ namespace Config
         writer->WriteBoolean("show_guest_purchases", model->show_guest_purchases);
         writer->WriteBoolean("show_real_names_of_guests", model->show_real_names_of_guests);
         writer->WriteBoolean("allow_early_completion", model->allow_early_completion);
+        writer->WriteBoolean("peep_slot_scheduler", model->peep_slot_scheduler);
+        writer->WriteInt32("peep_tick_budget", model->peep_tick_budget);
         writer->WriteEnum<int32_t>("virtual_floor_style", model->virtual_floor_style, Enum_VirtualFloorStyle);
         writer->WriteBoolean("transparent_screenshot", model->transparent_screenshot);
     }
@@ -393,6 +397,7 @@ namespace Config
             model->log_server_actions = reader->GetBoolean("log_server_actions", false);
             model->pause_server_if_no_clients = reader->GetBoolean("pause_server_if_no_clients", false);
             model->desync_debugging = reader->GetBoolean("desync_debugging", false);
+            model->io_thread = reader->GetBoolean("io_thread", false);
         }
     }
 
@@ -419,6 +424,7 @@ namespace Config
         writer->WriteBoolean("log_server_actions", model->log_server_actions);
         writer->WriteBoolean("pause_server_if_no_clients", model->pause_server_if_no_clients);
         writer->WriteBoolean("desync_debugging", model->desync_debugging);
+        writer->WriteBoolean("io_thread", model->io_thread);
     }
 
     static void ReadNotifications(IIniReader* reader)
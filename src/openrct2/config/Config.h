@@ -85,6 +85,8 @@ struct GeneralConfiguration
     bool steam_overlay_pause;
     bool show_real_names_of_guests;
     bool allow_early_completion;
+    bool peep_slot_scheduler;
+    int32_t peep_tick_budget;
 
     // Loading and saving
     bool confirmation_prompt;
@@ -157,6 +159,7 @@ struct NetworkConfiguration
     bool log_server_actions;
     bool pause_server_if_no_clients;
     bool desync_debugging;
+    bool io_thread;
 };
 
 struct NotificationConfiguration
@@ -0,0 +1,37 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Hash
+{
+    constexpr uint64_t Fnv1aOffsetBasis = 0xCBF29CE484222325ULL;
+    constexpr uint64_t Fnv1aPrime = 0x100000001B3ULL;
+
+    /**
+     * 64-bit FNV-1a hash of some bytes, for cache keys rather than anything that has to be secure
+     * @param data bytes to hash
+     * @param length number of bytes
+     * @param seed starting value, other values the key depends on can be mixed into the offset basis here
+     * @return hash
+     */
+    inline uint64_t Fnv1a(const void* data, size_t length, uint64_t seed = Fnv1aOffsetBasis)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < length; i++)
+        {
+            hash = (hash ^ bytes[i]) * Fnv1aPrime;
+        }
+        return hash;
+    }
+} // namespace Hash
@@ -161,20 +161,102 @@ namespace Imaging
         }
     }
 
-    static void WritePng(std::ostream& ostream, const Image& image)
+    class PngStreamWriter final : public IImageStreamWriter
     {
-        png_structp png_ptr = nullptr;
-        png_colorp png_palette = nullptr;
-        try
+    private:
+        std::unique_ptr<std::ostream> _ownedStream;
+        png_structp _png = nullptr;
+        png_infop _info = nullptr;
+        png_colorp _palette = nullptr;
+        uint32_t _width{};
+        uint32_t _rowsLeft{};
+        uint32_t _bytesPerPixel{};
+
+    public:
+        PngStreamWriter(std::ostream& ostream, const Image& image)
         {
-            png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
-            if (png_ptr == nullptr)
+            try
+            {
+                Initialise(ostream, image);
+            }
+            catch (const std::exception&)
+            {
+                Dispose();
+                throw;
+            }
+        }
+
+        PngStreamWriter(std::unique_ptr<std::ostream> ostream, const Image& image)
+            : PngStreamWriter(*ostream, image)
+        {
+            _ownedStream = std::move(ostream);
+        }
+
+        ~PngStreamWriter() override
+        {
+            Dispose();
+        }
+
+        void WriteRows(const uint8_t* pixels, uint32_t numRows, uint32_t stride) override
+        {
+            if (numRows > _rowsLeft)
+            {
+                throw std::runtime_error("Too many rows written to PNG.");
+            }
+            if (stride < _width * _bytesPerPixel)
+            {
+                throw std::invalid_argument("stride is smaller than a row of the image.");
+            }
+
+            // Set error handler
+            if (setjmp(png_jmpbuf(_png)))
+            {
+                throw std::runtime_error("PNG ERROR");
+            }
+
+            for (uint32_t y = 0; y < numRows; y++)
+            {
+                png_write_row(_png, (png_const_bytep)pixels);
+                pixels += stride;
+            }
+            _rowsLeft -= numRows;
+        }
+
+        void Finish() override
+        {
+            if (_rowsLeft != 0)
+            {
+                throw std::runtime_error("Not all rows of the PNG have been written.");
+            }
+
+            // Set error handler
+            if (setjmp(png_jmpbuf(_png)))
+            {
+                throw std::runtime_error("PNG ERROR");
+            }
+
+            png_write_end(_png, nullptr);
+            if (_ownedStream != nullptr)
+            {
+                _ownedStream->flush();
+                if (_ownedStream->fail())
+                {
+                    throw std::runtime_error("Unable to write PNG to file.");
+                }
+            }
+        }
+
+    private:
+        void Initialise(std::ostream& ostream, const Image& image)
+        {
+            _png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
+            if (_png == nullptr)
             {
                 throw std::runtime_error("png_create_write_struct failed.");
             }
 
-            auto info_ptr = png_create_info_struct(png_ptr);
-            if (info_ptr == nullptr)
+            _info = png_create_info_struct(_png);
+            if (_info == nullptr)
             {
                 throw std::runtime_error("png_create_info_struct failed.");
             }
@@ -187,25 +269,25 @@ namespace Imaging
                 }
 
                 // Set the palette
-                png_palette = (png_colorp)png_malloc(png_ptr, PNG_MAX_PALETTE_LENGTH * sizeof(png_color));
-                if (png_palette == nullptr)
+                _palette = (png_colorp)png_malloc(_png, PNG_MAX_PALETTE_LENGTH * sizeof(png_color));
+                if (_palette == nullptr)
                 {
                     throw std::runtime_error("png_malloc failed.");
                 }
                 for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
                 {
                     const auto entry = &image.Palette->entries[i];
-                    png_palette[i].blue = entry->blue;
-                    png_palette[i].green = entry->green;
-                    png_palette[i].red = entry->red;
+                    _palette[i].blue = entry->blue;
+                    _palette[i].green = entry->green;
+                    _palette[i].red = entry->red;
                 }
-                png_set_PLTE(png_ptr, info_ptr, png_palette, PNG_MAX_PALETTE_LENGTH);
+                png_set_PLTE(_png, _info, _palette, PNG_MAX_PALETTE_LENGTH);
             }
 
-            png_set_write_fn(png_ptr, &ostream, PngWriteData, PngFlush);
+            png_set_write_fn(_png, &ostream, PngWriteData, PngFlush);
 
             // Set error handler
-            if (setjmp(png_jmpbuf(png_ptr)))
+            if (setjmp(png_jmpbuf(_png)))
             {
                 throw std::runtime_error("PNG ERROR");
             }
@@ -215,32 +297,37 @@ namespace Imaging
             if (image.Depth == 8)
             {
                 png_byte transparentIndex = 0;
-                png_set_tRNS(png_ptr, info_ptr, &transparentIndex, 1, nullptr);
+                png_set_tRNS(_png, _info, &transparentIndex, 1, nullptr);
                 colourType = PNG_COLOR_TYPE_PALETTE;
             }
             png_set_IHDR(
-                png_ptr, info_ptr, image.Width, image.Height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+                _png, _info, image.Width, image.Height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
                 PNG_FILTER_TYPE_DEFAULT);
-            png_write_info(png_ptr, info_ptr);
+            png_write_info(_png, _info);
 
-            // Write pixels
-            auto pixels = image.Pixels.data();
-            for (uint32_t y = 0; y < image.Height; y++)
-            {
-                png_write_row(png_ptr, (png_byte*)pixels);
-                pixels += image.Stride;
-            }
-
-            png_write_end(png_ptr, nullptr);
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
+            _width = image.Width;
+            _rowsLeft = image.Height;
+            _bytesPerPixel = image.Depth == 8 ? 1 : 4;
         }
-        catch (const std::exception&)
+
+        void Dispose()
         {
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
-            throw;
+            if (_png != nullptr)
+            {
+                png_free(_png, _palette);
+                png_destroy_write_struct(&_png, &_info);
+            }
+            _palette = nullptr;
+            _info = nullptr;
+            _png = nullptr;
         }
+    };
+
+    static void WritePng(std::ostream& ostream, const Image& image)
+    {
+        PngStreamWriter writer(ostream, image);
+        writer.WriteRows(image.Pixels.data(), image.Height, image.Stride);
+        writer.Finish();
     }
 
     IMAGE_FORMAT GetImageFormatFromPath(const std::string_view& path)
@@ -343,4 +430,30 @@ namespace Imaging
                 throw std::runtime_error(EXCEPTION_IMAGE_FORMAT_UNKNOWN);
         }
     }
+
+    std::unique_ptr<IImageStreamWriter> CreateStreamWriter(
+        const std::string_view& path, const Image& image, IMAGE_FORMAT format)
+    {
+        switch (format)
+        {
+            case IMAGE_FORMAT::AUTOMATIC:
+                return CreateStreamWriter(path, image, GetImageFormatFromPath(path));
+            case IMAGE_FORMAT::PNG:
+            {
+#if defined(_WIN32) && !defined(__MINGW32__)
+                auto pathW = String::ToWideChar(path);
+                auto fs = std::make_unique<std::ofstream>(pathW, std::ios::binary);
+#else
+                auto fs = std::make_unique<std::ofstream>(path.data(), std::ios::binary);
+#endif
+                if (!fs->is_open())
+                {
+                    throw std::runtime_error("Unable to open file for writing.");
+                }
+                return std::make_unique<PngStreamWriter>(std::move(fs), image);
+            }
+            default:
+                throw std::runtime_error(EXCEPTION_IMAGE_FORMAT_UNKNOWN);
+        }
+    }
 } // namespace Imaging
@@ -53,6 +53,17 @@ struct Image
 
 using ImageReaderFunc = std::function<Image(std::istream&, IMAGE_FORMAT)>;
 
+/**
+ * Encodes an image as its rows are produced, so the rows do not all have to be held in memory at once.
+ */
+interface IImageStreamWriter
+{
+    virtual ~IImageStreamWriter() = default;
+
+    virtual void WriteRows(const uint8_t* pixels, uint32_t numRows, uint32_t stride) abstract;
+    virtual void Finish() abstract;
+};
+
 namespace Imaging
 {
     IMAGE_FORMAT GetImageFormatFromPath(const std::string_view& path);
@@ -60,5 +71,12 @@ namespace Imaging
     Image ReadFromBuffer(const std::vector<uint8_t>& buffer, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
     void WriteToFile(const std::string_view& path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
 
+    /**
+     * Opens a file to write an image of the size, depth and palette of the given image to. Its pixels are ignored,
+     * rows are passed to the writer from top to bottom instead.
+     */
+    std::unique_ptr<IImageStreamWriter> CreateStreamWriter(
+        const std::string_view& path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
+
     void SetReader(IMAGE_FORMAT format, ImageReaderFunc impl);
 } // namespace Imaging
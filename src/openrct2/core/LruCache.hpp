@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * A map holding values up to a total cost, dropping the least recently used values first once it is over its capacity.
+ * The value added last is always kept, even if it costs more than the capacity on its own. Not thread safe, caches
+ * shared between threads are locked by their owner.
+ */
+template<typename TKey, typename TValue, typename THash = std::hash<TKey>> class LruCache
+{
+private:
+    struct Entry
+    {
+        TKey Key;
+        TValue Value;
+        size_t Cost;
+    };
+
+    // Most recently used first
+    std::list<Entry> _entries;
+    std::unordered_map<TKey, typename std::list<Entry>::iterator, THash> _index;
+    size_t _capacity;
+    size_t _cost{};
+
+public:
+    explicit LruCache(size_t capacity)
+        : _capacity(capacity)
+    {
+    }
+
+    /**
+     * Returns the value of a key and marks it as the most recently used, or nullptr if it is not cached. The value
+     * stays valid until it is dropped from the cache.
+     */
+    TValue* Find(const TKey& key)
+    {
+        auto it = _index.find(key);
+        if (it == _index.end())
+        {
+            return nullptr;
+        }
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return &it->second->Value;
+    }
+
+    /**
+     * Adds or replaces the value of a key as the most recently used, then drops the least recently used values until
+     * the cache is within its capacity again.
+     */
+    TValue& Set(const TKey& key, TValue value, size_t cost = 1)
+    {
+        Remove(key);
+        _entries.push_front({ key, std::move(value), cost });
+        _index.emplace(key, _entries.begin());
+        _cost += cost;
+        while (_cost > _capacity && _entries.size() > 1)
+        {
+            auto last = std::prev(_entries.end());
+            _cost -= last->Cost;
+            _index.erase(last->Key);
+            _entries.erase(last);
+        }
+        return _entries.front().Value;
+    }
+
+    bool Remove(const TKey& key)
+    {
+        auto it = _index.find(key);
+        if (it == _index.end())
+        {
+            return false;
+        }
+        _cost -= it->second->Cost;
+        _entries.erase(it->second);
+        _index.erase(it);
+        return true;
+    }
+
+    void Clear()
+    {
+        _index.clear();
+        _entries.clear();
+        _cost = 0;
+    }
+
+    size_t GetCount() const
+    {
+        return _entries.size();
+    }
+
+    size_t GetCost() const
+    {
+        return _cost;
+    }
+
+    size_t GetCapacity() const
+    {
+        return _capacity;
+    }
+};
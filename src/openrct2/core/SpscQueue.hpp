@@ -0,0 +1,88 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * A fixed-capacity lock-free ring buffer for passing items from exactly one producer thread to exactly one consumer
+ * thread. The items are stored in the queue itself, pushing and popping never allocate.
+ */
+template<typename T, size_t TCapacity> class SpscQueue
+{
+    static_assert(TCapacity != 0 && (TCapacity & (TCapacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+    std::array<T, TCapacity> _items{};
+
+    // The indices only ever increase, the slot of an index is the index modulo the capacity
+    // Written by the consumer
+    alignas(64) std::atomic<size_t> _head{ 0 };
+    // Only accessed by the producer, the last head it has seen
+    size_t _cachedHead = 0;
+    // Written by the producer
+    alignas(64) std::atomic<size_t> _tail{ 0 };
+    // Only accessed by the consumer, the last tail it has seen
+    size_t _cachedTail = 0;
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    static constexpr size_t GetCapacity()
+    {
+        return TCapacity;
+    }
+
+    /**
+     * Called by the producer. Returns false when the queue is full, in which case value is left untouched so the caller
+     * can keep it and try again later.
+     */
+    bool TryPush(T&& value)
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead == TCapacity)
+        {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead == TCapacity)
+            {
+                return false;
+            }
+        }
+        _items[tail & (TCapacity - 1)] = std::move(value);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Called by the consumer. Returns false when the queue is empty.
+     */
+    bool TryPop(T& value)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail)
+        {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail)
+            {
+                return false;
+            }
+        }
+        // Moving out leaves the slot empty, so a popped item does not stay alive until the slot is reused
+        value = std::move(_items[head & (TCapacity - 1)]);
+        _items[head & (TCapacity - 1)] = T();
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+};
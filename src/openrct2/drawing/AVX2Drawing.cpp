@@ -10,6 +10,7 @@
 #include "../common.h"
 #include "../core/Guard.hpp"
 #include "Drawing.h"
+#include "LightFX.h"
 
 #ifdef __AVX2__
 
@@ -42,6 +43,197 @@ void mask_avx2(
     }
 }
 
+namespace
+{
+    /**
+     * A palette split into its 16 entry parts, leaving out the parts that map each index to itself, so a remap only needs
+     * a shuffle for each part that changes something. Most remap palettes only change one or two parts.
+     */
+    struct PaletteShuffles256
+    {
+        __m256i Parts[16];
+        __m256i HighNibbles[16];
+        int32_t Count{};
+
+        explicit PaletteShuffles256(const uint8_t* palette)
+        {
+            const __m128i identity = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            for (int32_t i = 0; i < 16; i++)
+            {
+                const __m128i part = _mm_loadu_si128((const __m128i*)(palette + i * 16));
+                const __m128i identityPart = _mm_add_epi8(identity, _mm_set1_epi8((char)(i * 16)));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(part, identityPart)) != 0xFFFF)
+                {
+                    Parts[Count] = _mm256_broadcastsi128_si256(part);
+                    HighNibbles[Count] = _mm256_set1_epi8((char)i);
+                    Count++;
+                }
+            }
+        }
+
+        __m256i Remap(__m256i pixels) const
+        {
+            const __m256i lowMask = _mm256_set1_epi8(0x0F);
+            const __m256i low = _mm256_and_si256(pixels, lowMask);
+            const __m256i high = _mm256_and_si256(_mm256_srli_epi16(pixels, 4), lowMask);
+            __m256i result = pixels;
+            for (int32_t i = 0; i < Count; i++)
+            {
+                const __m256i inPart = _mm256_cmpeq_epi8(high, HighNibbles[i]);
+                result = _mm256_blendv_epi8(result, _mm256_shuffle_epi8(Parts[i], low), inPart);
+            }
+            return result;
+        }
+    };
+} // namespace
+
+template<BitmapBlitMode mode>
+static void bitmap_blit_avx2(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    const PaletteShuffles256* shuffles)
+{
+    const __m256i zero = {};
+    for (int32_t yy = 0; yy < height; yy++)
+    {
+        for (int32_t xx = 0; xx < width; xx += 32)
+        {
+            const __m256i source = _mm256_loadu_si256((const __m256i*)(src + xx));
+            const __m256i dest = _mm256_loadu_si256((const __m256i*)(dst + xx));
+            __m256i result;
+            if constexpr (mode == BitmapBlitMode::Copy)
+            {
+                result = _mm256_blendv_epi8(source, dest, _mm256_cmpeq_epi8(source, zero));
+            }
+            else if constexpr (mode == BitmapBlitMode::Remap)
+            {
+                const __m256i remapped = shuffles->Remap(source);
+                result = _mm256_blendv_epi8(remapped, dest, _mm256_cmpeq_epi8(remapped, zero));
+            }
+            else
+            {
+                result = _mm256_blendv_epi8(shuffles->Remap(dest), dest, _mm256_cmpeq_epi8(source, zero));
+            }
+            _mm256_storeu_si256((__m256i*)(dst + xx), result);
+        }
+        src += srcStride;
+        dst += dstStride;
+    }
+}
+
+void bitmap_blit_avx2(
+    BitmapBlitMode mode, int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap,
+    int32_t dstWrap, const uint8_t* RESTRICT palette)
+{
+    // Whole vectors of each line are done here, what is left of each line by the scalar function
+    const int32_t simdWidth = width > 0 ? (width & ~31) : 0;
+    if (simdWidth != 0)
+    {
+        const int32_t srcStride = width + srcWrap;
+        const int32_t dstStride = width + dstWrap;
+        switch (mode)
+        {
+            case BitmapBlitMode::Copy:
+                bitmap_blit_avx2<BitmapBlitMode::Copy>(simdWidth, height, src, dst, srcStride, dstStride, nullptr);
+                break;
+            case BitmapBlitMode::Remap:
+            {
+                const PaletteShuffles256 shuffles(palette);
+                bitmap_blit_avx2<BitmapBlitMode::Remap>(simdWidth, height, src, dst, srcStride, dstStride, &shuffles);
+                break;
+            }
+            case BitmapBlitMode::Blend:
+            {
+                const PaletteShuffles256 shuffles(palette);
+                bitmap_blit_avx2<BitmapBlitMode::Blend>(simdWidth, height, src, dst, srcStride, dstStride, &shuffles);
+                break;
+            }
+        }
+    }
+    if (simdWidth != width)
+    {
+        bitmap_blit_scalar(
+            mode, width - simdWidth, height, src + simdWidth, dst + simdWidth, srcWrap + simdWidth, dstWrap + simdWidth,
+            palette);
+    }
+}
+
+#    ifdef __ENABLE_LIGHTFX__
+
+void lightfx_add_light_avx2(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    uint8_t intensity)
+{
+    const int32_t simdWidth = width > 0 ? (width & ~31) : 0;
+    if (simdWidth != 0)
+    {
+        const __m256i multiplier = _mm256_set1_epi16(1 + intensity);
+        const uint8_t* srcLine = src;
+        uint8_t* dstLine = dst;
+        for (int32_t yy = 0; yy < height; yy++)
+        {
+            for (int32_t xx = 0; xx < simdWidth; xx += 32)
+            {
+                __m256i light = _mm256_loadu_si256((const __m256i*)(srcLine + xx));
+                if (intensity != 0xFF)
+                {
+                    const __m256i lo = _mm256_srli_epi16(
+                        _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(light)), multiplier), 8);
+                    const __m256i hi = _mm256_srli_epi16(
+                        _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(light, 1)), multiplier), 8);
+                    // Packing works on each 128 bit lane, so the 64 bit parts have to be put back in order
+                    light = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+                }
+                const __m256i dest = _mm256_loadu_si256((const __m256i*)(dstLine + xx));
+                _mm256_storeu_si256((__m256i*)(dstLine + xx), _mm256_adds_epu8(dest, light));
+            }
+            srcLine += srcStride;
+            dstLine += dstStride;
+        }
+    }
+    if (simdWidth != width)
+    {
+        lightfx_add_light_scalar(width - simdWidth, height, src + simdWidth, dst + simdWidth, srcStride, dstStride, intensity);
+    }
+}
+
+void lightfx_mix_line_avx2(
+    int32_t width, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT lightBits, uint32_t* RESTRICT dst,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+{
+    const int32_t simdWidth = width > 0 ? (width & ~7) : 0;
+    const __m256i six = _mm256_set1_epi16(6);
+    const __m128i spreadLo = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+    const __m128i spreadHi = _mm_setr_epi8(4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+    for (int32_t xx = 0; xx < simdWidth; xx += 8)
+    {
+        const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(bits + xx)));
+        const __m256i dark = _mm256_i32gather_epi32((const int*)palette, indices, 4);
+        const __m256i light = _mm256_i32gather_epi32((const int*)lightPalette, indices, 4);
+
+        // The intensity of each pixel for each of its channels, times 6
+        const __m128i intensities = _mm_loadl_epi64((const __m128i*)(lightBits + xx));
+        const __m256i intensityLo = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm_shuffle_epi8(intensities, spreadLo)), six);
+        const __m256i intensityHi = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm_shuffle_epi8(intensities, spreadHi)), six);
+
+        // (light * intensity) >> 8 is the high half of (light << 8) * intensity
+        const __m256i lightLo = _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(light)), 8);
+        const __m256i lightHi = _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(light, 1)), 8);
+        const __m256i lo = _mm256_add_epi16(
+            _mm256_cvtepu8_epi16(_mm256_castsi256_si128(dark)), _mm256_mulhi_epu16(lightLo, intensityLo));
+        const __m256i hi = _mm256_add_epi16(
+            _mm256_cvtepu8_epi16(_mm256_extracti128_si256(dark, 1)), _mm256_mulhi_epu16(lightHi, intensityHi));
+        const __m256i result = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+        _mm256_storeu_si256((__m256i*)(dst + xx), result);
+    }
+    if (simdWidth != width)
+    {
+        lightfx_mix_line_scalar(
+            width - simdWidth, bits + simdWidth, lightBits + simdWidth, dst + simdWidth, palette, lightPalette);
+    }
+}
+
+#    endif // __ENABLE_LIGHTFX__
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -55,4 +247,29 @@ void mask_avx2(
     openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
 }
 
+void bitmap_blit_avx2(
+    BitmapBlitMode mode, int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap,
+    int32_t dstWrap, const uint8_t* RESTRICT palette)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+#    ifdef __ENABLE_LIGHTFX__
+
+void lightfx_add_light_avx2(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    uint8_t intensity)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void lightfx_mix_line_avx2(
+    int32_t width, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT lightBits, uint32_t* RESTRICT dst,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+#    endif // __ENABLE_LIGHTFX__
+
 #endif // __AVX2__
@@ -18,6 +18,7 @@
 #include "../ui/UiContext.h"
 #include "../util/Util.h"
 #include "Drawing.h"
+#include "SpriteMipCache.h"
 
 #include <algorithm>
 #include <memory>
@@ -193,6 +194,62 @@ void mask_scalar(
     }
 }
 
+template<BitmapBlitMode mode>
+static void bitmap_blit_scalar(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap, int32_t dstWrap,
+    const uint8_t* RESTRICT palette)
+{
+    for (int32_t yy = 0; yy < height; yy++)
+    {
+        for (int32_t xx = 0; xx < width; xx++, src++, dst++)
+        {
+            if constexpr (mode == BitmapBlitMode::Copy)
+            {
+                uint8_t pixel = *src;
+                if (pixel)
+                {
+                    *dst = pixel;
+                }
+            }
+            else if constexpr (mode == BitmapBlitMode::Remap)
+            {
+                uint8_t pixel = palette[*src];
+                if (pixel)
+                {
+                    *dst = pixel;
+                }
+            }
+            else
+            {
+                if (*src)
+                {
+                    *dst = palette[*dst];
+                }
+            }
+        }
+        src += srcWrap;
+        dst += dstWrap;
+    }
+}
+
+void bitmap_blit_scalar(
+    BitmapBlitMode mode, int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap,
+    int32_t dstWrap, const uint8_t* RESTRICT palette)
+{
+    switch (mode)
+    {
+        case BitmapBlitMode::Copy:
+            bitmap_blit_scalar<BitmapBlitMode::Copy>(width, height, src, dst, srcWrap, dstWrap, palette);
+            break;
+        case BitmapBlitMode::Remap:
+            bitmap_blit_scalar<BitmapBlitMode::Remap>(width, height, src, dst, srcWrap, dstWrap, palette);
+            break;
+        case BitmapBlitMode::Blend:
+            bitmap_blit_scalar<BitmapBlitMode::Blend>(width, height, src, dst, srcWrap, dstWrap, palette);
+            break;
+    }
+}
+
 static std::string gfx_get_csg_header_path()
 {
     auto path = Path::ResolveCasing(Path::Combine(gConfigGeneral.rct1_path, "Data", "csg1i.dat"));
@@ -282,6 +339,7 @@ void gfx_unload_g1()
     SafeFree(_g1.data);
     _g1.elements.clear();
     _g1.elements.shrink_to_fit();
+    sprite_mip_clear();
 }
 
 void gfx_unload_g2()
@@ -289,6 +347,7 @@ void gfx_unload_g2()
     SafeFree(_g2.data);
     _g2.elements.clear();
     _g2.elements.shrink_to_fit();
+    sprite_mip_clear();
 }
 
 void gfx_unload_csg()
@@ -296,6 +355,7 @@ void gfx_unload_csg()
     SafeFree(_csg.data);
     _csg.elements.clear();
     _csg.elements.shrink_to_fit();
+    sprite_mip_clear();
 }
 
 bool gfx_load_g2()
@@ -413,6 +473,25 @@ void FASTCALL gfx_bmp_sprite_to_buffer(
     uint32_t dest_line_width = (dest_dpi->width / zoom_amount) + dest_dpi->pitch;
     uint32_t source_line_width = source_image->width * zoom_amount;
 
+    // Unzoomed sprites that skip transparent pixels are drawn by the vectorised functions
+    if (zoom_level == 0 && (imageId.HasPrimary() || imageId.IsBlended() || (source_image->flags & G1_FLAG_BMP)))
+    {
+        BitmapBlitMode mode = BitmapBlitMode::Copy;
+        if (imageId.HasPrimary())
+        {
+            mode = BitmapBlitMode::Remap;
+        }
+        else if (imageId.IsBlended())
+        {
+            mode = BitmapBlitMode::Blend;
+        }
+        assert(mode == BitmapBlitMode::Copy || palette_pointer != nullptr);
+        bitmap_blit_fn(
+            mode, width, height, source_pointer, dest_pointer, source_line_width - width, dest_line_width - width,
+            palette_pointer);
+        return;
+    }
+
     // Image uses the palette pointer to remap the colours of the image
     if (imageId.HasPrimary())
     {
@@ -573,6 +652,55 @@ void FASTCALL gfx_draw_sprite_software(rct_drawpixelinfo* dpi, ImageId imageId,
     }
 }
 
+static void gfx_draw_g1_element_software(
+    rct_drawpixelinfo* dpi, ImageId imageId, const rct_g1_element* g1, int32_t x, int32_t y, uint8_t* palette_pointer);
+
+/**
+ * Draws a sprite at a zoom level from a cached copy with only the pixels drawn at that zoom level, which gives the same
+ * result as skipping over the other pixels. Returns false if the sprite has to be drawn without the copy.
+ */
+static bool gfx_draw_sprite_mip_software(
+    rct_drawpixelinfo* dpi, ImageId imageId, const rct_g1_element* g1, int32_t x, int32_t y, uint8_t* palette_pointer)
+{
+    if (g1->flags & G1_FLAG_1)
+    {
+        return false;
+    }
+
+    // Pixels are only picked the same way when the drawing area lines up with the zoomed pixels, as it does in viewports
+    int32_t zoom_level = dpi->zoom_level;
+    int32_t zoom_mask = (1 << zoom_level) - 1;
+    if ((dpi->x | dpi->y | dpi->width | dpi->height) & zoom_mask)
+    {
+        return false;
+    }
+
+    int32_t left = x + g1->x_offset;
+    int32_t top = y + g1->y_offset;
+    bool isRLE = (g1->flags & G1_FLAG_RLE_COMPRESSION) != 0;
+
+    // Which rows of an RLE sprite are drawn depends on where it is drawn
+    int32_t phase = isRLE ? (zoom_mask - top) & zoom_mask : 0;
+    auto mip = sprite_mip_get(imageId.GetIndex(), *g1, zoom_level, phase);
+    if (mip == nullptr)
+    {
+        return false;
+    }
+
+    rct_drawpixelinfo zoomed_dpi = *dpi;
+    zoomed_dpi.x = dpi->x >> zoom_level;
+    zoomed_dpi.y = dpi->y >> zoom_level;
+    zoomed_dpi.width = dpi->width >> zoom_level;
+    zoomed_dpi.height = dpi->height >> zoom_level;
+    zoomed_dpi.zoom_level = 0;
+
+    // Bitmap sprites are moved right to the next zoomed pixel, RLE sprites left
+    int32_t mipX = isRLE ? left >> zoom_level : (left + zoom_mask) >> zoom_level;
+    int32_t mipY = top >> zoom_level;
+    gfx_draw_g1_element_software(&zoomed_dpi, imageId, &mip->Element, mipX, mipY, palette_pointer);
+    return true;
+}
+
 /*
  * rct: 0x0067A46E
  * image_id (ebx) and also (0x00EDF81C)
@@ -612,6 +740,17 @@ void FASTCALL gfx_draw_sprite_palette_set_software(
         return;
     }
 
+    if (dpi->zoom_level != 0 && gfx_draw_sprite_mip_software(dpi, imageId, g1, x, y, palette_pointer))
+    {
+        return;
+    }
+
+    gfx_draw_g1_element_software(dpi, imageId, g1, x, y, palette_pointer);
+}
+
+static void gfx_draw_g1_element_software(
+    rct_drawpixelinfo* dpi, ImageId imageId, const rct_g1_element* g1, int32_t x, int32_t y, uint8_t* palette_pointer)
+{
     // Its used super often so we will define it to a separate variable.
     int32_t zoom_level = dpi->zoom_level;
     int32_t zoom_mask = 0xFFFFFFFF << zoom_level;
@@ -821,6 +960,18 @@ const rct_g1_element* gfx_get_g1_element(int32_t image_id)
     {
         return &_g1Temp;
     }
+    else if (offset >= SPR_SCROLLING_TEXT_START && offset < SPR_SCROLLING_TEXT_END)
+    {
+        auto g1 = scrolling_text_get_thread_g1_element(image_id);
+        if (g1 != nullptr)
+        {
+            return g1;
+        }
+        if (offset < _g1.elements.size())
+        {
+            return &_g1.elements[offset];
+        }
+    }
     else if (offset < SPR_RCTC_G1_END)
     {
         if (offset < _g1.elements.size())
@@ -880,6 +1031,11 @@ void gfx_set_g1_element(int32_t imageId, const rct_g1_element* g1)
 
     if (g1 != nullptr)
     {
+        if (isValid)
+        {
+            sprite_mip_invalidate(imageId);
+        }
+
         if (isTemp)
         {
             _g1Temp = *g1;
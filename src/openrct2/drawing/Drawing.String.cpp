@@ -9,6 +9,8 @@
 
 #include "../common.h"
 #include "../config/Config.h"
+#include "../core/Hash.hpp"
+#include "../core/LruCache.hpp"
 #include "../drawing/Drawing.h"
 #include "../interface/Viewport.h"
 #include "../localisation/Localisation.h"
@@ -19,6 +21,12 @@
 #include "TTF.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 enum : uint32_t
 {
@@ -485,11 +493,8 @@ struct text_draw_info
     const int8_t* y_offset;
 };
 
-static void ttf_draw_character_sprite(rct_drawpixelinfo* dpi, int32_t codepoint, text_draw_info* info)
+static void ttf_draw_glyph_sprite(rct_drawpixelinfo* dpi, int32_t sprite, int32_t characterWidth, text_draw_info* info)
 {
-    int32_t characterWidth = font_sprite_get_codepoint_width(info->font_sprite_base, codepoint);
-    int32_t sprite = font_sprite_get_codepoint_sprite(info->font_sprite_base, codepoint);
-
     if (!(info->flags & TEXT_DRAW_FLAG_NO_DRAW))
     {
         int32_t x = info->x;
@@ -504,6 +509,13 @@ static void ttf_draw_character_sprite(rct_drawpixelinfo* dpi, int32_t codepoint,
     info->x += characterWidth;
 }
 
+static void ttf_draw_character_sprite(rct_drawpixelinfo* dpi, int32_t codepoint, text_draw_info* info)
+{
+    int32_t characterWidth = font_sprite_get_codepoint_width(info->font_sprite_base, codepoint);
+    int32_t sprite = font_sprite_get_codepoint_sprite(info->font_sprite_base, codepoint);
+    ttf_draw_glyph_sprite(dpi, sprite, characterWidth, info);
+}
+
 static void ttf_draw_string_raw_sprite(rct_drawpixelinfo* dpi, const utf8* text, text_draw_info* info)
 {
     const utf8* ch = text;
@@ -537,7 +549,7 @@ static void ttf_draw_string_raw_ttf(rct_drawpixelinfo* dpi, const utf8* text, te
     else
     {
         uint8_t colour = info->palette[1];
-        TTFSurface* surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
+        auto surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
         if (surface == nullptr)
             return;
 
@@ -794,73 +806,230 @@ static const utf8* ttf_process_format_code(rct_drawpixelinfo* dpi, const utf8* t
     return nextCh;
 }
 
-static const utf8* ttf_process_glyph_run(rct_drawpixelinfo* dpi, const utf8* text, text_draw_info* info)
+enum class TextLayoutOpType : uint8_t
 {
-    utf8 buffer[512];
-    const utf8* ch = text;
-    const utf8* lastCh;
-    int32_t codepoint;
+    // A glyph of the sprite font
+    Glyph,
+    // A run of text drawn with the TrueType font
+    Run,
+    // A line break, back to the start of the line and down by the line height of the font at that point
+    Newline,
+    // A format code, processed again when drawn as it can depend on the window colours
+    FormatCode,
+};
 
-#ifndef NO_TTF
-    bool isTTF = info->flags & TEXT_DRAW_FLAG_TTF;
-#else
-    bool isTTF = false;
-#endif // NO_TTF
-    while (!utf8_is_format_code(codepoint = utf8_get_next(ch, &lastCh)))
-    {
-        if (isTTF && utf8_should_use_sprite_for_codepoint(codepoint))
-        {
-            break;
-        }
-        ch = lastCh;
-    }
-    if (codepoint == 0)
-    {
-        ttf_draw_string_raw(dpi, text, info);
-        return ch;
-    }
-    else
-    {
-        size_t length = (size_t)(ch - text);
-        std::memcpy(buffer, text, length);
-        buffer[length] = 0;
-        ttf_draw_string_raw(dpi, buffer, info);
-        return ch;
-    }
+struct TextLayoutOp
+{
+    TextLayoutOpType Type;
+    // Where the run starts in the runs of the layout, or the format code in its text
+    uint32_t Offset;
+    int32_t Sprite;
+    // How far a glyph or run moves right, or how far a line break moves down
+    int32_t Width;
+};
+
+/**
+ * A string split into the glyphs, runs, line breaks and format codes it is drawn with, so it can be drawn or measured
+ * again without decoding it and looking up the glyphs.
+ */
+struct TextLayout
+{
+    std::string Text;
+    uint16_t FontSpriteBase{};
+    bool IsTTF{};
+    uint32_t Generation{};
+    // The TrueType runs, each terminated by a null
+    std::string Runs;
+    std::vector<TextLayoutOp> Ops;
+    // The width measured when the layout was made, only valid without inline sprites as they are measured when drawn
+    int32_t Width{};
+    bool HasInlineSprites{};
+};
+
+// Longer strings are laid out every time they are drawn
+static constexpr size_t MAX_TEXT_LAYOUT_LENGTH = 1024;
+// Total size of the cached layouts
+static constexpr size_t MAX_TEXT_LAYOUT_CACHE_SIZE = 2 * 1024 * 1024;
+// Accounted for each layout on top of its text and operations
+static constexpr size_t TEXT_LAYOUT_OVERHEAD = 128;
+
+static std::mutex _textLayoutMutex;
+static LruCache<uint64_t, std::shared_ptr<const TextLayout>> _textLayoutCache(MAX_TEXT_LAYOUT_CACHE_SIZE);
+static std::atomic<uint32_t> _textLayoutGeneration;
+
+static uint64_t ttf_get_layout_hash(const utf8* text, size_t length, uint16_t fontSpriteBase, bool isTTF)
+{
+    return Hash::Fnv1a(text, length, Hash::Fnv1aOffsetBasis ^ ((uint64_t)fontSpriteBase << 1) ^ (uint64_t)isTTF);
 }
 
-static void ttf_process_string(rct_drawpixelinfo* dpi, const utf8* text, text_draw_info* info)
+static size_t ttf_get_layout_size(const TextLayout& layout)
 {
-    const utf8* ch = text;
-    const utf8* nextCh;
-    int32_t codepoint;
+    return layout.Text.size() + layout.Runs.size() + layout.Ops.size() * sizeof(TextLayoutOp) + TEXT_LAYOUT_OVERHEAD;
+}
 
+/**
+ * Splits the text the same way it is split when drawn: line breaks, other format codes, sprite font glyphs and runs of
+ * the TrueType font up to the next format code or glyph only in the sprite font.
+ */
+static void ttf_create_layout(TextLayout& layout)
+{
+    text_draw_info info = {};
+    info.font_sprite_base = layout.FontSpriteBase;
+    info.flags = TEXT_DRAW_FLAG_NO_DRAW;
 #ifndef NO_TTF
-    bool isTTF = info->flags & TEXT_DRAW_FLAG_TTF;
-#else
-    bool isTTF = false;
+    if (layout.IsTTF)
+    {
+        info.flags |= TEXT_DRAW_FLAG_TTF;
+    }
 #endif // NO_TTF
 
+    const utf8* text = layout.Text.c_str();
+    const utf8* ch = text;
+    const utf8* nextCh;
+    int32_t codepoint;
     while ((codepoint = utf8_get_next(ch, &nextCh)) != 0)
     {
-        if (utf8_is_format_code(codepoint))
+        if (codepoint == FORMAT_NEWLINE || codepoint == FORMAT_NEWLINE_SMALLER)
+        {
+            int32_t lineHeight = codepoint == FORMAT_NEWLINE ? font_get_line_height(info.font_sprite_base)
+                                                              : font_get_line_height_small(info.font_sprite_base);
+            layout.Ops.push_back({ TextLayoutOpType::Newline, 0, 0, lineHeight });
+            ch = ttf_process_format_code(nullptr, ch, &info);
+        }
+        else if (utf8_is_format_code(codepoint))
         {
-            ch = ttf_process_format_code(dpi, ch, info);
+            if (codepoint == FORMAT_INLINE_SPRITE)
+            {
+                layout.HasInlineSprites = true;
+            }
+            layout.Ops.push_back({ TextLayoutOpType::FormatCode, (uint32_t)(ch - text), 0, 0 });
+            ch = ttf_process_format_code(nullptr, ch, &info);
         }
-        else if (isTTF && utf8_should_use_sprite_for_codepoint(codepoint))
+        else if (!(info.flags & TEXT_DRAW_FLAG_TTF) || utf8_should_use_sprite_for_codepoint(codepoint))
         {
-            ttf_draw_character_sprite(dpi, codepoint, info);
+            int32_t width = font_sprite_get_codepoint_width(info.font_sprite_base, codepoint);
+            int32_t sprite = font_sprite_get_codepoint_sprite(info.font_sprite_base, codepoint);
+            layout.Ops.push_back({ TextLayoutOpType::Glyph, 0, sprite, width });
+            info.x += width;
             ch = nextCh;
         }
         else
         {
-            ch = ttf_process_glyph_run(dpi, ch, info);
+            const utf8* runEnd = nextCh;
+            while (!utf8_is_format_code(codepoint = utf8_get_next(runEnd, &nextCh))
+                   && !utf8_should_use_sprite_for_codepoint(codepoint))
+            {
+                runEnd = nextCh;
+            }
+
+            auto offset = layout.Runs.size();
+            layout.Runs.append(ch, runEnd - ch);
+            layout.Runs.push_back(0);
+
+            int32_t startX = info.x;
+            ttf_draw_string_raw(nullptr, layout.Runs.c_str() + offset, &info);
+            layout.Ops.push_back({ TextLayoutOpType::Run, (uint32_t)offset, 0, info.x - startX });
+            ch = runEnd;
+        }
+        info.maxX = std::max(info.maxX, info.x);
+    }
+    layout.Width = info.maxX;
+}
+
+static std::shared_ptr<const TextLayout> ttf_get_layout(const utf8* text, uint16_t fontSpriteBase, bool isTTF)
+{
+    size_t length = std::strlen(text);
+    uint64_t hash = 0;
+    if (length <= MAX_TEXT_LAYOUT_LENGTH)
+    {
+        hash = ttf_get_layout_hash(text, length, fontSpriteBase, isTTF);
+
+        std::lock_guard<std::mutex> lock(_textLayoutMutex);
+        auto cached = _textLayoutCache.Find(hash);
+        if (cached != nullptr)
+        {
+            const auto& layout = **cached;
+            if (layout.Generation == _textLayoutGeneration && layout.FontSpriteBase == fontSpriteBase
+                && layout.IsTTF == isTTF && layout.Text.size() == length
+                && std::memcmp(layout.Text.data(), text, length) == 0)
+            {
+                return *cached;
+            }
+        }
+    }
+
+    // Made without holding the lock as measuring the runs locks the TrueType font caches
+    auto layout = std::make_shared<TextLayout>();
+    layout->Text.assign(text, length);
+    layout->FontSpriteBase = fontSpriteBase;
+    layout->IsTTF = isTTF;
+    layout->Generation = _textLayoutGeneration;
+    ttf_create_layout(*layout);
+    if (length > MAX_TEXT_LAYOUT_LENGTH)
+    {
+        return layout;
+    }
+
+    std::lock_guard<std::mutex> lock(_textLayoutMutex);
+    _textLayoutCache.Set(hash, layout, ttf_get_layout_size(*layout));
+    return layout;
+}
+
+/**
+ * Makes every cached text layout be laid out again the next time it is drawn, for when the glyphs or fonts change.
+ * Scrolling text is rendered again as well.
+ */
+void gfx_invalidate_text_layouts()
+{
+    _textLayoutGeneration++;
+    scrolling_text_clear_strips();
+}
+
+static void ttf_draw_layout(rct_drawpixelinfo* dpi, const TextLayout& layout, text_draw_info* info)
+{
+    for (const auto& op : layout.Ops)
+    {
+        switch (op.Type)
+        {
+            case TextLayoutOpType::Glyph:
+                ttf_draw_glyph_sprite(dpi, op.Sprite, op.Width, info);
+                break;
+            case TextLayoutOpType::Run:
+                if (info->flags & TEXT_DRAW_FLAG_NO_DRAW)
+                {
+                    info->x += op.Width;
+                }
+                else
+                {
+                    // Drawing a run advances by its visible width, so it is not taken from the layout
+                    ttf_draw_string_raw(dpi, layout.Runs.c_str() + op.Offset, info);
+                }
+                break;
+            case TextLayoutOpType::Newline:
+                info->x = info->startX;
+                info->y += op.Width;
+                break;
+            case TextLayoutOpType::FormatCode:
+                ttf_process_format_code(dpi, layout.Text.c_str() + op.Offset, info);
+                break;
         }
         info->maxX = std::max(info->maxX, info->x);
         info->maxY = std::max(info->maxY, info->y);
     }
 }
 
+static void ttf_process_string(rct_drawpixelinfo* dpi, const utf8* text, text_draw_info* info)
+{
+#ifndef NO_TTF
+    bool isTTF = info->flags & TEXT_DRAW_FLAG_TTF;
+#else
+    bool isTTF = false;
+#endif // NO_TTF
+
+    auto layout = ttf_get_layout(text, info->font_sprite_base, isTTF);
+    ttf_draw_layout(dpi, *layout, info);
+}
+
 static void ttf_process_initial_colour(int32_t colour, text_draw_info* info)
 {
     if (colour != TEXT_COLOUR_254 && colour != TEXT_COLOUR_255)
@@ -974,8 +1143,18 @@ static int32_t ttf_get_string_width(const utf8* text)
         info.flags |= TEXT_DRAW_FLAG_TTF;
     }
 
-    ttf_process_string(nullptr, text, &info);
+#ifndef NO_TTF
+    bool isTTF = info.flags & TEXT_DRAW_FLAG_TTF;
+#else
+    bool isTTF = false;
+#endif // NO_TTF
+    auto layout = ttf_get_layout(text, info.font_sprite_base, isTTF);
+    if (!layout->HasInlineSprites)
+    {
+        return layout->Width;
+    }
 
+    ttf_draw_layout(nullptr, *layout, &info);
     return info.maxX;
 }
 
@@ -18,6 +18,7 @@
 #include "../sprites.h"
 #include "../util/Util.h"
 #include "../world/Water.h"
+#include "LightFX.h"
 
 // HACK These were originally passed back through registers
 thread_local int32_t gLastDrawStringX;
@@ -39,7 +40,7 @@ int32_t gPickupPeepY;
  * rct2: 0x0009ABE0C
  */
 // clang-format off
-uint8_t gPeepPalette[256] = {
+thread_local uint8_t gPeepPalette[256] = {
     0x00, 0xF3, 0xF4, 0xF5, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
     0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
     0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
@@ -59,7 +60,7 @@ uint8_t gPeepPalette[256] = {
 };
 
 /** rct2: 0x009ABF0C */
-uint8_t gOtherPalette[256] = {
+thread_local uint8_t gOtherPalette[256] = {
     0x00, 0xF3, 0xF4, 0xF5, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
     0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
     0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
@@ -79,7 +80,7 @@ uint8_t gOtherPalette[256] = {
 };
 
 // Originally 0x9ABE04
-uint8_t text_palette[0x8] = {
+thread_local uint8_t text_palette[0x8] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
 };
 
@@ -497,22 +498,30 @@ void (*mask_fn)(
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap)
     = nullptr;
 
+void (*bitmap_blit_fn)(
+    BitmapBlitMode mode, int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap,
+    int32_t dstWrap, const uint8_t* RESTRICT palette)
+    = bitmap_blit_scalar;
+
 void mask_init()
 {
     if (avx2_available())
     {
         log_verbose("registering AVX2 mask function");
         mask_fn = mask_avx2;
+        bitmap_blit_fn = bitmap_blit_avx2;
     }
     else if (sse41_available())
     {
         log_verbose("registering SSE4.1 mask function");
         mask_fn = mask_sse4_1;
+        bitmap_blit_fn = bitmap_blit_sse4_1;
     }
     else
     {
         log_verbose("registering scalar mask function");
         mask_fn = mask_scalar;
+        bitmap_blit_fn = bitmap_blit_scalar;
     }
 }
 
@@ -602,6 +611,9 @@ void load_palette()
 void gfx_invalidate_screen()
 {
     gfx_set_dirty_blocks(0, 0, context_get_width(), context_get_height());
+#ifdef __ENABLE_LIGHTFX__
+    lightfx_invalidate_all_occlusion();
+#endif
 }
 
 /*
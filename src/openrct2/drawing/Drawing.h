@@ -427,9 +427,9 @@ extern uint8_t gGamePalette[256 * 4];
 extern uint32_t gPaletteEffectFrame;
 extern const FILTER_PALETTE_ID GlassPaletteIds[COLOUR_COUNT];
 extern const uint16_t palette_to_g1_offset[];
-extern uint8_t gPeepPalette[256];
-extern uint8_t gOtherPalette[256];
-extern uint8_t text_palette[];
+extern thread_local uint8_t gPeepPalette[256];
+extern thread_local uint8_t gOtherPalette[256];
+extern thread_local uint8_t text_palette[];
 extern const translucent_window_palette TranslucentWindowPalettes[COLOUR_COUNT];
 
 extern thread_local int32_t gLastDrawStringX;
@@ -547,12 +547,15 @@ int32_t gfx_get_string_width(const utf8* buffer);
 int32_t gfx_get_string_width_new_lined(char* buffer);
 int32_t string_get_height_raw(char* buffer);
 int32_t gfx_clip_string(char* buffer, int32_t width);
+void gfx_invalidate_text_layouts();
 void shorten_path(utf8* buffer, size_t bufferSize, const utf8* path, int32_t availableWidth);
 void ttf_draw_string(rct_drawpixelinfo* dpi, const_utf8string text, int32_t colour, int32_t x, int32_t y);
 
 // scrolling text
 void scrolling_text_initialise_bitmaps();
 void scrolling_text_invalidate();
+void scrolling_text_clear_strips();
+const rct_g1_element* scrolling_text_get_thread_g1_element(int32_t imageId);
 int32_t scrolling_text_setup(
     struct paint_session* session, rct_string_id stringId, uint16_t scroll, uint16_t scrollingMode, colour_t colour);
 
@@ -574,6 +577,34 @@ extern void (*mask_fn)(
     int32_t width, int32_t height, const uint8_t* RESTRICT maskSrc, const uint8_t* RESTRICT colourSrc, uint8_t* RESTRICT dst,
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
 
+enum class BitmapBlitMode : uint8_t
+{
+    // Copies the opaque pixels of the sprite
+    Copy,
+    // Copies the opaque pixels of the sprite remapped by the palette, a pixel remapped to 0 is transparent
+    Remap,
+    // Remaps the destination by the palette wherever the sprite is opaque, used for glass
+    Blend,
+};
+
+void bitmap_blit_scalar(
+    BitmapBlitMode mode, int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap,
+    int32_t dstWrap, const uint8_t* RESTRICT palette);
+void bitmap_blit_sse4_1(
+    BitmapBlitMode mode, int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap,
+    int32_t dstWrap, const uint8_t* RESTRICT palette);
+void bitmap_blit_avx2(
+    BitmapBlitMode mode, int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap,
+    int32_t dstWrap, const uint8_t* RESTRICT palette);
+
+/**
+ * Draws an unzoomed bitmap sprite, picked by mask_init for the instruction sets the CPU supports. The palette is only
+ * used by the remap and blend modes and has to have 256 entries.
+ */
+extern void (*bitmap_blit_fn)(
+    BitmapBlitMode mode, int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap,
+    int32_t dstWrap, const uint8_t* RESTRICT palette);
+
 #include "NewDrawing.h"
 
 #endif
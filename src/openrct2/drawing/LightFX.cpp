@@ -25,9 +25,15 @@
 #    include "../world/Sprite.h"
 #    include "Drawing.h"
 
+#    include "../core/JobPool.hpp"
+
 #    include <algorithm>
 #    include <cmath>
 #    include <cstring>
+#    include <functional>
+#    include <memory>
+#    include <unordered_map>
+#    include <vector>
 
 static uint8_t _bakedLightTexture_lantern_0[32 * 32];
 static uint8_t _bakedLightTexture_lantern_1[64 * 64];
@@ -79,6 +85,38 @@ static uint8_t _current_view_zoom_back_delay = 0;
 
 static rct_palette gPalette_light;
 
+static LightOcclusionCache _lightOcclusionCache;
+static uint8_t _lightOcclusionRotation = 0xFF;
+static uint8_t _lightOcclusionZoom = 0xFF;
+static uint32_t _lightOcclusionViewFlags = 0;
+
+/**
+ * A light texture clipped to the light buffer.
+ */
+struct LightRect
+{
+    const uint8_t* Source;
+    int32_t SourceStride;
+    int32_t X, Y;
+    int32_t Width, Height;
+    uint8_t Intensity;
+};
+
+static std::vector<LightRect> _lightRects;
+static std::unique_ptr<JobPool> _lightJobs;
+
+// Bands are not made smaller than this many lines, so each job has enough work to be worth it
+static constexpr int32_t LIGHTFX_MIN_BAND_HEIGHT = 32;
+
+static void (*lightfx_add_light_fn)(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    uint8_t intensity)
+    = lightfx_add_light_scalar;
+static void (*lightfx_mix_line_fn)(
+    int32_t width, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT lightBits, uint32_t* RESTRICT dst,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+    = lightfx_mix_line_scalar;
+
 static uint8_t calc_light_intensity_lantern(int32_t x, int32_t y)
 {
     double distance = (double)(x * x + y * y);
@@ -133,6 +171,22 @@ void lightfx_init()
     _LightListBack = _LightListA;
     _LightListFront = _LightListB;
 
+    if (avx2_available())
+    {
+        lightfx_add_light_fn = lightfx_add_light_avx2;
+        lightfx_mix_line_fn = lightfx_mix_line_avx2;
+    }
+    else if (sse41_available())
+    {
+        lightfx_add_light_fn = lightfx_add_light_sse4_1;
+        lightfx_mix_line_fn = lightfx_mix_line_sse4_1;
+    }
+    else
+    {
+        lightfx_add_light_fn = lightfx_add_light_scalar;
+        lightfx_mix_line_fn = lightfx_mix_line_scalar;
+    }
+
     std::fill_n(_bakedLightTexture_lantern_0, 32 * 32, 0xFF);
     std::fill_n(_bakedLightTexture_lantern_1, 64 * 64, 0xFF);
     std::fill_n(_bakedLightTexture_lantern_2, 128 * 128, 0xFF);
@@ -178,204 +232,362 @@ void lightfx_update_buffers(rct_drawpixelinfo* info)
 
 extern void viewport_paint_setup();
 
-void lightfx_prepare_light_list()
+// clang-format off
+static constexpr const int16_t LightOcclusionSamplePattern[26] = {
+    0, 0,
+    -4, 0, 0, -3, 4, 0, 0, 3,
+    -2, -1, -1, -1, 2, 1, 1, 1,
+    -3, -2, -3, 2, 3, -2, 3, 2,
+};
+// clang-format on
+
+/**
+ * Samples what is drawn at one point of the pattern around a light, returning how much of the light it lets through out
+ * of 100 and the interaction type of what was found there.
+ */
+static uint32_t lightfx_sample_occlusion(
+    const lightlist_entry* entry, int32_t pat, uint16_t interactionFilter, int32_t* outInteractionType)
 {
-    for (uint32_t light = 0; light < LightListCurrentCountFront; light++)
+    CoordsXYZ coord_3d = { /* .x = */ entry->x,
+                           /* .y = */ entry->y,
+                           /* .z = */ entry->z };
+
+    int32_t dirVecX = 707;
+    int32_t dirVecY = 707;
+
+    switch (_current_view_rotation_front)
     {
-        lightlist_entry* entry = &_LightListFront[light];
+        case 0:
+            dirVecX = 707;
+            dirVecY = 707;
+            break;
+        case 1:
+            dirVecX = -707;
+            dirVecY = 707;
+            break;
+        case 2:
+            dirVecX = -707;
+            dirVecY = -707;
+            break;
+        case 3:
+            dirVecX = 707;
+            dirVecY = -707;
+            break;
+        default:
+            dirVecX = 0;
+            dirVecY = 0;
+            break;
+    }
 
-        if (entry->z == 0x7FFF)
-        {
-            entry->lightIntensity = 0xFF;
-            continue;
-        }
+    int32_t tileOffsetX = 0;
+    int32_t tileOffsetY = 0;
+    switch (_current_view_rotation_front)
+    {
+        case 0:
+            tileOffsetX = 0;
+            tileOffsetY = 0;
+            break;
+        case 1:
+            tileOffsetX = 16;
+            tileOffsetY = 0;
+            break;
+        case 2:
+            tileOffsetX = 32;
+            tileOffsetY = 32;
+            break;
+        case 3:
+            tileOffsetX = 0;
+            tileOffsetY = 16;
+            break;
+    }
 
-        CoordsXYZ coord_3d = { /* .x = */ entry->x,
-                               /* .y = */ entry->y,
-                               /* .z = */ entry->z };
+    int32_t mapFrontDiv = 1 << _current_view_zoom_front;
 
-        int32_t posOnScreenX = entry->viewCoords.x - _current_view_x_front;
-        int32_t posOnScreenY = entry->viewCoords.y - _current_view_y_front;
+    CoordsXY mapCoord{};
 
-        posOnScreenX >>= _current_view_zoom_front;
-        posOnScreenY >>= _current_view_zoom_front;
+    TileElement* tileElement = nullptr;
 
-        if ((posOnScreenX < -128) || (posOnScreenY < -128) || (posOnScreenX > _pixelInfo.width + 128)
-            || (posOnScreenY > _pixelInfo.height + 128))
-        {
-            entry->lightType = LIGHTFX_LIGHT_TYPE_NONE;
-            continue;
-        }
+    int32_t interactionType = 0;
+
+    auto* w = window_get_main();
+    if (w != nullptr)
+    {
+        // based on get_map_coordinates_from_pos_window
+        rct_drawpixelinfo dpi;
+        dpi.x = entry->viewCoords.x + LightOcclusionSamplePattern[0 + pat * 2] / mapFrontDiv;
+        dpi.y = entry->viewCoords.y + LightOcclusionSamplePattern[1 + pat * 2] / mapFrontDiv;
+        dpi.height = 1;
+        dpi.zoom_level = _current_view_zoom_front;
+        dpi.width = 1;
+
+        paint_session* session = paint_session_alloc(&dpi, w->viewport->flags);
+        paint_session_generate(session);
+        paint_session_arrange(session);
+        auto info = set_interaction_info_from_paint_session(session, interactionFilter);
+        paint_session_free(session);
+
+        //  log_warning("[%i, %i]", dpi->x, dpi->y);
+
+        mapCoord = info.Loc;
+        mapCoord.x += tileOffsetX;
+        mapCoord.y += tileOffsetY;
+        interactionType = info.SpriteType;
+        tileElement = info.Element;
+    }
+    *outInteractionType = interactionType;
+
+    int32_t minDist = 0;
+    int32_t baseHeight = -999;
 
-        uint32_t lightIntensityOccluded = 0x0;
+    if (interactionType != VIEWPORT_INTERACTION_ITEM_SPRITE && tileElement)
+    {
+        baseHeight = tileElement->base_height;
+    }
+
+    minDist = ((baseHeight * 8) - coord_3d.z) / 2;
+
+    int32_t deltaX = mapCoord.x - coord_3d.x;
+    int32_t deltaY = mapCoord.y - coord_3d.y;
+
+    int32_t projDot = (dirVecX * deltaX + dirVecY * deltaY) / 1000;
+
+    projDot = std::max(minDist, projDot);
+
+    //  log_warning("light [%i, %i, %i], [%i, %i] minDist to %i: %i; projdot: %i", coord_3d.x, coord_3d.y,
+    //  coord_3d.z, mapCoord.x, mapCoord.y, baseHeight, minDist, projDot);
+
+    if (projDot < 5)
+    {
+        return 100;
+    }
+    return std::max(0, 200 - (projDot * 20));
+}
+
+/**
+ * Samples what is drawn at and around a light to find how much of it is occluded, each sample point adds up to 100.
+ */
+static void lightfx_calculate_occlusion(
+    const lightlist_entry* entry, uint16_t interactionFilter, uint32_t* occluded, int32_t* samplePoints)
+{
+    uint32_t lightIntensityOccluded = 0x0;
+
+    int32_t totalSamplePoints = 5;
+    int32_t startSamplePoint = 1;
+    // int32_t lastSampleCount = 0;
 
-        int32_t dirVecX = 707;
-        int32_t dirVecY = 707;
+    if ((entry->lightIDqualifier & 0xF) == LIGHTFX_LIGHT_QUALIFIER_MAP)
+    {
+        startSamplePoint = 0;
+        totalSamplePoints = 1;
+    }
 
-        switch (_current_view_rotation_front)
+    for (int32_t pat = startSamplePoint; pat < totalSamplePoints; pat++)
+    {
+        int32_t interactionType;
+        lightIntensityOccluded += lightfx_sample_occlusion(entry, pat, interactionFilter, &interactionType);
+
+        if (pat == 0)
         {
-            case 0:
-                dirVecX = 707;
-                dirVecY = 707;
-                break;
-            case 1:
-                dirVecX = -707;
-                dirVecY = 707;
-                break;
-            case 2:
-                dirVecX = -707;
-                dirVecY = -707;
+            if (lightIntensityOccluded == 100)
                 break;
-            case 3:
-                dirVecX = 707;
-                dirVecY = -707;
-                break;
-            default:
-                dirVecX = 0;
-                dirVecY = 0;
+            if (_current_view_zoom_front > 2)
                 break;
+            totalSamplePoints += 4;
         }
-
-        int32_t tileOffsetX = 0;
-        int32_t tileOffsetY = 0;
-        switch (_current_view_rotation_front)
+        else if (pat == 4)
         {
-            case 0:
-                tileOffsetX = 0;
-                tileOffsetY = 0;
-                break;
-            case 1:
-                tileOffsetX = 16;
-                tileOffsetY = 0;
+            if (_current_view_zoom_front > 1)
                 break;
-            case 2:
-                tileOffsetX = 32;
-                tileOffsetY = 32;
-                break;
-            case 3:
-                tileOffsetX = 0;
-                tileOffsetY = 16;
+            if (lightIntensityOccluded == 0 || lightIntensityOccluded == 500)
                 break;
+            // lastSampleCount = lightIntensityOccluded / 500;
+            //  break;
+            totalSamplePoints += 4;
+        }
+        else if (pat == 8)
+        {
+            break;
+            // if (_current_view_zoom_front > 0)
+            //  break;
+            // int32_t newSampleCount = lightIntensityOccluded / 900;
+            // if (abs(newSampleCount - lastSampleCount) < 10)
+            //  break;
+            // totalSamplePoints += 4;
         }
+    }
 
-        int32_t mapFrontDiv = 1 << _current_view_zoom_front;
+    totalSamplePoints -= startSamplePoint;
 
-        // clang-format off
-        static int16_t offsetPattern[26] = {
-            0, 0,
-            -4, 0, 0, -3, 4, 0, 0, 3,
-            -2, -1, -1, -1, 2, 1, 1, 1,
-            -3, -2, -3, 2, 3, -2, 3, 2,
-        };
-        // clang-format on
+    *occluded = lightIntensityOccluded;
+    *samplePoints = totalSamplePoints;
+}
 
-        // Light occlusion code
-        if (true)
-        {
-            int32_t totalSamplePoints = 5;
-            int32_t startSamplePoint = 1;
-            // int32_t lastSampleCount = 0;
+/**
+ * Dims a light on the map by the sprite drawn in front of it, if any. Only the light itself is sampled, as this is done
+ * every frame on top of the cached occlusion by the tiles.
+ */
+static void lightfx_apply_sprite_occlusion(const lightlist_entry* entry, uint32_t* occluded)
+{
+    int32_t interactionType;
+    uint32_t spriteOccluded = lightfx_sample_occlusion(entry, 0, VIEWPORT_INTERACTION_MASK_NONE, &interactionType);
+    if (interactionType == VIEWPORT_INTERACTION_ITEM_SPRITE)
+    {
+        *occluded = *occluded * spriteOccluded / 100;
+    }
+}
 
-            if ((entry->lightIDqualifier & 0xF) == LIGHTFX_LIGHT_QUALIFIER_MAP)
-            {
-                startSamplePoint = 0;
-                totalSamplePoints = 1;
-            }
+/**
+ * Gets the occlusion of a light. Lights on the map are only sampled again when the tiles drawn around them have changed,
+ * apart from the sprites in front of them. Lights of vehicles move, so they are always sampled.
+ */
+static void lightfx_get_occlusion(const lightlist_entry* entry, uint32_t* occluded, int32_t* samplePoints)
+{
+    auto* w = window_get_main();
+    if ((entry->lightIDqualifier & 0xF) != LIGHTFX_LIGHT_QUALIFIER_MAP || w == nullptr || w->viewport == nullptr)
+    {
+        lightfx_calculate_occlusion(entry, VIEWPORT_INTERACTION_MASK_NONE, occluded, samplePoints);
+        return;
+    }
 
-            for (int32_t pat = startSamplePoint; pat < totalSamplePoints; pat++)
-            {
-                CoordsXY mapCoord{};
+    // What is drawn depends on how the view is drawn
+    if (_lightOcclusionRotation != _current_view_rotation_front || _lightOcclusionZoom != _current_view_zoom_front
+        || _lightOcclusionViewFlags != w->viewport->flags)
+    {
+        _lightOcclusionCache.Clear();
+        _lightOcclusionRotation = _current_view_rotation_front;
+        _lightOcclusionZoom = _current_view_zoom_front;
+        _lightOcclusionViewFlags = w->viewport->flags;
+    }
 
-                TileElement* tileElement = nullptr;
+    if (!_lightOcclusionCache.TryGet(entry->lightID, entry->lightIDqualifier, entry->viewCoords, occluded, samplePoints))
+    {
+        lightfx_calculate_occlusion(entry, (uint16_t)~VIEWPORT_INTERACTION_MASK_SPRITE, occluded, samplePoints);
+        _lightOcclusionCache.Set(entry->lightID, entry->lightIDqualifier, entry->viewCoords, *occluded, *samplePoints);
+    }
+    if (*occluded != 0)
+    {
+        lightfx_apply_sprite_occlusion(entry, occluded);
+    }
+}
 
-                int32_t interactionType = 0;
+static uint64_t lightfx_get_occlusion_key(uint32_t lightID, uint16_t lightIDqualifier)
+{
+    return ((uint64_t)lightID << 16) | lightIDqualifier;
+}
 
-                auto* w = window_get_main();
-                if (w != nullptr)
-                {
-                    // based on get_map_coordinates_from_pos_window
-                    rct_drawpixelinfo dpi;
-                    dpi.x = entry->viewCoords.x + offsetPattern[0 + pat * 2] / mapFrontDiv;
-                    dpi.y = entry->viewCoords.y + offsetPattern[1 + pat * 2] / mapFrontDiv;
-                    dpi.height = 1;
-                    dpi.zoom_level = _current_view_zoom_front;
-                    dpi.width = 1;
-
-                    paint_session* session = paint_session_alloc(&dpi, w->viewport->flags);
-                    paint_session_generate(session);
-                    paint_session_arrange(session);
-                    auto info = set_interaction_info_from_paint_session(session, VIEWPORT_INTERACTION_MASK_NONE);
-                    paint_session_free(session);
-
-                    //  log_warning("[%i, %i]", dpi->x, dpi->y);
-
-                    mapCoord = info.Loc;
-                    mapCoord.x += tileOffsetX;
-                    mapCoord.y += tileOffsetY;
-                    interactionType = info.SpriteType;
-                    tileElement = info.Element;
-                }
+bool LightOcclusionCache::TryGet(
+    uint32_t lightID, uint16_t lightIDqualifier, const ScreenCoordsXY& viewCoords, uint32_t* occluded, int32_t* samplePoints)
+{
+    auto it = _entries.find(lightfx_get_occlusion_key(lightID, lightIDqualifier));
+    if (it == _entries.end() || it->second.ViewCoords.x != viewCoords.x || it->second.ViewCoords.y != viewCoords.y)
+    {
+        return false;
+    }
+    it->second.LastUsedFrame = _frame;
+    *occluded = it->second.Occluded;
+    *samplePoints = it->second.SamplePoints;
+    return true;
+}
 
-                int32_t minDist = 0;
-                int32_t baseHeight = -999;
+void LightOcclusionCache::Set(
+    uint32_t lightID, uint16_t lightIDqualifier, const ScreenCoordsXY& viewCoords, uint32_t occluded, int32_t samplePoints)
+{
+    _entries[lightfx_get_occlusion_key(lightID, lightIDqualifier)] = { viewCoords, occluded, samplePoints, _frame };
+}
 
-                if (interactionType != VIEWPORT_INTERACTION_ITEM_SPRITE && tileElement)
-                {
-                    baseHeight = tileElement->base_height;
-                }
+void LightOcclusionCache::Invalidate(int32_t left, int32_t top, int32_t right, int32_t bottom)
+{
+    if (_entries.empty())
+        return;
 
-                minDist = ((baseHeight * 8) - coord_3d.z) / 2;
+    // The sample points are a few pixels around the light
+    left -= 4;
+    top -= 4;
+    right += 4;
+    bottom += 4;
+    for (auto it = _entries.begin(); it != _entries.end();)
+    {
+        const auto& viewCoords = it->second.ViewCoords;
+        if (viewCoords.x >= left && viewCoords.x < right && viewCoords.y >= top && viewCoords.y < bottom)
+            it = _entries.erase(it);
+        else
+            ++it;
+    }
+}
 
-                int32_t deltaX = mapCoord.x - coord_3d.x;
-                int32_t deltaY = mapCoord.y - coord_3d.y;
+void LightOcclusionCache::Clear()
+{
+    _entries.clear();
+}
 
-                int32_t projDot = (dirVecX * deltaX + dirVecY * deltaY) / 1000;
+void LightOcclusionCache::BeginFrame()
+{
+    _frame++;
+}
 
-                projDot = std::max(minDist, projDot);
+void LightOcclusionCache::ForgetUnused()
+{
+    for (auto it = _entries.begin(); it != _entries.end();)
+    {
+        if (it->second.LastUsedFrame != _frame)
+            it = _entries.erase(it);
+        else
+            ++it;
+    }
+}
 
-                if (projDot < 5)
-                {
-                    lightIntensityOccluded += 100;
-                }
-                else
-                {
-                    lightIntensityOccluded += std::max(0, 200 - (projDot * 20));
-                }
+size_t LightOcclusionCache::GetCount() const
+{
+    return _entries.size();
+}
 
-                //  log_warning("light %i [%i, %i, %i], [%i, %i] minDist to %i: %i; projdot: %i", light, coord_3d.x, coord_3d.y,
-                //  coord_3d.z, mapCoord.x, mapCoord.y, baseHeight, minDist, projDot);
+LightOcclusionCache& lightfx_get_occlusion_cache()
+{
+    return _lightOcclusionCache;
+}
 
-                if (pat == 0)
-                {
-                    if (lightIntensityOccluded == 100)
-                        break;
-                    if (_current_view_zoom_front > 2)
-                        break;
-                    totalSamplePoints += 4;
-                }
-                else if (pat == 4)
-                {
-                    if (_current_view_zoom_front > 1)
-                        break;
-                    if (lightIntensityOccluded == 0 || lightIntensityOccluded == 500)
-                        break;
-                    // lastSampleCount = lightIntensityOccluded / 500;
-                    //  break;
-                    totalSamplePoints += 4;
-                }
-                else if (pat == 8)
-                {
-                    break;
-                    // if (_current_view_zoom_front > 0)
-                    //  break;
-                    // int32_t newSampleCount = lightIntensityOccluded / 900;
-                    // if (abs(newSampleCount - lastSampleCount) < 10)
-                    //  break;
-                    // totalSamplePoints += 4;
-                }
-            }
+void lightfx_invalidate_occlusion(int32_t left, int32_t top, int32_t right, int32_t bottom)
+{
+    _lightOcclusionCache.Invalidate(left, top, right, bottom);
+}
+
+void lightfx_invalidate_all_occlusion()
+{
+    _lightOcclusionCache.Clear();
+}
+
+void lightfx_prepare_light_list()
+{
+    _lightOcclusionCache.BeginFrame();
+
+    for (uint32_t light = 0; light < LightListCurrentCountFront; light++)
+    {
+        lightlist_entry* entry = &_LightListFront[light];
+
+        if (entry->z == 0x7FFF)
+        {
+            entry->lightIntensity = 0xFF;
+            continue;
+        }
 
-            totalSamplePoints -= startSamplePoint;
+        int32_t posOnScreenX = entry->viewCoords.x - _current_view_x_front;
+        int32_t posOnScreenY = entry->viewCoords.y - _current_view_y_front;
+
+        posOnScreenX >>= _current_view_zoom_front;
+        posOnScreenY >>= _current_view_zoom_front;
+
+        if ((posOnScreenX < -128) || (posOnScreenY < -128) || (posOnScreenX > _pixelInfo.width + 128)
+            || (posOnScreenY > _pixelInfo.height + 128))
+        {
+            entry->lightType = LIGHTFX_LIGHT_TYPE_NONE;
+            continue;
+        }
+
+        // Light occlusion code
+        {
+            uint32_t lightIntensityOccluded;
+            int32_t totalSamplePoints;
+            lightfx_get_occlusion(entry, &lightIntensityOccluded, &totalSamplePoints);
 
             //  lightIntensityOccluded = totalSamplePoints * 100;
 
@@ -405,6 +617,9 @@ void lightfx_prepare_light_list()
             entry->lightType -= _current_view_zoom_front;
         }
     }
+
+    // Forget the lights that are not drawn anymore
+    _lightOcclusionCache.ForgetUnused();
 }
 
 void lightfx_swap_buffers()
@@ -448,6 +663,37 @@ void lightfx_update_viewport_settings()
     }
 }
 
+/**
+ * Runs a function for bands of lines of the light buffer, on the job pool when multithreading is enabled.
+ */
+static void lightfx_run_in_bands(int32_t height, const std::function<void(int32_t, int32_t)>& fn)
+{
+    bool useMultithreading = gConfigGeneral.multithreading;
+    if (useMultithreading && _lightJobs == nullptr)
+    {
+        _lightJobs = std::make_unique<JobPool>();
+    }
+    else if (!useMultithreading && _lightJobs != nullptr)
+    {
+        _lightJobs.reset();
+    }
+
+    int32_t bandCount = std::min<int32_t>(std::thread::hardware_concurrency(), height / LIGHTFX_MIN_BAND_HEIGHT);
+    if (_lightJobs == nullptr || bandCount <= 1)
+    {
+        fn(0, height);
+        return;
+    }
+
+    for (int32_t band = 0; band < bandCount; band++)
+    {
+        int32_t top = (height * band) / bandCount;
+        int32_t bottom = (height * (band + 1)) / bandCount;
+        _lightJobs->AddTask([&fn, top, bottom]() { fn(top, bottom); });
+    }
+    _lightJobs->Join();
+}
+
 void lightfx_render_lights_to_frontbuffer()
 {
     if (_light_rendered_buffer_front == nullptr)
@@ -455,20 +701,17 @@ void lightfx_render_lights_to_frontbuffer()
         return;
     }
 
-    std::memset(_light_rendered_buffer_front, 0, _pixelInfo.width * _pixelInfo.height);
-
     _lightPolution_back = 0;
+    _lightRects.clear();
 
     //  log_warning("%i lights", LightListCurrentCountFront);
 
     for (uint32_t light = 0; light < LightListCurrentCountFront; light++)
     {
         const uint8_t* bufReadBase = nullptr;
-        uint8_t* bufWriteBase = (uint8_t*)_light_rendered_buffer_front;
         uint32_t bufReadWidth, bufReadHeight;
         int32_t bufWriteX, bufWriteY;
         int32_t bufWriteWidth, bufWriteHeight;
-        uint32_t bufReadSkip, bufWriteSkip;
 
         lightlist_entry* entry = &_LightListFront[light];
 
@@ -539,10 +782,7 @@ void lightfx_render_lights_to_frontbuffer()
         {
             bufReadBase += -bufWriteX;
             bufWriteWidth += bufWriteX;
-        }
-        else
-        {
-            bufWriteBase += bufWriteX;
+            bufWriteX = 0;
         }
 
         if (bufWriteWidth <= 0)
@@ -552,10 +792,7 @@ void lightfx_render_lights_to_frontbuffer()
         {
             bufReadBase += -bufWriteY * bufReadWidth;
             bufWriteHeight += bufWriteY;
-        }
-        else
-        {
-            bufWriteBase += bufWriteY * _pixelInfo.width;
+            bufWriteY = 0;
         }
 
         if (bufWriteHeight <= 0)
@@ -580,39 +817,45 @@ void lightfx_render_lights_to_frontbuffer()
 
         _lightPolution_back += (bufWriteWidth * bufWriteHeight) / 256;
 
-        bufReadSkip = bufReadWidth - bufWriteWidth;
-        bufWriteSkip = _pixelInfo.width - bufWriteWidth;
+        _lightRects.push_back(
+            { bufReadBase, (int32_t)bufReadWidth, bufWriteX, bufWriteY, bufWriteWidth, bufWriteHeight,
+              entry->lightIntensity });
+    }
 
-        if (entry->lightIntensity == 0xFF)
+    // Each band adds every light to its own lines, in the same order
+    uint8_t* lightBuffer = (uint8_t*)_light_rendered_buffer_front;
+    const int32_t lightBufferWidth = _pixelInfo.width;
+    lightfx_run_in_bands(_pixelInfo.height, [lightBuffer, lightBufferWidth](int32_t top, int32_t bottom) {
+        std::memset(lightBuffer + top * lightBufferWidth, 0, (bottom - top) * lightBufferWidth);
+        for (const auto& rect : _lightRects)
         {
-            for (int32_t y = 0; y < bufWriteHeight; y++)
-            {
-                for (int32_t x = 0; x < bufWriteWidth; x++)
-                {
-                    *bufWriteBase = std::min(0xFF, *bufWriteBase + *bufReadBase);
-                    bufWriteBase++;
-                    bufReadBase++;
-                }
+            int32_t rectTop = std::max(rect.Y, top);
+            int32_t rectBottom = std::min(rect.Y + rect.Height, bottom);
+            if (rectTop >= rectBottom)
+                continue;
 
-                bufWriteBase += bufWriteSkip;
-                bufReadBase += bufReadSkip;
-            }
+            const uint8_t* src = rect.Source + (rectTop - rect.Y) * rect.SourceStride;
+            uint8_t* dst = lightBuffer + rectTop * lightBufferWidth + rect.X;
+            lightfx_add_light_fn(
+                rect.Width, rectBottom - rectTop, src, dst, rect.SourceStride, lightBufferWidth, rect.Intensity);
         }
-        else
-        {
-            for (int32_t y = 0; y < bufWriteHeight; y++)
-            {
-                for (int32_t x = 0; x < bufWriteWidth; x++)
-                {
-                    *bufWriteBase = std::min(0xFF, *bufWriteBase + (((*bufReadBase) * (1 + entry->lightIntensity)) >> 8));
-                    bufWriteBase++;
-                    bufReadBase++;
-                }
+    });
+}
 
-                bufWriteBase += bufWriteSkip;
-                bufReadBase += bufReadSkip;
-            }
+void lightfx_add_light_scalar(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    uint8_t intensity)
+{
+    // A full intensity adds the texture as it is, as (src * 256) >> 8 == src
+    const uint32_t multiplier = 1 + intensity;
+    for (int32_t y = 0; y < height; y++)
+    {
+        for (int32_t x = 0; x < width; x++)
+        {
+            dst[x] = std::min<uint32_t>(0xFF, dst[x] + ((src[x] * multiplier) >> 8));
         }
+        src += srcStride;
+        dst += dstStride;
     }
 }
 
@@ -1038,6 +1281,32 @@ static uint8_t mix_light(uint32_t a, uint32_t b, uint32_t intensity)
     return result;
 }
 
+void lightfx_mix_line_scalar(
+    int32_t width, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT lightBits, uint32_t* RESTRICT dst,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+{
+    for (int32_t x = 0; x < width; x++)
+    {
+        uint32_t darkColour = palette[bits[x]];
+        uint32_t lightColour = lightPalette[bits[x]];
+        uint8_t lightIntensity = lightBits[x];
+
+        uint32_t colour = 0;
+        if (lightIntensity == 0)
+        {
+            colour = darkColour;
+        }
+        else
+        {
+            colour |= mix_light((darkColour >> 0) & 0xFF, (lightColour >> 0) & 0xFF, lightIntensity);
+            colour |= mix_light((darkColour >> 8) & 0xFF, (lightColour >> 8) & 0xFF, lightIntensity) << 8;
+            colour |= mix_light((darkColour >> 16) & 0xFF, (lightColour >> 16) & 0xFF, lightIntensity) << 16;
+            colour |= mix_light((darkColour >> 24) & 0xFF, (lightColour >> 24) & 0xFF, lightIntensity) << 24;
+        }
+        dst[x] = colour;
+    }
+}
+
 void lightfx_render_to_texture(
     void* dstPixels, uint32_t dstPitch, uint8_t* bits, uint32_t width, uint32_t height, const uint32_t* palette,
     const uint32_t* lightPalette)
@@ -1053,32 +1322,15 @@ void lightfx_render_to_texture(
         return;
     }
 
-    for (uint32_t y = 0; y < height; y++)
-    {
-        uintptr_t dstOffset = (uintptr_t)(y * dstPitch);
-        uint32_t* dst = (uint32_t*)((uintptr_t)dstPixels + dstOffset);
-        for (uint32_t x = 0; x < width; x++)
+    lightfx_run_in_bands(height, [=](int32_t top, int32_t bottom) {
+        for (int32_t y = top; y < bottom; y++)
         {
-            uint8_t* src = &bits[y * width + x];
-            uint32_t darkColour = palette[*src];
-            uint32_t lightColour = lightPalette[*src];
-            uint8_t lightIntensity = lightBits[y * width + x];
-
-            uint32_t colour = 0;
-            if (lightIntensity == 0)
-            {
-                colour = darkColour;
-            }
-            else
-            {
-                colour |= mix_light((darkColour >> 0) & 0xFF, (lightColour >> 0) & 0xFF, lightIntensity);
-                colour |= mix_light((darkColour >> 8) & 0xFF, (lightColour >> 8) & 0xFF, lightIntensity) << 8;
-                colour |= mix_light((darkColour >> 16) & 0xFF, (lightColour >> 16) & 0xFF, lightIntensity) << 16;
-                colour |= mix_light((darkColour >> 24) & 0xFF, (lightColour >> 24) & 0xFF, lightIntensity) << 24;
-            }
-            *dst++ = colour;
+            uintptr_t dstOffset = (uintptr_t)(y * dstPitch);
+            uint32_t* dst = (uint32_t*)((uintptr_t)dstPixels + dstOffset);
+            size_t srcOffset = (size_t)y * width;
+            lightfx_mix_line_fn(width, bits + srcOffset, lightBits + srcOffset, dst, palette, lightPalette);
         }
-    }
+    });
 }
 
 #endif // __ENABLE_LIGHTFX__
@@ -13,6 +13,9 @@
 #ifdef __ENABLE_LIGHTFX__
 
 #    include "../common.h"
+#    include "../world/Location.hpp"
+
+#    include <unordered_map>
 
 struct CoordsXY;
 struct rct_drawpixelinfo;
@@ -66,11 +69,75 @@ void lightfx_add_lights_magic_vehicles();
 
 uint32_t lightfx_get_light_polution();
 
+/**
+ * How much of each light on the map is not occluded by the tiles drawn around it, which only changes when those tiles do.
+ * Sprites move every frame, so they are left out and sampled every frame instead.
+ */
+class LightOcclusionCache
+{
+private:
+    struct Entry
+    {
+        ScreenCoordsXY ViewCoords;
+        uint32_t Occluded;
+        int32_t SamplePoints;
+        uint32_t LastUsedFrame;
+    };
+
+    std::unordered_map<uint64_t, Entry> _entries;
+    uint32_t _frame = 0;
+
+public:
+    bool TryGet(
+        uint32_t lightID, uint16_t lightIDqualifier, const ScreenCoordsXY& viewCoords, uint32_t* occluded,
+        int32_t* samplePoints);
+    void Set(
+        uint32_t lightID, uint16_t lightIDqualifier, const ScreenCoordsXY& viewCoords, uint32_t occluded,
+        int32_t samplePoints);
+    // Drops the lights drawn in an area of the view, for when what is drawn there changes
+    void Invalidate(int32_t left, int32_t top, int32_t right, int32_t bottom);
+    void Clear();
+    void BeginFrame();
+    // Drops the lights that were not looked up since the frame began
+    void ForgetUnused();
+    size_t GetCount() const;
+};
+
+LightOcclusionCache& lightfx_get_occlusion_cache();
+void lightfx_invalidate_occlusion(int32_t left, int32_t top, int32_t right, int32_t bottom);
+void lightfx_invalidate_all_occlusion();
+
 void lightfx_apply_palette_filter(uint8_t i, uint8_t* r, uint8_t* g, uint8_t* b);
 void lightfx_render_to_texture(
     void* dstPixels, uint32_t dstPitch, uint8_t* bits, uint32_t width, uint32_t height, const uint32_t* palette,
     const uint32_t* lightPalette);
 
+/**
+ * Adds a light texture scaled by (1 + intensity) / 256 to the light buffer, saturating at 0xFF.
+ */
+void lightfx_add_light_scalar(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    uint8_t intensity);
+void lightfx_add_light_sse4_1(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    uint8_t intensity);
+void lightfx_add_light_avx2(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    uint8_t intensity);
+
+/**
+ * Mixes a line of pixels in the dark palette with the same pixels in the light palette by the light intensity of each.
+ */
+void lightfx_mix_line_scalar(
+    int32_t width, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT lightBits, uint32_t* RESTRICT dst,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette);
+void lightfx_mix_line_sse4_1(
+    int32_t width, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT lightBits, uint32_t* RESTRICT dst,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette);
+void lightfx_mix_line_avx2(
+    int32_t width, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT lightBits, uint32_t* RESTRICT dst,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette);
+
 #endif // __ENABLE_LIGHTFX__
 
 #endif
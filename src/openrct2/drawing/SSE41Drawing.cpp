@@ -10,9 +10,11 @@
 #include "../common.h"
 #include "../core/Guard.hpp"
 #include "Drawing.h"
+#include "LightFX.h"
 
 #ifdef __SSE4_1__
 
+#    include <cstring>
 #    include <immintrin.h>
 
 void mask_sse4_1(
@@ -56,6 +58,194 @@ void mask_sse4_1(
     }
 }
 
+namespace
+{
+    /**
+     * A palette split into its 16 entry parts, leaving out the parts that map each index to itself, so a remap only needs
+     * a shuffle for each part that changes something. Most remap palettes only change one or two parts.
+     */
+    struct PaletteShuffles128
+    {
+        __m128i Parts[16];
+        __m128i HighNibbles[16];
+        int32_t Count{};
+
+        explicit PaletteShuffles128(const uint8_t* palette)
+        {
+            const __m128i identity = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            for (int32_t i = 0; i < 16; i++)
+            {
+                const __m128i part = _mm_loadu_si128((const __m128i*)(palette + i * 16));
+                const __m128i identityPart = _mm_add_epi8(identity, _mm_set1_epi8((char)(i * 16)));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(part, identityPart)) != 0xFFFF)
+                {
+                    Parts[Count] = part;
+                    HighNibbles[Count] = _mm_set1_epi8((char)i);
+                    Count++;
+                }
+            }
+        }
+
+        __m128i Remap(__m128i pixels) const
+        {
+            const __m128i lowMask = _mm_set1_epi8(0x0F);
+            const __m128i low = _mm_and_si128(pixels, lowMask);
+            const __m128i high = _mm_and_si128(_mm_srli_epi16(pixels, 4), lowMask);
+            __m128i result = pixels;
+            for (int32_t i = 0; i < Count; i++)
+            {
+                const __m128i inPart = _mm_cmpeq_epi8(high, HighNibbles[i]);
+                result = _mm_blendv_epi8(result, _mm_shuffle_epi8(Parts[i], low), inPart);
+            }
+            return result;
+        }
+    };
+} // namespace
+
+template<BitmapBlitMode mode>
+static void bitmap_blit_sse4_1(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    const PaletteShuffles128* shuffles)
+{
+    const __m128i zero = {};
+    for (int32_t yy = 0; yy < height; yy++)
+    {
+        for (int32_t xx = 0; xx < width; xx += 16)
+        {
+            const __m128i source = _mm_loadu_si128((const __m128i*)(src + xx));
+            const __m128i dest = _mm_loadu_si128((const __m128i*)(dst + xx));
+            __m128i result;
+            if constexpr (mode == BitmapBlitMode::Copy)
+            {
+                result = _mm_blendv_epi8(source, dest, _mm_cmpeq_epi8(source, zero));
+            }
+            else if constexpr (mode == BitmapBlitMode::Remap)
+            {
+                const __m128i remapped = shuffles->Remap(source);
+                result = _mm_blendv_epi8(remapped, dest, _mm_cmpeq_epi8(remapped, zero));
+            }
+            else
+            {
+                result = _mm_blendv_epi8(shuffles->Remap(dest), dest, _mm_cmpeq_epi8(source, zero));
+            }
+            _mm_storeu_si128((__m128i*)(dst + xx), result);
+        }
+        src += srcStride;
+        dst += dstStride;
+    }
+}
+
+void bitmap_blit_sse4_1(
+    BitmapBlitMode mode, int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap,
+    int32_t dstWrap, const uint8_t* RESTRICT palette)
+{
+    // Whole vectors of each line are done here, what is left of each line by the scalar function
+    const int32_t simdWidth = width > 0 ? (width & ~15) : 0;
+    if (simdWidth != 0)
+    {
+        const int32_t srcStride = width + srcWrap;
+        const int32_t dstStride = width + dstWrap;
+        switch (mode)
+        {
+            case BitmapBlitMode::Copy:
+                bitmap_blit_sse4_1<BitmapBlitMode::Copy>(simdWidth, height, src, dst, srcStride, dstStride, nullptr);
+                break;
+            case BitmapBlitMode::Remap:
+            {
+                const PaletteShuffles128 shuffles(palette);
+                bitmap_blit_sse4_1<BitmapBlitMode::Remap>(simdWidth, height, src, dst, srcStride, dstStride, &shuffles);
+                break;
+            }
+            case BitmapBlitMode::Blend:
+            {
+                const PaletteShuffles128 shuffles(palette);
+                bitmap_blit_sse4_1<BitmapBlitMode::Blend>(simdWidth, height, src, dst, srcStride, dstStride, &shuffles);
+                break;
+            }
+        }
+    }
+    if (simdWidth != width)
+    {
+        bitmap_blit_scalar(
+            mode, width - simdWidth, height, src + simdWidth, dst + simdWidth, srcWrap + simdWidth, dstWrap + simdWidth,
+            palette);
+    }
+}
+
+#    ifdef __ENABLE_LIGHTFX__
+
+void lightfx_add_light_sse4_1(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    uint8_t intensity)
+{
+    const int32_t simdWidth = width > 0 ? (width & ~15) : 0;
+    if (simdWidth != 0)
+    {
+        const __m128i multiplier = _mm_set1_epi16(1 + intensity);
+        const uint8_t* srcLine = src;
+        uint8_t* dstLine = dst;
+        for (int32_t yy = 0; yy < height; yy++)
+        {
+            for (int32_t xx = 0; xx < simdWidth; xx += 16)
+            {
+                __m128i light = _mm_loadu_si128((const __m128i*)(srcLine + xx));
+                if (intensity != 0xFF)
+                {
+                    const __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_cvtepu8_epi16(light), multiplier), 8);
+                    const __m128i hi = _mm_srli_epi16(
+                        _mm_mullo_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(light, 8)), multiplier), 8);
+                    light = _mm_packus_epi16(lo, hi);
+                }
+                const __m128i dest = _mm_loadu_si128((const __m128i*)(dstLine + xx));
+                _mm_storeu_si128((__m128i*)(dstLine + xx), _mm_adds_epu8(dest, light));
+            }
+            srcLine += srcStride;
+            dstLine += dstStride;
+        }
+    }
+    if (simdWidth != width)
+    {
+        lightfx_add_light_scalar(width - simdWidth, height, src + simdWidth, dst + simdWidth, srcStride, dstStride, intensity);
+    }
+}
+
+void lightfx_mix_line_sse4_1(
+    int32_t width, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT lightBits, uint32_t* RESTRICT dst,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+{
+    const int32_t simdWidth = width > 0 ? (width & ~3) : 0;
+    const __m128i six = _mm_set1_epi16(6);
+    const __m128i spread = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+    for (int32_t xx = 0; xx < simdWidth; xx += 4)
+    {
+        const uint8_t* src = bits + xx;
+        const __m128i dark = _mm_setr_epi32(palette[src[0]], palette[src[1]], palette[src[2]], palette[src[3]]);
+        const __m128i light = _mm_setr_epi32(
+            lightPalette[src[0]], lightPalette[src[1]], lightPalette[src[2]], lightPalette[src[3]]);
+
+        // The intensity of each pixel for each of its channels, times 6
+        int32_t intensities;
+        std::memcpy(&intensities, lightBits + xx, sizeof(intensities));
+        const __m128i intensity = _mm_shuffle_epi8(_mm_cvtsi32_si128(intensities), spread);
+        const __m128i intensityLo = _mm_mullo_epi16(_mm_cvtepu8_epi16(intensity), six);
+        const __m128i intensityHi = _mm_mullo_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(intensity, 8)), six);
+
+        // (light * intensity) >> 8 is the high half of (light << 8) * intensity
+        const __m128i lightLo = _mm_slli_epi16(_mm_cvtepu8_epi16(light), 8);
+        const __m128i lightHi = _mm_slli_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(light, 8)), 8);
+        const __m128i lo = _mm_add_epi16(_mm_cvtepu8_epi16(dark), _mm_mulhi_epu16(lightLo, intensityLo));
+        const __m128i hi = _mm_add_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(dark, 8)), _mm_mulhi_epu16(lightHi, intensityHi));
+        _mm_storeu_si128((__m128i*)(dst + xx), _mm_packus_epi16(lo, hi));
+    }
+    if (simdWidth != width)
+    {
+        lightfx_mix_line_scalar(
+            width - simdWidth, bits + simdWidth, lightBits + simdWidth, dst + simdWidth, palette, lightPalette);
+    }
+}
+
+#    endif // __ENABLE_LIGHTFX__
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -69,4 +259,29 @@ void mask_sse4_1(
     openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
 }
 
+void bitmap_blit_sse4_1(
+    BitmapBlitMode mode, int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcWrap,
+    int32_t dstWrap, const uint8_t* RESTRICT palette)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+#    ifdef __ENABLE_LIGHTFX__
+
+void lightfx_add_light_sse4_1(
+    int32_t width, int32_t height, const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcStride, int32_t dstStride,
+    uint8_t intensity)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+void lightfx_mix_line_sse4_1(
+    int32_t width, const uint8_t* RESTRICT bits, const uint8_t* RESTRICT lightBits, uint32_t* RESTRICT dst,
+    const uint32_t* RESTRICT palette, const uint32_t* RESTRICT lightPalette)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+#    endif // __ENABLE_LIGHTFX__
+
 #endif // __SSE4_1__
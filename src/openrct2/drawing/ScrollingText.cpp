@@ -8,7 +8,9 @@
  *****************************************************************************/
 
 #include "../config/Config.h"
+#include "../core/LruCache.hpp"
 #include "../interface/Colour.h"
+#include "../interface/Viewport.h"
 #include "../localisation/Localisation.h"
 #include "../localisation/LocalisationService.h"
 #include "../paint/Paint.h"
@@ -17,7 +19,11 @@
 #include "TTF.h"
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 struct rct_draw_scroll_text
 {
@@ -30,17 +36,57 @@ struct rct_draw_scroll_text
     uint8_t bitmap[64 * 40];
 };
 
+/**
+ * One column of pixels of scrolling text, each bit is a row from the top.
+ */
+struct ScrollingTextColumn
+{
+    colour_t Colour;
+    uint8_t Pixels;
+    uint8_t BlendedPixels;
+};
+
+/**
+ * The columns of a text rendered once, which every scroll position and scrolling mode of the same text is drawn from.
+ * Columns past the width are how the text looks when it repeats, if that differs from the first time.
+ */
+struct ScrollingTextStrip
+{
+    uint32_t Width{};
+    std::vector<ScrollingTextColumn> Columns;
+};
+
 constexpr int32_t MAX_SCROLLING_TEXT_ENTRIES = 32;
+// Number of rendered texts cached
+constexpr size_t MAX_SCROLLING_TEXT_STRIPS = 1024;
+
+/**
+ * The scrolling texts drawn recently, each one the bitmap of a scrolling text sprite. Entries are reused from the oldest,
+ * so an entry set up while painting stays valid until as many other texts have been set up.
+ */
+struct ScrollingTextEntries
+{
+    rct_draw_scroll_text List[MAX_SCROLLING_TEXT_ENTRIES];
+    uint32_t NextIndex{};
+    // Sprites of entries owned by a thread, the shared entries use the g1 elements
+    rct_g1_element Elements[MAX_SCROLLING_TEXT_ENTRIES];
+    uint32_t Generation{};
+};
 
-static rct_draw_scroll_text _drawScrollTextList[MAX_SCROLLING_TEXT_ENTRIES];
+static ScrollingTextEntries _drawScrollText;
+// Threads painting views on their own, at the same time as other threads, have their own entries, so another thread
+// cannot reuse an entry before the view it was set up for is drawn
+static thread_local std::unique_ptr<ScrollingTextEntries> _threadDrawScrollText;
+// Bumped when all entries have to be set up again, including the ones of other threads
+static std::atomic<uint32_t> _scrollingTextGeneration;
 static uint8_t _characterBitmaps[FONT_SPRITE_GLYPH_COUNT + SPR_G2_GLYPH_COUNT][8];
-static uint32_t _drawSCrollNextIndex = 0;
 static std::mutex _scrollingTextMutex;
+static LruCache<std::string, ScrollingTextStrip> _scrollingTextStrips(MAX_SCROLLING_TEXT_STRIPS);
 
-static void scrolling_text_set_bitmap_for_sprite(
-    utf8* text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour);
-static void scrolling_text_set_bitmap_for_ttf(
-    utf8* text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour);
+static void scrolling_text_create_strip_for_sprite(const utf8* text, colour_t colour, ScrollingTextStrip& strip);
+static void scrolling_text_create_strip_for_ttf(utf8* text, colour_t colour, ScrollingTextStrip& strip);
+static void scrolling_text_draw_strip(
+    const ScrollingTextStrip& strip, uint16_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets);
 
 void scrolling_text_initialise_bitmaps()
 {
@@ -100,7 +146,7 @@ void scrolling_text_initialise_bitmaps()
         if (g1original != nullptr)
         {
             rct_g1_element g1 = *g1original;
-            g1.offset = _drawScrollTextList[i].bitmap;
+            g1.offset = _drawScrollText.List[i].bitmap;
             g1.width = 64;
             g1.height = 40;
             g1.offset[0] = 0xFF;
@@ -127,14 +173,61 @@ static uint8_t* font_sprite_get_codepoint_bitmap(int32_t codepoint)
     }
 }
 
+static ScrollingTextEntries& scrolling_text_get_entries()
+{
+    if (!gViewportPaintOnCallingThread)
+    {
+        return _drawScrollText;
+    }
+
+    if (_threadDrawScrollText == nullptr)
+    {
+        auto entries = std::make_unique<ScrollingTextEntries>();
+        for (int32_t i = 0; i < MAX_SCROLLING_TEXT_ENTRIES; i++)
+        {
+            const rct_g1_element* g1 = gfx_get_g1_element(SPR_SCROLLING_TEXT_START + i);
+            if (g1 != nullptr)
+            {
+                entries->Elements[i] = *g1;
+            }
+            entries->Elements[i].offset = entries->List[i].bitmap;
+        }
+        _threadDrawScrollText = std::move(entries);
+    }
+
+    auto& entries = *_threadDrawScrollText;
+    uint32_t generation = _scrollingTextGeneration;
+    if (entries.Generation != generation)
+    {
+        for (auto& scrollText : entries.List)
+        {
+            scrollText.string_id = 0;
+        }
+        entries.Generation = generation;
+    }
+    return entries;
+}
+
+/**
+ * Returns the sprite of a scrolling text entry of the calling thread, or nullptr if the thread uses the shared entries.
+ */
+const rct_g1_element* scrolling_text_get_thread_g1_element(int32_t imageId)
+{
+    if (_threadDrawScrollText == nullptr)
+    {
+        return nullptr;
+    }
+    return &_threadDrawScrollText->Elements[imageId - SPR_SCROLLING_TEXT_START];
+}
+
 static int32_t scrolling_text_get_matching_or_oldest(
-    rct_string_id stringId, uint16_t scroll, uint16_t scrollingMode, colour_t colour)
+    ScrollingTextEntries& entries, rct_string_id stringId, uint16_t scroll, uint16_t scrollingMode, colour_t colour)
 {
     uint32_t oldestId = 0xFFFFFFFF;
     int32_t scrollIndex = -1;
     for (int32_t i = 0; i < MAX_SCROLLING_TEXT_ENTRIES; i++)
     {
-        rct_draw_scroll_text* scrollText = &_drawScrollTextList[i];
+        rct_draw_scroll_text* scrollText = &entries.List[i];
         if (oldestId >= scrollText->id)
         {
             oldestId = scrollText->id;
@@ -146,7 +239,7 @@ static int32_t scrolling_text_get_matching_or_oldest(
             && std::memcmp(scrollText->string_args, gCommonFormatArgs, sizeof(scrollText->string_args)) == 0
             && scrollText->colour == colour && scrollText->position == scroll && scrollText->mode == scrollingMode)
         {
-            scrollText->id = _drawSCrollNextIndex;
+            scrollText->id = entries.NextIndex;
             return i + SPR_SCROLLING_TEXT_START;
         }
     }
@@ -1431,14 +1524,58 @@ static constexpr const int16_t* _scrollPositions[MAX_SCROLLING_TEXT_MODES] = {
 };
 // clang-format on
 
+/**
+ * Gets the text rendered in a colour, rendering it if it is not cached yet. The same text on any number of signs and
+ * banners is only rendered once, whatever its scroll position and scrolling mode.
+ */
+static const ScrollingTextStrip& scrolling_text_get_strip(utf8* text, colour_t colour)
+{
+    bool useTrueTypeFont = LocalisationService_UseTrueTypeFont();
+    std::string key = text;
+    key.push_back('\0');
+    key.push_back((char)colour);
+    key.push_back(useTrueTypeFont ? (gConfigFonts.enable_hinting ? 2 : 1) : 0);
+
+    auto cached = _scrollingTextStrips.Find(key);
+    if (cached != nullptr)
+    {
+        return *cached;
+    }
+
+    ScrollingTextStrip strip;
+    if (useTrueTypeFont)
+    {
+        scrolling_text_create_strip_for_ttf(text, colour, strip);
+    }
+    else
+    {
+        scrolling_text_create_strip_for_sprite(text, colour, strip);
+    }
+    return _scrollingTextStrips.Set(key, std::move(strip));
+}
+
+void scrolling_text_clear_strips()
+{
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+    _scrollingTextStrips.Clear();
+
+    // The sprites were drawn from the old strips
+    for (auto& scrollText : _drawScrollText.List)
+    {
+        scrollText.string_id = 0;
+    }
+    _scrollingTextGeneration++;
+}
+
 void scrolling_text_invalidate()
 {
     for (int32_t i = 0; i < MAX_SCROLLING_TEXT_ENTRIES; i++)
     {
-        rct_draw_scroll_text& scrollText = _drawScrollTextList[i];
+        rct_draw_scroll_text& scrollText = _drawScrollText.List[i];
         scrollText.string_id = 0;
         std::memset(scrollText.string_args, 0, sizeof(scrollText.string_args));
     }
+    _scrollingTextGeneration++;
 }
 
 int32_t scrolling_text_setup(
@@ -1453,20 +1590,21 @@ int32_t scrolling_text_setup(
     if (dpi->zoom_level != 0)
         return SPR_SCROLLING_TEXT_DEFAULT;
 
-    _drawSCrollNextIndex++;
+    auto& entries = scrolling_text_get_entries();
+    entries.NextIndex++;
 
-    int32_t scrollIndex = scrolling_text_get_matching_or_oldest(stringId, scroll, scrollingMode, colour);
+    int32_t scrollIndex = scrolling_text_get_matching_or_oldest(entries, stringId, scroll, scrollingMode, colour);
     if (scrollIndex >= SPR_SCROLLING_TEXT_START)
         return scrollIndex;
 
     // Setup scrolling text
-    auto scrollText = &_drawScrollTextList[scrollIndex];
+    auto scrollText = &entries.List[scrollIndex];
     scrollText->string_id = stringId;
     std::memcpy(scrollText->string_args, gCommonFormatArgs, sizeof(scrollText->string_args));
     scrollText->colour = colour;
     scrollText->position = scroll;
     scrollText->mode = scrollingMode;
-    scrollText->id = _drawSCrollNextIndex;
+    scrollText->id = entries.NextIndex;
 
     // Create the string to draw
     utf8 scrollString[256];
@@ -1475,92 +1613,72 @@ int32_t scrolling_text_setup(
     const int16_t* scrollingModePositions = _scrollPositions[scrollingMode];
 
     std::fill_n(scrollText->bitmap, 320 * 8, 0x00);
-    if (LocalisationService_UseTrueTypeFont())
-    {
-        scrolling_text_set_bitmap_for_ttf(scrollString, scroll, scrollText->bitmap, scrollingModePositions, colour);
-    }
-    else
-    {
-        scrolling_text_set_bitmap_for_sprite(scrollString, scroll, scrollText->bitmap, scrollingModePositions, colour);
-    }
+    const auto& strip = scrolling_text_get_strip(scrollString, colour);
+    scrolling_text_draw_strip(strip, scroll, scrollText->bitmap, scrollingModePositions);
 
     uint32_t imageId = SPR_SCROLLING_TEXT_START + scrollIndex;
     drawing_engine_invalidate_image(imageId);
     return imageId;
 }
 
-static void scrolling_text_set_bitmap_for_sprite(
-    utf8* text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour)
+static void scrolling_text_create_strip_for_sprite(const utf8* text, colour_t colour, ScrollingTextStrip& strip)
 {
+    // Colour codes carry over when the text loops back to the start, so the text is laid out twice: the second time
+    // is how every later repeat looks.
     auto characterColour = colour;
-
-    utf8* ch = text;
-    while (true)
+    for (int32_t pass = 0; pass < 2; pass++)
     {
-        uint32_t codepoint = utf8_get_next(ch, (const utf8**)&ch);
-
-        // If at the end of the string loop back to the start
-        if (codepoint == 0)
+        const utf8* ch = text;
+        uint32_t codepoint;
+        while ((codepoint = utf8_get_next(ch, &ch)) != 0)
         {
-            ch = text;
-            continue;
-        }
-
-        // Set any change in colour
-        if (codepoint <= FORMAT_COLOUR_CODE_END && codepoint >= FORMAT_COLOUR_CODE_START)
-        {
-            codepoint -= FORMAT_COLOUR_CODE_START;
-            const rct_g1_element* g1 = gfx_get_g1_element(SPR_TEXT_PALETTE);
-            if (g1 != nullptr)
+            // Set any change in colour
+            if (codepoint <= FORMAT_COLOUR_CODE_END && codepoint >= FORMAT_COLOUR_CODE_START)
             {
-                characterColour = g1->offset[codepoint * 4];
+                codepoint -= FORMAT_COLOUR_CODE_START;
+                const rct_g1_element* g1 = gfx_get_g1_element(SPR_TEXT_PALETTE);
+                if (g1 != nullptr)
+                {
+                    characterColour = g1->offset[codepoint * 4];
+                }
+                continue;
             }
-            continue;
-        }
 
-        // If another type of control character ignore
-        if (codepoint < 32)
-            continue;
-
-        int32_t characterWidth = font_sprite_get_codepoint_width(FONT_SPRITE_BASE_TINY, codepoint);
-        uint8_t* characterBitmap = font_sprite_get_codepoint_bitmap(codepoint);
-        for (; characterWidth != 0; characterWidth--, characterBitmap++)
-        {
-            // Skip any non-displayed columns
-            if (scroll != 0)
-            {
-                scroll--;
+            // If another type of control character ignore
+            if (codepoint < 32)
                 continue;
-            }
 
-            int16_t scrollPosition = *scrollPositionOffsets;
-            if (scrollPosition == -1)
-                return;
-            if (scrollPosition > -1)
+            int32_t characterWidth = font_sprite_get_codepoint_width(FONT_SPRITE_BASE_TINY, codepoint);
+            const uint8_t* characterBitmap = font_sprite_get_codepoint_bitmap(codepoint);
+            for (; characterWidth != 0; characterWidth--, characterBitmap++)
             {
-                uint8_t* dst = &bitmap[scrollPosition];
-                for (uint8_t char_bitmap = *characterBitmap; char_bitmap != 0; char_bitmap >>= 1)
-                {
-                    if (char_bitmap & 1)
-                        *dst = characterColour;
-
-                    // Jump to next row
-                    dst += 64;
-                }
+                strip.Columns.push_back({ characterColour, *characterBitmap, 0 });
             }
-            scrollPositionOffsets++;
+        }
+        if (pass == 0)
+        {
+            strip.Width = (uint32_t)strip.Columns.size();
         }
     }
+
+    // Only keep the repeat if a colour carried over changed it
+    auto first = strip.Columns.begin();
+    auto repeat = first + strip.Width;
+    if (std::equal(first, repeat, repeat, [](const ScrollingTextColumn& a, const ScrollingTextColumn& b) {
+            return a.Colour == b.Colour && a.Pixels == b.Pixels && a.BlendedPixels == b.BlendedPixels;
+        }))
+    {
+        strip.Columns.resize(strip.Width);
+    }
 }
 
-static void scrolling_text_set_bitmap_for_ttf(
-    utf8* text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour)
+static void scrolling_text_create_strip_for_ttf(utf8* text, colour_t colour, ScrollingTextStrip& strip)
 {
 #ifndef NO_TTF
     TTFFontDescriptor* fontDesc = ttf_get_font_from_sprite_base(FONT_SPRITE_BASE_TINY);
     if (fontDesc->font == nullptr)
     {
-        scrolling_text_set_bitmap_for_sprite(text, scroll, bitmap, scrollPositionOffsets, colour);
+        scrolling_text_create_strip_for_sprite(text, colour, strip);
         return;
     }
 
@@ -1588,7 +1706,7 @@ static void scrolling_text_set_bitmap_for_ttf(
     }
     *dstCh = 0;
 
-    TTFSurface* surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
+    auto surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
     if (surface == nullptr)
     {
         return;
@@ -1607,46 +1725,72 @@ static void scrolling_text_set_bitmap_for_ttf(
 
     bool use_hinting = gConfigFonts.enable_hinting && fontDesc->hinting_threshold > 0;
 
-    for (int32_t x = 0;; x++)
+    strip.Columns.resize(width);
+    strip.Width = width;
+    for (int32_t x = 0; x < width; x++)
     {
-        if (x >= width)
-            x = 0;
-
-        // Skip any non-displayed columns
-        if (scroll == 0)
+        auto& column = strip.Columns[x];
+        column.Colour = colour;
+        for (int32_t y = min_vpos; y < max_vpos; y++)
         {
-            int16_t scrollPosition = *scrollPositionOffsets;
-            if (scrollPosition == -1)
-                return;
-
-            if (scrollPosition > -1)
+            uint8_t row = 1 << (y - min_vpos);
+            uint8_t src_pixel = src[y * pitch + x];
+            if ((!use_hinting && src_pixel != 0) || src_pixel > 140)
+            {
+                // Centre of the glyph: use full colour.
+                column.Pixels |= row;
+            }
+            else if (use_hinting && src_pixel > fontDesc->hinting_threshold)
             {
-                uint8_t* dst = &bitmap[scrollPosition];
+                // Simulate font hinting by shading the background colour instead.
+                column.BlendedPixels |= row;
+            }
+        }
+    }
+#endif // NO_TTF
+}
 
-                for (int32_t y = min_vpos; y < max_vpos; y++)
-                {
-                    uint8_t src_pixel = src[y * pitch + x];
-                    if ((!use_hinting && src_pixel != 0) || src_pixel > 140)
-                    {
-                        // Centre of the glyph: use full colour.
-                        *dst = colour;
-                    }
-                    else if (use_hinting && src_pixel > fontDesc->hinting_threshold)
-                    {
-                        // Simulate font hinting by shading the background colour instead.
-                        *dst = blendColours(colour, *dst);
-                    }
+/**
+ * Draws the columns of a strip starting at the scroll position, one at each position the scrolling mode moves the text
+ * through.
+ */
+static void scrolling_text_draw_strip(
+    const ScrollingTextStrip& strip, uint16_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets)
+{
+    if (strip.Width == 0)
+        return;
 
-                    // Jump to next row
-                    dst += 64;
-                }
+    const uint32_t repeatWidth = (uint32_t)strip.Columns.size() - strip.Width;
+    uint32_t columnIndex = scroll;
+    if (columnIndex >= strip.Width)
+    {
+        columnIndex = repeatWidth != 0 ? strip.Width + (columnIndex - strip.Width) % repeatWidth : columnIndex % strip.Width;
+    }
+
+    for (; *scrollPositionOffsets != -1; scrollPositionOffsets++)
+    {
+        int16_t scrollPosition = *scrollPositionOffsets;
+        if (scrollPosition > -1)
+        {
+            const auto& column = strip.Columns[columnIndex];
+            uint8_t* dst = &bitmap[scrollPosition];
+            for (uint8_t pixels = column.Pixels | column.BlendedPixels, row = 1; pixels != 0; pixels &= ~row, row <<= 1)
+            {
+                if (column.Pixels & row)
+                    *dst = column.Colour;
+                else if (column.BlendedPixels & row)
+                    *dst = blendColours(column.Colour, *dst);
+
+                // Jump to next row
+                dst += 64;
             }
-            scrollPositionOffsets++;
         }
-        else
+
+        // If at the end of the text loop back to the start
+        columnIndex++;
+        if (columnIndex == strip.Columns.size())
         {
-            scroll--;
+            columnIndex = repeatWidth != 0 ? strip.Width : 0;
         }
     }
-#endif // NO_TTF
 }
@@ -0,0 +1,223 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "SpriteMipCache.h"
+
+#include "../core/LruCache.hpp"
+#include "../sprites.h"
+
+#include <mutex>
+
+// Total size of the cached sprite copies
+static constexpr size_t MAX_SPRITE_MIP_CACHE_SIZE = 32 * 1024 * 1024;
+// Accounted for each copy on top of its pixel data
+static constexpr size_t SPRITE_MIP_OVERHEAD = 64;
+
+struct SpriteMipCacheEntry
+{
+    // The sprite the copy was made from, so a copy of a replaced sprite is not used
+    const uint8_t* Source{};
+    int16_t SourceWidth{};
+    int16_t SourceHeight{};
+    std::shared_ptr<const SpriteMip> Mip;
+};
+
+static std::mutex _mipCacheMutex;
+static LruCache<uint64_t, SpriteMipCacheEntry> _mipCache(MAX_SPRITE_MIP_CACHE_SIZE);
+
+static uint64_t sprite_mip_get_key(uint32_t imageIndex, int32_t zoomLevel, int32_t phase)
+{
+    return ((uint64_t)imageIndex << 5) | ((uint64_t)zoomLevel << 3) | (uint64_t)phase;
+}
+
+static size_t sprite_mip_get_size(const SpriteMip& mip)
+{
+    return mip.Data.size() + SPRITE_MIP_OVERHEAD;
+}
+
+static bool sprite_mip_is_cacheable(uint32_t imageIndex)
+{
+    // The pixels of these images are changed without replacing the image
+    if (imageIndex == SPR_TEMP)
+        return false;
+    if (imageIndex >= SPR_SCROLLING_TEXT_START && imageIndex < SPR_SCROLLING_TEXT_END)
+        return false;
+    return true;
+}
+
+/**
+ * Copies every (1 << zoomLevel)th pixel of every (1 << zoomLevel)th row of a bitmap sprite, as those are the only ones
+ * drawn at the zoom level.
+ */
+static std::unique_ptr<SpriteMip> sprite_mip_create_bmp(const rct_g1_element& g1, int32_t zoomLevel)
+{
+    const int32_t zoomAmount = 1 << zoomLevel;
+    const int32_t width = (g1.width + zoomAmount - 1) >> zoomLevel;
+    const int32_t height = (g1.height + zoomAmount - 1) >> zoomLevel;
+
+    auto mip = std::make_unique<SpriteMip>();
+    mip->Data.resize((size_t)width * height);
+    auto dst = mip->Data.data();
+    for (int32_t y = 0; y < height; y++)
+    {
+        const uint8_t* src = g1.offset + (size_t)g1.width * (y << zoomLevel);
+        for (int32_t x = 0; x < width; x++)
+        {
+            *dst++ = src[x << zoomLevel];
+        }
+    }
+
+    mip->Element.offset = mip->Data.data();
+    mip->Element.width = width;
+    mip->Element.height = height;
+    mip->Element.flags = g1.flags & G1_FLAG_BMP;
+    return mip;
+}
+
+/**
+ * Copies the pixels of an RLE sprite drawn at a zoom level into a new RLE sprite. Those are the pixels of every
+ * (1 << zoomLevel)th column and of every (1 << zoomLevel)th row starting with the phase.
+ */
+static std::unique_ptr<SpriteMip> sprite_mip_create_rle(const rct_g1_element& g1, int32_t zoomLevel, int32_t phase)
+{
+    const int32_t zoomAmount = 1 << zoomLevel;
+    const int32_t width = (g1.width + zoomAmount - 1) >> zoomLevel;
+    const int32_t height = phase < g1.height ? (g1.height - phase + zoomAmount - 1) >> zoomLevel : 0;
+
+    auto mip = std::make_unique<SpriteMip>();
+    auto& data = mip->Data;
+    data.resize((size_t)height * 2);
+    for (int32_t y = 0; y < height; y++)
+    {
+        // Each line starts with a list of offsets to its data
+        const size_t lineOffset = data.size();
+        if (lineOffset > UINT16_MAX)
+        {
+            return nullptr;
+        }
+        data[y * 2] = lineOffset & 0xFF;
+        data[y * 2 + 1] = (lineOffset >> 8) & 0xFF;
+
+        const int32_t sourceY = phase + (y << zoomLevel);
+        const uint8_t* lineData = g1.offset + (g1.offset[sourceY * 2] | (g1.offset[sourceY * 2 + 1] << 8));
+        size_t lastChunk = SIZE_MAX;
+        uint8_t isEndOfLine = 0;
+        while (!isEndOfLine)
+        {
+            uint8_t dataSize = *lineData++;
+            uint8_t firstPixelX = *lineData++;
+            const uint8_t* pixels = lineData;
+            isEndOfLine = dataSize & 0x80;
+            dataSize &= 0x7F;
+            lineData += dataSize;
+
+            // Only keep the pixels in columns drawn at the zoom level
+            int32_t firstX = (firstPixelX + zoomAmount - 1) >> zoomLevel;
+            int32_t endX = (firstPixelX + dataSize + zoomAmount - 1) >> zoomLevel;
+            if (firstX >= endX)
+            {
+                continue;
+            }
+
+            lastChunk = data.size();
+            data.push_back((uint8_t)(endX - firstX));
+            data.push_back((uint8_t)firstX);
+            for (int32_t x = firstX; x < endX; x++)
+            {
+                data.push_back(pixels[(x << zoomLevel) - firstPixelX]);
+            }
+        }
+
+        if (lastChunk == SIZE_MAX)
+        {
+            // Empty line
+            lastChunk = data.size();
+            data.push_back(0);
+            data.push_back(0);
+        }
+        data[lastChunk] |= 0x80;
+    }
+
+    mip->Element.offset = data.data();
+    mip->Element.width = width;
+    mip->Element.height = height;
+    mip->Element.flags = G1_FLAG_RLE_COMPRESSION;
+    return mip;
+}
+
+static bool sprite_mip_is_from(const SpriteMipCacheEntry& entry, const rct_g1_element& g1)
+{
+    return entry.Source == g1.offset && entry.SourceWidth == g1.width && entry.SourceHeight == g1.height;
+}
+
+std::shared_ptr<const SpriteMip> sprite_mip_get(uint32_t imageIndex, const rct_g1_element& g1, int32_t zoomLevel, int32_t phase)
+{
+    if (zoomLevel <= 0 || zoomLevel > 3 || phase < 0 || phase >= (1 << zoomLevel) || g1.offset == nullptr
+        || !sprite_mip_is_cacheable(imageIndex))
+    {
+        return nullptr;
+    }
+
+    auto key = sprite_mip_get_key(imageIndex, zoomLevel, phase);
+    {
+        std::lock_guard<std::mutex> lock(_mipCacheMutex);
+        auto entry = _mipCache.Find(key);
+        if (entry != nullptr && sprite_mip_is_from(*entry, g1))
+        {
+            return entry->Mip;
+        }
+    }
+
+    // The copy is made without holding the lock, another thread may add the same one meanwhile
+    std::unique_ptr<SpriteMip> mip;
+    if (g1.flags & G1_FLAG_RLE_COMPRESSION)
+    {
+        mip = sprite_mip_create_rle(g1, zoomLevel, phase);
+    }
+    else
+    {
+        mip = sprite_mip_create_bmp(g1, zoomLevel);
+    }
+    if (mip == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Copies still being drawn are kept alive by their shared pointer when dropped
+    std::lock_guard<std::mutex> lock(_mipCacheMutex);
+    auto entry = _mipCache.Find(key);
+    if (entry != nullptr && sprite_mip_is_from(*entry, g1))
+    {
+        return entry->Mip;
+    }
+    size_t size = sprite_mip_get_size(*mip);
+    return _mipCache.Set(key, { g1.offset, g1.width, g1.height, std::move(mip) }, size).Mip;
+}
+
+void sprite_mip_invalidate(uint32_t imageIndex)
+{
+    std::lock_guard<std::mutex> lock(_mipCacheMutex);
+    if (_mipCache.GetCount() == 0)
+    {
+        return;
+    }
+    for (int32_t zoomLevel = 1; zoomLevel <= 3; zoomLevel++)
+    {
+        for (int32_t phase = 0; phase < (1 << zoomLevel); phase++)
+        {
+            _mipCache.Remove(sprite_mip_get_key(imageIndex, zoomLevel, phase));
+        }
+    }
+}
+
+void sprite_mip_clear()
+{
+    std::lock_guard<std::mutex> lock(_mipCacheMutex);
+    _mipCache.Clear();
+}
@@ -0,0 +1,35 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "Drawing.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * A copy of a sprite with only the pixels that are drawn at a zoom level, in the same format as the sprite so it can be
+ * drawn unzoomed instead of skipping over the other pixels.
+ */
+struct SpriteMip
+{
+    rct_g1_element Element{};
+    std::vector<uint8_t> Data;
+};
+
+/**
+ * Gets the copy of a sprite for a zoom level, creating it if it is not cached yet. Which rows of an RLE sprite are drawn
+ * depends on where it is drawn, the phase picks them. Returns nullptr for sprites that can not be copied.
+ */
+std::shared_ptr<const SpriteMip> sprite_mip_get(
+    uint32_t imageIndex, const rct_g1_element& g1, int32_t zoomLevel, int32_t phase);
+void sprite_mip_invalidate(uint32_t imageIndex);
+void sprite_mip_clear();
@@ -9,8 +9,12 @@
 
 #ifndef NO_TTF
 
+#    include <array>
 #    include <atomic>
+#    include <cstring>
+#    include <memory>
 #    include <mutex>
+#    include <string>
 #    pragma clang diagnostic push
 #    pragma clang diagnostic ignored "-Wdocumentation"
 #    include <ft2build.h>
@@ -19,50 +23,119 @@
 
 #    include "../OpenRCT2.h"
 #    include "../config/Config.h"
+#    include "../core/Hash.hpp"
+#    include "../core/LruCache.hpp"
 #    include "../localisation/Localisation.h"
 #    include "../localisation/LocalisationService.h"
 #    include "../platform/platform.h"
+#    include "Drawing.h"
 #    include "TTF.h"
 
 static bool _ttfInitialised = false;
 
-#    define TTF_SURFACE_CACHE_SIZE 256
-#    define TTF_GETWIDTH_CACHE_SIZE 1024
+#    define TTF_SURFACE_CACHE_SIZE 1024
+#    define TTF_GETWIDTH_CACHE_SIZE 4096
+#    define TTF_CACHE_SHARD_COUNT 8
 
-struct ttf_cache_entry
+/**
+ * Caches a value for each string of a font. The strings are spread over shards with their own lock, so paint threads
+ * looking up different strings rarely wait on each other.
+ *
+ * Text images are cached per string on top of the glyph cache of each font, rather than drawn glyph by glyph. A missed
+ * string is composed from the cached glyph bitmaps by the render functions of the font, which apply the kerning between
+ * each pair of glyphs. The outline and inset effects then sample the pixels around each pixel of the whole image, which
+ * reach across the edges of the glyphs.
+ */
+template<typename T, size_t TCapacity> class TTFStringCache
 {
-    TTFSurface* surface;
-    TTF_Font* font;
-    utf8* text;
-    uint32_t lastUseTick;
-};
+private:
+    // The hash is the key, the font and text tell apart strings with the same hash
+    struct Entry
+    {
+        TTF_Font* Font;
+        std::string Text;
+        T Value;
+    };
 
-struct ttf_getwidth_cache_entry
-{
-    uint32_t width;
-    TTF_Font* font;
-    utf8* text;
-    uint32_t lastUseTick;
-};
+    struct Shard
+    {
+        std::mutex Mutex;
+        LruCache<uint64_t, Entry> Entries{ TCapacity / TTF_CACHE_SHARD_COUNT };
+    };
 
-static ttf_cache_entry _ttfSurfaceCache[TTF_SURFACE_CACHE_SIZE] = {};
-static int32_t _ttfSurfaceCacheCount = 0;
-static int32_t _ttfSurfaceCacheHitCount = 0;
-static int32_t _ttfSurfaceCacheMissCount = 0;
+    std::array<Shard, TTF_CACHE_SHARD_COUNT> _shards;
+    std::atomic<uint64_t> _hits{};
+    std::atomic<uint64_t> _misses{};
+
+public:
+    bool TryGet(uint64_t hash, TTF_Font* font, const utf8* text, T& outValue)
+    {
+        auto& shard = GetShard(hash);
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        auto entry = shard.Entries.Find(hash);
+        if (entry != nullptr && entry->Font == font && entry->Text == text)
+        {
+            outValue = entry->Value;
+            _hits++;
+            return true;
+        }
+        _misses++;
+        return false;
+    }
 
-static ttf_getwidth_cache_entry _ttfGetWidthCache[TTF_GETWIDTH_CACHE_SIZE] = {};
-static int32_t _ttfGetWidthCacheCount = 0;
-static int32_t _ttfGetWidthCacheHitCount = 0;
-static int32_t _ttfGetWidthCacheMissCount = 0;
+    void Set(uint64_t hash, TTF_Font* font, const utf8* text, const T& value)
+    {
+        auto& shard = GetShard(hash);
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        shard.Entries.Set(hash, { font, text, value });
+    }
+
+    void Clear()
+    {
+        for (auto& shard : _shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            shard.Entries.Clear();
+        }
+    }
+
+    uint64_t GetHits() const
+    {
+        return _hits;
+    }
+
+    uint64_t GetMisses() const
+    {
+        return _misses;
+    }
+
+    size_t GetCount()
+    {
+        size_t count = 0;
+        for (auto& shard : _shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            count += shard.Entries.GetCount();
+        }
+        return count;
+    }
+
+private:
+    Shard& GetShard(uint64_t hash)
+    {
+        // The low bits pick the bucket within the shard
+        return _shards[(hash >> 32) % TTF_CACHE_SHARD_COUNT];
+    }
+};
+
+static TTFStringCache<std::shared_ptr<const TTFSurface>, TTF_SURFACE_CACHE_SIZE> _ttfSurfaceCache;
+static TTFStringCache<uint32_t, TTF_GETWIDTH_CACHE_SIZE> _ttfGetWidthCache;
 
 static std::mutex _mutex;
 
 static TTF_Font* ttf_open_font(const utf8* fontPath, int32_t ptSize);
 static void ttf_close_font(TTF_Font* font);
-static uint32_t ttf_surface_cache_hash(TTF_Font* font, const utf8* text);
-static void ttf_surface_cache_dispose(ttf_cache_entry* entry);
-static void ttf_surface_cache_dispose_all();
-static void ttf_getwidth_cache_dispose_all();
+static uint64_t ttf_cache_hash(TTF_Font* font, const utf8* text);
 static bool ttf_get_size(TTF_Font* font, const utf8* text, int32_t* width, int32_t* height);
 static void ttf_toggle_hinting(bool);
 static TTFSurface* ttf_render(TTF_Font* font, const utf8* text);
@@ -101,74 +174,82 @@ static void ttf_toggle_hinting(bool)
         TTF_SetFontHinting(fontDesc->font, use_hinting ? 1 : 0);
     }
 
-    if (_ttfSurfaceCacheCount)
-    {
-        ttf_surface_cache_dispose_all();
-    }
+    _ttfSurfaceCache.Clear();
+    _ttfGetWidthCache.Clear();
 }
 
 bool ttf_initialise()
 {
-    FontLockHelper<std::mutex> lock(_mutex);
-
-    if (_ttfInitialised)
-        return true;
-
-    if (TTF_Init() != 0)
     {
-        log_error("Couldn't initialise FreeType engine");
-        return false;
-    }
+        FontLockHelper<std::mutex> lock(_mutex);
 
-    for (int32_t i = 0; i < FONT_SIZE_COUNT; i++)
-    {
-        TTFFontDescriptor* fontDesc = &(gCurrentTTFFontSet->size[i]);
+        if (_ttfInitialised)
+            return true;
 
-        utf8 fontPath[MAX_PATH];
-        if (!platform_get_font_path(fontDesc, fontPath, sizeof(fontPath)))
+        if (TTF_Init() != 0)
         {
-            log_verbose("Unable to load font '%s'", fontDesc->font_name);
+            log_error("Couldn't initialise FreeType engine");
             return false;
         }
 
-        fontDesc->font = ttf_open_font(fontPath, fontDesc->ptSize);
-        if (fontDesc->font == nullptr)
+        for (int32_t i = 0; i < FONT_SIZE_COUNT; i++)
         {
-            log_verbose("Unable to load '%s'", fontPath);
-            return false;
+            TTFFontDescriptor* fontDesc = &(gCurrentTTFFontSet->size[i]);
+
+            utf8 fontPath[MAX_PATH];
+            if (!platform_get_font_path(fontDesc, fontPath, sizeof(fontPath)))
+            {
+                log_verbose("Unable to load font '%s'", fontDesc->font_name);
+                return false;
+            }
+
+            fontDesc->font = ttf_open_font(fontPath, fontDesc->ptSize);
+            if (fontDesc->font == nullptr)
+            {
+                log_verbose("Unable to load '%s'", fontPath);
+                return false;
+            }
         }
-    }
 
-    ttf_toggle_hinting(true);
+        ttf_toggle_hinting(true);
 
-    _ttfInitialised = true;
+        _ttfInitialised = true;
+    }
+
+    // Not while holding the font lock: this takes the scrolling text lock, which is held while setting up scrolling
+    // text takes the font lock
+    gfx_invalidate_text_layouts();
 
     return true;
 }
 
 void ttf_dispose()
 {
-    FontLockHelper<std::mutex> lock(_mutex);
+    {
+        FontLockHelper<std::mutex> lock(_mutex);
 
-    if (!_ttfInitialised)
-        return;
+        if (!_ttfInitialised)
+            return;
 
-    ttf_surface_cache_dispose_all();
-    ttf_getwidth_cache_dispose_all();
+        _ttfSurfaceCache.Clear();
+        _ttfGetWidthCache.Clear();
 
-    for (int32_t i = 0; i < FONT_SIZE_COUNT; i++)
-    {
-        TTFFontDescriptor* fontDesc = &(gCurrentTTFFontSet->size[i]);
-        if (fontDesc->font != nullptr)
+        for (int32_t i = 0; i < FONT_SIZE_COUNT; i++)
         {
-            ttf_close_font(fontDesc->font);
-            fontDesc->font = nullptr;
+            TTFFontDescriptor* fontDesc = &(gCurrentTTFFontSet->size[i]);
+            if (fontDesc->font != nullptr)
+            {
+                ttf_close_font(fontDesc->font);
+                fontDesc->font = nullptr;
+            }
         }
-    }
 
-    TTF_Quit();
+        TTF_Quit();
+
+        _ttfInitialised = false;
+    }
 
-    _ttfInitialised = false;
+    gfx_invalidate_text_layouts();
 }
 
 static TTF_Font* ttf_open_font(const utf8* fontPath, int32_t ptSize)
@@ -181,169 +262,91 @@ static void ttf_close_font(TTF_Font* font)
     TTF_CloseFont(font);
 }
 
-static uint32_t ttf_surface_cache_hash(TTF_Font* font, const utf8* text)
+static uint64_t ttf_cache_hash(TTF_Font* font, const utf8* text)
 {
-    uint32_t hash = (uint32_t)((((uintptr_t)font * 23) ^ 0xAAAAAAAA) & 0xFFFFFFFF);
-    for (const utf8* ch = text; *ch != 0; ch++)
-    {
-        hash = ror32(hash, 3) ^ (*ch * 13);
-    }
-    return hash;
+    return Hash::Fnv1a(text, std::strlen(text), Hash::Fnv1aOffsetBasis ^ (uint64_t)(uintptr_t)font);
 }
 
-static void ttf_surface_cache_dispose(ttf_cache_entry* entry)
+void ttf_toggle_hinting()
 {
-    if (entry->surface != nullptr)
     {
-        ttf_free_surface(entry->surface);
-        free(entry->text);
-
-        entry->surface = nullptr;
-        entry->font = nullptr;
-        entry->text = nullptr;
+        FontLockHelper<std::mutex> lock(_mutex);
+        ttf_toggle_hinting(true);
     }
+
+    gfx_invalidate_text_layouts();
 }
 
-static void ttf_surface_cache_dispose_all()
+std::shared_ptr<const TTFSurface> ttf_surface_cache_get_or_add(TTF_Font* font, const utf8* text)
 {
-    for (int32_t i = 0; i < TTF_SURFACE_CACHE_SIZE; i++)
+    uint64_t hash = ttf_cache_hash(font, text);
+    std::shared_ptr<const TTFSurface> surface;
+    if (_ttfSurfaceCache.TryGet(hash, font, text, surface))
     {
-        ttf_surface_cache_dispose(&_ttfSurfaceCache[i]);
-        _ttfSurfaceCacheCount--;
+        return surface;
     }
-}
 
-void ttf_toggle_hinting()
-{
-    FontLockHelper<std::mutex> lock(_mutex);
-    ttf_toggle_hinting(true);
-}
-
-TTFSurface* ttf_surface_cache_get_or_add(TTF_Font* font, const utf8* text)
-{
-    ttf_cache_entry* entry;
-
-    uint32_t hash = ttf_surface_cache_hash(font, text);
-    int32_t index = hash % TTF_SURFACE_CACHE_SIZE;
-
-    FontLockHelper<std::mutex> lock(_mutex);
-
-    for (int32_t i = 0; i < TTF_SURFACE_CACHE_SIZE; i++)
     {
-        entry = &_ttfSurfaceCache[index];
-
-        // Check if entry is a hit
-        if (entry->surface == nullptr)
-            break;
-        if (entry->font == font && strcmp(entry->text, text) == 0)
+        FontLockHelper<std::mutex> lock(_mutex);
+        TTFSurface* rendered = ttf_render(font, text);
+        if (rendered == nullptr)
         {
-            _ttfSurfaceCacheHitCount++;
-            entry->lastUseTick = gCurrentDrawCount;
-            return entry->surface;
+            return nullptr;
         }
-
-        // If entry hasn't been used for a while, replace it
-        if (entry->lastUseTick < gCurrentDrawCount - 64)
-        {
-            break;
-        }
-
-        // Check if next entry is a hit
-        if (++index >= TTF_SURFACE_CACHE_SIZE)
-            index = 0;
+        // Kept alive while it is drawn even if it is dropped from the cache
+        surface = std::shared_ptr<const TTFSurface>(rendered, [](const TTFSurface* s) { ttf_free_surface((TTFSurface*)s); });
     }
-
-    // Cache miss, replace entry with new surface
-    entry = &_ttfSurfaceCache[index];
-    ttf_surface_cache_dispose(entry);
-
-    TTFSurface* surface = ttf_render(font, text);
-    if (surface == nullptr)
-    {
-        return nullptr;
-    }
-
-    _ttfSurfaceCacheMissCount++;
-    // printf("CACHE HITS: %d   MISSES: %d)\n", _ttfSurfaceCacheHitCount, _ttfSurfaceCacheMissCount);
-
-    _ttfSurfaceCacheCount++;
-    entry->surface = surface;
-    entry->font = font;
-    entry->text = _strdup(text);
-    entry->lastUseTick = gCurrentDrawCount;
-    return entry->surface;
+    _ttfSurfaceCache.Set(hash, font, text, surface);
+    return surface;
 }
 
-static void ttf_getwidth_cache_dispose(ttf_getwidth_cache_entry* entry)
+uint32_t ttf_getwidth_cache_get_or_add(TTF_Font* font, const utf8* text)
 {
-    if (entry->text != nullptr)
+    uint64_t hash = ttf_cache_hash(font, text);
+    uint32_t width;
+    if (_ttfGetWidthCache.TryGet(hash, font, text, width))
     {
-        free(entry->text);
-
-        entry->width = 0;
-        entry->font = nullptr;
-        entry->text = nullptr;
+        return width;
     }
-}
 
-static void ttf_getwidth_cache_dispose_all()
-{
-    for (int32_t i = 0; i < TTF_GETWIDTH_CACHE_SIZE; i++)
     {
-        ttf_getwidth_cache_dispose(&_ttfGetWidthCache[i]);
-        _ttfGetWidthCacheCount--;
+        FontLockHelper<std::mutex> lock(_mutex);
+        int32_t measuredWidth, height;
+        ttf_get_size(font, text, &measuredWidth, &height);
+        width = measuredWidth;
     }
+    _ttfGetWidthCache.Set(hash, font, text, width);
+    return width;
 }
 
-uint32_t ttf_getwidth_cache_get_or_add(TTF_Font* font, const utf8* text)
+TTFCacheStats ttf_get_cache_stats()
 {
-    ttf_getwidth_cache_entry* entry;
-
-    uint32_t hash = ttf_surface_cache_hash(font, text);
-    int32_t index = hash % TTF_GETWIDTH_CACHE_SIZE;
+    TTFCacheStats stats;
+    stats.SurfaceHits = _ttfSurfaceCache.GetHits();
+    stats.SurfaceMisses = _ttfSurfaceCache.GetMisses();
+    stats.SurfaceCount = _ttfSurfaceCache.GetCount();
+    stats.WidthHits = _ttfGetWidthCache.GetHits();
+    stats.WidthMisses = _ttfGetWidthCache.GetMisses();
+    stats.WidthCount = _ttfGetWidthCache.GetCount();
 
     FontLockHelper<std::mutex> lock(_mutex);
-
-    for (int32_t i = 0; i < TTF_GETWIDTH_CACHE_SIZE; i++)
+    if (_ttfInitialised)
     {
-        entry = &_ttfGetWidthCache[index];
-
-        // Check if entry is a hit
-        if (entry->text == nullptr)
-            break;
-        if (entry->font == font && strcmp(entry->text, text) == 0)
+        for (int32_t i = 0; i < FONT_SIZE_COUNT; i++)
         {
-            _ttfGetWidthCacheHitCount++;
-            entry->lastUseTick = gCurrentDrawCount;
-            return entry->width;
+            const TTF_Font* font = gCurrentTTFFontSet->size[i].font;
+            if (font != nullptr)
+            {
+                uint64_t hits, misses;
+                size_t count;
+                TTF_GetGlyphCacheStats(font, &hits, &misses, &count);
+                stats.GlyphHits += hits;
+                stats.GlyphMisses += misses;
+                stats.GlyphCount += count;
+            }
         }
-
-        // If entry hasn't been used for a while, replace it
-        if (entry->lastUseTick < gCurrentDrawCount - 64)
-        {
-            break;
-        }
-
-        // Check if next entry is a hit
-        if (++index >= TTF_GETWIDTH_CACHE_SIZE)
-            index = 0;
     }
-
-    // Cache miss, replace entry with new width
-    entry = &_ttfGetWidthCache[index];
-    ttf_getwidth_cache_dispose(entry);
-
-    int32_t width, height;
-    ttf_get_size(font, text, &width, &height);
-
-    _ttfGetWidthCacheMissCount++;
-
-    _ttfGetWidthCacheCount++;
-    entry->width = width;
-    entry->font = font;
-    entry->text = _strdup(text);
-    entry->lastUseTick = gCurrentDrawCount;
-    return entry->width;
+    return stats;
 }
 
 TTFFontDescriptor* ttf_get_font_from_sprite_base(uint16_t spriteBase)
@@ -11,6 +11,8 @@
 
 #include "Font.h"
 
+#include <memory>
+
 bool ttf_initialise();
 void ttf_dispose();
 
@@ -24,10 +26,24 @@ struct TTFSurface
     int32_t pitch;
 };
 
+struct TTFCacheStats
+{
+    uint64_t SurfaceHits{};
+    uint64_t SurfaceMisses{};
+    size_t SurfaceCount{};
+    uint64_t WidthHits{};
+    uint64_t WidthMisses{};
+    size_t WidthCount{};
+    uint64_t GlyphHits{};
+    uint64_t GlyphMisses{};
+    size_t GlyphCount{};
+};
+
 TTFFontDescriptor* ttf_get_font_from_sprite_base(uint16_t spriteBase);
 void ttf_toggle_hinting();
-TTFSurface* ttf_surface_cache_get_or_add(TTF_Font* font, const utf8* text);
+std::shared_ptr<const TTFSurface> ttf_surface_cache_get_or_add(TTF_Font* font, const utf8* text);
 uint32_t ttf_getwidth_cache_get_or_add(TTF_Font* font, const utf8* text);
+TTFCacheStats ttf_get_cache_stats();
 bool ttf_provides_glyph(const TTF_Font* font, codepoint_t codepoint);
 void ttf_free_surface(TTFSurface* surface);
 
@@ -35,6 +51,7 @@ void ttf_free_surface(TTFSurface* surface);
 int TTF_Init(void);
 TTF_Font* TTF_OpenFont(const char* file, int ptsize);
 int TTF_GlyphIsProvided(const TTF_Font* font, codepoint_t ch);
+void TTF_GetGlyphCacheStats(const TTF_Font* font, uint64_t* hits, uint64_t* misses, size_t* count);
 int TTF_SizeUTF8(TTF_Font* font, const char* text, int* w, int* h);
 TTFSurface* TTF_RenderUTF8_Solid(TTF_Font* font, const char* text, uint32_t colour);
 TTFSurface* TTF_RenderUTF8_Shaded(TTF_Font* font, const char* text, uint32_t fg, uint32_t bg);
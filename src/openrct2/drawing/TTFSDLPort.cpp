@@ -30,6 +30,7 @@ misrepresented as being the original software.
 #    include <algorithm>
 #    include <cmath>
 #    include <cstring>
+#    include <memory>
 #    include <stdio.h>
 #    include <stdlib.h>
 #    include <string.h>
@@ -44,6 +45,7 @@ misrepresented as being the original software.
 #    include FT_TRUETYPE_IDS_H
 #    pragma clang diagnostic pop
 
+#    include "../core/LruCache.hpp"
 #    include "TTF.h"
 
 #    pragma warning(disable : 4018) // '<': signed / unsigned mismatch
@@ -78,6 +80,9 @@ in the result FT_Bitmap after the FT_Render_Glyph() call. */
 #    define CACHED_BITMAP 0x01
 #    define CACHED_PIXMAP 0x02
 
+/* Number of glyphs cached for each font */
+#    define GLYPH_CACHE_SIZE 1024
+
 /* Cached glyph information */
 struct c_glyph
 {
@@ -94,6 +99,26 @@ struct c_glyph
     uint16_t cached;
 };
 
+static void Flush_Glyph(c_glyph* glyph);
+
+/* Frees the bitmaps of a glyph dropped from the cache */
+struct c_glyph_deleter
+{
+    void operator()(c_glyph* glyph) const
+    {
+        Flush_Glyph(glyph);
+        delete glyph;
+    }
+};
+
+/* Glyphs of a font by character */
+struct c_glyph_cache
+{
+    LruCache<uint16_t, std::unique_ptr<c_glyph, c_glyph_deleter>> glyphs{ GLYPH_CACHE_SIZE };
+    uint64_t hits{};
+    uint64_t misses{};
+};
+
 /* The structure used to hold internal font information */
 struct _TTF_Font
 {
@@ -124,7 +149,7 @@ struct _TTF_Font
 
     /* Cache for style-transformed glyphs */
     c_glyph* current;
-    c_glyph cache[257]; /* 257 is a prime */
+    c_glyph_cache* cache;
 
     /* We are responsible for closing the font stream */
     FILE* src;
@@ -391,6 +416,7 @@ static TTF_Font* TTF_OpenFontIndexRW(FILE* src, int freesrc, int ptsize, long in
         return NULL;
     }
     std::fill_n((uint8_t*)font, sizeof(*font), 0x00);
+    font->cache = new c_glyph_cache();
 
     font->src = src;
     font->freesrc = freesrc;
@@ -557,16 +583,8 @@ static void Flush_Glyph(c_glyph* glyph)
 
 static void Flush_Cache(TTF_Font* font)
 {
-    int i;
-    int size = sizeof(font->cache) / sizeof(font->cache[0]);
-
-    for (i = 0; i < size; ++i)
-    {
-        if (font->cache[i].cached)
-        {
-            Flush_Glyph(&font->cache[i]);
-        }
-    }
+    font->cache->glyphs.Clear();
+    font->current = NULL;
 }
 
 static FT_Error Load_Glyph(TTF_Font* font, uint16_t ch, c_glyph* cached, int want)
@@ -962,18 +980,25 @@ static FT_Error Load_Glyph(TTF_Font* font, uint16_t ch, c_glyph* cached, int wan
 static FT_Error Find_Glyph(TTF_Font* font, uint16_t ch, int want)
 {
     int retval = 0;
-    int hsize = sizeof(font->cache) / sizeof(font->cache[0]);
+    c_glyph_cache* cache = font->cache;
 
-    int h = ch % hsize;
-    font->current = &font->cache[h];
-
-    if (font->current->cached != ch)
-        Flush_Glyph(font->current);
+    auto glyph = cache->glyphs.Find(ch);
+    if (glyph == nullptr)
+    {
+        glyph = &cache->glyphs.Set(ch, std::unique_ptr<c_glyph, c_glyph_deleter>(new c_glyph()));
+    }
+    font->current = glyph->get();
+    font->current->cached = ch;
 
     if ((font->current->stored & want) != want)
     {
+        cache->misses++;
         retval = Load_Glyph(font, ch, font->current, want);
     }
+    else
+    {
+        cache->hits++;
+    }
     return retval;
 }
 
@@ -982,6 +1007,7 @@ void TTF_CloseFont(TTF_Font* font)
     if (font)
     {
         Flush_Cache(font);
+        delete font->cache;
         if (font->face)
         {
             FT_Done_Face(font->face);
@@ -1118,6 +1144,13 @@ int TTF_GlyphIsProvided(const TTF_Font* font, codepoint_t ch)
     return (FT_Get_Char_Index(font->face, ch));
 }
 
+void TTF_GetGlyphCacheStats(const TTF_Font* font, uint64_t* hits, uint64_t* misses, size_t* count)
+{
+    *hits = font->cache->hits;
+    *misses = font->cache->misses;
+    *count = font->cache->glyphs.GetCount();
+}
+
 int TTF_SizeUTF8(TTF_Font* font, const char* text, int* w, int* h)
 {
     int status;
@@ -12,7 +12,7 @@
 #include "../localisation/Localisation.h"
 #include "Drawing.h"
 
-static TextPaint _legacyPaint;
+static thread_local TextPaint _legacyPaint;
 
 static void DrawText(rct_drawpixelinfo* dpi, int32_t x, int32_t y, TextPaint* paint, const_utf8string text);
 static void DrawText(rct_drawpixelinfo* dpi, int32_t x, int32_t y, TextPaint* paint, rct_string_id format, void* args);
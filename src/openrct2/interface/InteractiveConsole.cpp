@@ -25,6 +25,7 @@
 #include "../core/String.hpp"
 #include "../drawing/Drawing.h"
 #include "../drawing/Font.h"
+#include "../drawing/TTF.h"
 #include "../interface/Chat.h"
 #include "../interface/Colour.h"
 #include "../interface/Window_internal.h"
@@ -48,6 +49,7 @@
 #include "Viewport.h"
 
 #include <algorithm>
+#include <cinttypes>
 #include <cmath>
 #include <cstdarg>
 #include <cstdlib>
@@ -695,6 +697,12 @@ static int32_t cc_get(InteractiveConsole& console, const arguments_t& argv)
         {
             console.WriteFormatLine("current_rotation %d", get_current_rotation());
         }
+        else if (argv[0] == "peep_tick_stats")
+        {
+            console.WriteFormatLine(
+                "peep_tick_stats updates %u deferred %u time %uus", gPeepTickStats.Tick128Updates, gPeepTickStats.Deferred,
+                (uint32_t)gPeepTickStats.Tick128Microseconds);
+        }
 #ifndef NO_TTF
         else if (argv[0] == "enable_hinting")
         {
@@ -1257,6 +1265,24 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
     return 0;
 }
 
+static int32_t cc_show_font_cache(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+#ifndef NO_TTF
+    auto stats = ttf_get_cache_stats();
+    console.WriteFormatLine(
+        "Glyphs: %zu cached, %" PRIu64 " hits, %" PRIu64 " misses", stats.GlyphCount, stats.GlyphHits, stats.GlyphMisses);
+    console.WriteFormatLine(
+        "Text images: %zu cached, %" PRIu64 " hits, %" PRIu64 " misses", stats.SurfaceCount, stats.SurfaceHits,
+        stats.SurfaceMisses);
+    console.WriteFormatLine(
+        "Text widths: %zu cached, %" PRIu64 " hits, %" PRIu64 " misses", stats.WidthCount, stats.WidthHits,
+        stats.WidthMisses);
+#else
+    console.WriteLine("OpenRCT2 was built without TrueType font support.");
+#endif // NO_TTF
+    return 0;
+}
+
 static int32_t cc_for_date([[maybe_unused]] InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
     int32_t year = 0;
@@ -1359,7 +1385,7 @@ static int32_t cc_replay_startrecord(InteractiveConsole& console, const argument
 
     if (argv.size() < 1)
     {
-        console.WriteFormatLine("Parameters required <replay_name> [<max_ticks = 0xFFFFFFFF>]");
+        console.WriteFormatLine("Parameters required <replay_name> [<max_ticks = 0xFFFFFFFF>] [<keyframe_interval = 0>]");
         return 0;
     }
 
@@ -1372,8 +1398,15 @@ static int32_t cc_replay_startrecord(InteractiveConsole& console, const argument
         maxTicks = atol(argv[1].c_str());
     }
 
+    // Keyframes allow seeking without simulating from the start but make the replay larger.
+    uint32_t keyframeInterval = 0;
+    if (argv.size() >= 3)
+    {
+        keyframeInterval = atol(argv[2].c_str());
+    }
+
     auto* replayManager = OpenRCT2::GetContext()->GetReplayManager();
-    if (replayManager->StartRecording(name, maxTicks))
+    if (replayManager->StartRecording(name, maxTicks, keyframeInterval))
     {
         OpenRCT2::ReplayRecordInfo info;
         replayManager->GetCurrentReplayInfo(info);
@@ -1411,11 +1444,15 @@ static int32_t cc_replay_stoprecord(InteractiveConsole& console, const arguments
         const char* logFmt = "Replay recording stopped: (%s) %s\n"
                              "  Ticks: %u\n"
                              "  Commands: %u\n"
-                             "  Checksums: %u";
+                             "  Checksums: %u\n"
+                             "  Keyframes: %u";
 
         console.WriteFormatLine(
-            logFmt, info.Name.c_str(), info.FilePath.c_str(), info.Ticks, info.NumCommands, info.NumChecksums);
-        log_info(logFmt, info.Name.c_str(), info.FilePath.c_str(), info.Ticks, info.NumCommands, info.NumChecksums);
+            logFmt, info.Name.c_str(), info.FilePath.c_str(), info.Ticks, info.NumCommands, info.NumChecksums,
+            info.NumKeyframes);
+        log_info(
+            logFmt, info.Name.c_str(), info.FilePath.c_str(), info.Ticks, info.NumCommands, info.NumChecksums,
+            info.NumKeyframes);
 
         return 1;
     }
@@ -1483,6 +1520,77 @@ static int32_t cc_replay_stop(InteractiveConsole& console, const arguments_t& ar
     return 0;
 }
 
+static int32_t cc_replay_seek(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (network_get_mode() != NETWORK_MODE_NONE)
+    {
+        console.WriteFormatLine("This command is currently not supported in multiplayer mode.");
+        return 0;
+    }
+
+    if (argv.size() < 1)
+    {
+        console.WriteFormatLine("Parameters required <tick>");
+        return 0;
+    }
+
+    uint32_t tick = atol(argv[0].c_str());
+
+    auto* replayManager = OpenRCT2::GetContext()->GetReplayManager();
+    if (!replayManager->IsReplaying())
+    {
+        console.WriteFormatLine("Replay currently not playing");
+        return 0;
+    }
+
+    if (replayManager->SeekPlayback(tick))
+    {
+        console.WriteFormatLine("Replay seeked to tick %u", tick);
+        return 1;
+    }
+
+    return 0;
+}
+
+static int32_t cc_replay_verify_range(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (network_get_mode() != NETWORK_MODE_NONE)
+    {
+        console.WriteFormatLine("This command is currently not supported in multiplayer mode.");
+        return 0;
+    }
+
+    if (argv.size() < 3)
+    {
+        console.WriteFormatLine("Parameters required <replay_name> <start_tick> <end_tick>");
+        return 0;
+    }
+
+    std::string name = argv[0];
+    uint32_t startTick = atol(argv[1].c_str());
+    uint32_t endTick = atol(argv[2].c_str());
+
+    auto* replayManager = OpenRCT2::GetContext()->GetReplayManager();
+
+    OpenRCT2::ReplayVerifyResult result;
+    if (!replayManager->VerifyRange(name, startTick, endTick, result))
+    {
+        return 0;
+    }
+
+    if (result.MismatchTick != OpenRCT2::k_MaxReplayTicks)
+    {
+        console.WriteFormatLine(
+            "Replay state mismatch at tick %u (verified %u checksums from tick %u)", result.MismatchTick,
+            result.NumChecksums, result.StartTick);
+        return 0;
+    }
+
+    console.WriteFormatLine(
+        "Replay ticks %u to %u match (%u checksums)", result.StartTick, result.EndTick, result.NumChecksums);
+    return 1;
+}
+
 static int32_t cc_replay_normalise(InteractiveConsole& console, const arguments_t& argv)
 {
     if (network_get_mode() != NETWORK_MODE_NONE)
@@ -1493,15 +1601,22 @@ static int32_t cc_replay_normalise(InteractiveConsole& console, const arguments_
 
     if (argv.size() < 2)
     {
-        console.WriteFormatLine("Parameters required <replay_input> <replay_output>");
+        console.WriteFormatLine("Parameters required <replay_input> <replay_output> [<keyframe_interval = 0>]");
         return 0;
     }
 
     std::string inputFile = argv[0];
     std::string outputFile = argv[1];
 
+    // Keeps the keyframes of the input unless an interval is given.
+    uint32_t keyframeInterval = 0;
+    if (argv.size() >= 3)
+    {
+        keyframeInterval = atol(argv[2].c_str());
+    }
+
     auto* replayManager = OpenRCT2::GetContext()->GetReplayManager();
-    if (replayManager->NormaliseReplay(inputFile, outputFile))
+    if (replayManager->NormaliseReplay(inputFile, outputFile, keyframeInterval))
     {
         console.WriteFormatLine("Stopped replay");
         return 1;
@@ -1643,6 +1758,7 @@ static constexpr const utf8* console_variable_table[] = {
     "cheat_disable_clearance_checks",
     "cheat_disable_support_limits",
     "current_rotation",
+    "peep_tick_stats",
 };
 static constexpr const utf8* console_window_table[] = {
     "object_selection",
@@ -1677,17 +1793,20 @@ static constexpr const console_command console_command_table[] = {
     { "save_park", cc_save_park, "Save current state of park. If no name specified default path will be used.", "save_park [name]" },
     { "say", cc_say, "Say to other players.", "say <message>" },
     { "set", cc_set, "Sets the variable to the specified value.", "set <variable> <value>" },
+    { "show_font_cache", cc_show_font_cache, "Shows the usage of the TrueType font caches.", "show_font_cache" },
     { "show_limits", cc_show_limits, "Shows the map data counts and limits.", "show_limits" },
     { "staff", cc_staff, "Staff management.", "staff <subcommand>" },
     { "terminate", cc_terminate, "Calls std::terminate(), for testing purposes only.", "terminate" },
     { "twitch", cc_twitch, "Twitch API", "twitch" },
     { "variables", cc_variables, "Lists all the variables that can be used with get and sometimes set.", "variables" },
     { "windows", cc_windows, "Lists all the windows that can be opened.", "windows" },
-    { "replay_startrecord", cc_replay_startrecord, "Starts recording a new replay.", "replay_startrecord <name> [max_ticks]"},
+    { "replay_startrecord", cc_replay_startrecord, "Starts recording a new replay.", "replay_startrecord <name> [max_ticks] [keyframe_interval]"},
     { "replay_stoprecord", cc_replay_stoprecord, "Stops recording a new replay.", "replay_stoprecord"},
     { "replay_start", cc_replay_start, "Starts a replay", "replay_start <name>"},
     { "replay_stop", cc_replay_stop, "Stops the replay", "replay_stop"},
-    { "replay_normalise", cc_replay_normalise, "Normalises the replay to remove all gaps", "replay_normalise <input file> <output file>"},
+    { "replay_seek", cc_replay_seek, "Seeks the replay to a tick", "replay_seek <tick>"},
+    { "replay_verify_range", cc_replay_verify_range, "Verifies the game state of a range of a replay", "replay_verify_range <name> <start_tick> <end_tick>"},
+    { "replay_normalise", cc_replay_normalise, "Normalises the replay to remove all gaps", "replay_normalise <input file> <output file> [keyframe_interval]"},
     { "mp_desync", cc_mp_desync, "Forces a multiplayer desync", "cc_mp_desync [desync_type, 0 = Random t-shirt color on random peep, 1 = Remove random peep ]"},
 
 };
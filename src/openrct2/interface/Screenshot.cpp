@@ -17,6 +17,7 @@
 #include "../audio/audio.h"
 #include "../core/Console.hpp"
 #include "../core/Imaging.h"
+#include "../core/JobPool.hpp"
 #include "../core/Optional.hpp"
 #include "../drawing/Drawing.h"
 #include "../drawing/X8DrawingEngine.h"
@@ -29,9 +30,12 @@
 #include "../world/Surface.h"
 #include "Viewport.h"
 
+#include <algorithm>
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
+#include <fstream>
+#include <future>
 #include <memory>
 #include <string>
 
@@ -41,20 +45,23 @@ using namespace OpenRCT2::Drawing;
 
 uint8_t gScreenshotCountdown = 0;
 
+// Number of pixels rendered at a time when a screenshot is written, bounds the memory needed for giant screenshots
+static constexpr size_t SCREENSHOT_STRIP_PIXELS = 4 * 1024 * 1024;
+
 static bool WriteDpiToFile(const std::string_view& path, const rct_drawpixelinfo* dpi, const rct_palette& palette)
 {
-    auto const pixels8 = dpi->bits;
-    auto const pixelsLen = (dpi->width + dpi->pitch) * dpi->height;
     try
     {
         Image image;
         image.Width = dpi->width;
         image.Height = dpi->height;
         image.Depth = 8;
-        image.Stride = dpi->width + dpi->pitch;
         image.Palette = std::make_unique<rct_palette>(palette);
-        image.Pixels = std::vector<uint8_t>(pixels8, pixels8 + pixelsLen);
-        Imaging::WriteToFile(path, image, IMAGE_FORMAT::PNG);
+
+        // Encode straight from the DPI rather than copying it into the image first
+        auto writer = Imaging::CreateStreamWriter(path, image, IMAGE_FORMAT::PNG);
+        writer->WriteRows(dpi->bits, dpi->height, dpi->width + dpi->pitch);
+        writer->Finish();
         return true;
     }
     catch (const std::exception& e)
@@ -392,9 +399,65 @@ static void RenderViewport(IDrawingEngine* drawingEngine, const rct_viewport& vi
     viewport_render(&dpi, &viewport, 0, 0, viewport.width, viewport.height);
 }
 
+static void RenderViewportToFile(const std::string_view& path, const rct_viewport& viewport, const rct_palette& palette)
+{
+    if (viewport.width <= 0 || viewport.height <= 0)
+    {
+        throw std::runtime_error("Screenshot failed, the image has no size.");
+    }
+
+    Image image;
+    image.Width = viewport.width;
+    image.Height = viewport.height;
+    image.Depth = 8;
+    image.Palette = std::make_unique<rct_palette>(palette);
+    auto writer = Imaging::CreateStreamWriter(path, image, IMAGE_FORMAT::PNG);
+
+    // Render the image in horizontal strips so only two strips are ever held in memory, one being rendered while the
+    // other is encoded on another thread. The columns of each strip are painted on the paint job pool if multithreading
+    // is enabled, unless this thread is one of several painting views at once.
+    const int32_t width = viewport.width;
+    const int32_t stripHeight = std::clamp<int32_t>((int32_t)(SCREENSHOT_STRIP_PIXELS / width), 1, viewport.height);
+    std::vector<uint8_t> strips[2];
+    strips[0].resize((size_t)width * stripHeight);
+    strips[1].resize((size_t)width * stripHeight);
+
+    X8DrawingEngine drawingEngine(GetContext()->GetUiContext());
+    std::future<void> encoding;
+    for (int32_t y = 0, index = 0; y < viewport.height; y += stripHeight, index ^= 1)
+    {
+        auto& strip = strips[index];
+        const int32_t height = std::min(stripHeight, viewport.height - y);
+        std::fill_n(strip.data(), (size_t)width * height, PALETTE_INDEX_0);
+
+        rct_drawpixelinfo dpi{};
+        dpi.bits = strip.data();
+        dpi.y = y;
+        dpi.width = width;
+        dpi.height = height;
+        dpi.DrawingEngine = &drawingEngine;
+        gViewportPaintOffscreenOnJobPool = true;
+        viewport_render(&dpi, &viewport, 0, y, width, y + height);
+        gViewportPaintOffscreenOnJobPool = false;
+
+        // The strip encoded before the previous one used this buffer, so it has to have finished before it is reused
+        if (encoding.valid())
+        {
+            encoding.get();
+        }
+        encoding = std::async(std::launch::async, [&writer, &strip, width, height] {
+            writer->WriteRows(strip.data(), height, width);
+        });
+    }
+    if (encoding.valid())
+    {
+        encoding.get();
+    }
+    writer->Finish();
+}
+
 void screenshot_giant()
 {
-    rct_drawpixelinfo dpi{};
     try
     {
         auto path = screenshot_get_next_path();
@@ -423,11 +486,11 @@ void screenshot_giant()
             viewport.flags |= VIEWPORT_FLAG_TRANSPARENT_BACKGROUND;
         }
 
-        dpi = CreateDPI(viewport);
+        // Ensure sprites appear regardless of rotation
+        reset_all_sprite_quadrant_placements();
 
-        RenderViewport(nullptr, viewport, dpi);
         auto renderedPalette = screenshot_get_rendered_palette();
-        WriteDpiToFile(path->c_str(), &dpi, renderedPalette);
+        RenderViewportToFile(*path, viewport, renderedPalette);
 
         // Show user that screenshot saved successfully
         set_format_arg(0, rct_string_id, STR_STRING);
@@ -439,8 +502,6 @@ void screenshot_giant()
         log_error("%s", e.what());
         context_show_error(STR_SCREENSHOT_FAILED, STR_NONE);
     }
-
-    ReleaseDPI(dpi);
 }
 
 // TODO: Move this at some point into a more appropriate place.
@@ -452,6 +513,23 @@ template<typename FN> static inline double MeasureFunctionTime(const FN& fn)
     return std::chrono::duration<double>(endTime - startTime).count();
 }
 
+// Checks the vectorised sprite drawing functions picked for this CPU draw the same pixels as the scalar ones. Each render
+// starts from the same sentinel, so pixels left undrawn by one of them are not hidden by the other's.
+static bool benchgfx_check_sprite_blit(const rct_viewport& viewport, rct_drawpixelinfo& dpi)
+{
+    constexpr uint8_t sentinel = 0xA5;
+    const size_t size = (size_t)dpi.width * dpi.height;
+    const auto blitFn = bitmap_blit_fn;
+    bitmap_blit_fn = bitmap_blit_scalar;
+    std::fill_n(dpi.bits, size, sentinel);
+    RenderViewport(nullptr, viewport, dpi);
+    std::vector<uint8_t> expected(dpi.bits, dpi.bits + size);
+    bitmap_blit_fn = blitFn;
+    std::fill_n(dpi.bits, size, sentinel);
+    RenderViewport(nullptr, viewport, dpi);
+    return std::equal(expected.begin(), expected.end(), dpi.bits);
+}
+
 static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<IContext>& context, uint32_t iterationCount)
 {
     if (!context->LoadParkFromFile(inputPath))
@@ -472,8 +550,8 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
     {
         for (int32_t rotation = 0; rotation < MAX_ROTATIONS; rotation++)
         {
-            auto& viewport = viewports[zoom * MAX_ZOOM_LEVEL + rotation];
-            auto& dpi = dpis[zoom * MAX_ZOOM_LEVEL + rotation];
+            auto& viewport = viewports[zoom * MAX_ROTATIONS + rotation];
+            auto& dpi = dpis[zoom * MAX_ROTATIONS + rotation];
             viewport = GetGiantViewport(gMapSize, rotation, zoom);
             dpi = CreateDPI(viewport);
         }
@@ -483,6 +561,16 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
 
     try
     {
+        if (bitmap_blit_fn != bitmap_blit_scalar)
+        {
+            bool blitMatches = true;
+            for (size_t i = 0; i < dpis.size() && blitMatches; i++)
+            {
+                blitMatches = benchgfx_check_sprite_blit(viewports[i], dpis[i]);
+            }
+            std::printf("Sprite blit: %s\n", blitMatches ? "matches scalar" : "DIFFERS FROM SCALAR");
+        }
+
         double totalTime = 0.0;
 
         std::array<double, MAX_ZOOM_LEVEL> zoomAverages;
@@ -498,8 +586,8 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
                 // N iterations.
                 for (uint32_t i = 0; i < iterationCount; i++)
                 {
-                    auto& dpi = dpis[zoom * MAX_ZOOM_LEVEL + rotation];
-                    auto& viewport = viewports[zoom * MAX_ZOOM_LEVEL + rotation];
+                    auto& dpi = dpis[zoom * MAX_ROTATIONS + rotation];
+                    auto& viewport = viewports[zoom * MAX_ROTATIONS + rotation];
                     double elapsed = MeasureFunctionTime([&viewport, &dpi]() { RenderViewport(nullptr, viewport, dpi); });
                     totalTime += elapsed;
                     zoomLevelTime += elapsed;
@@ -563,7 +651,7 @@ int32_t cmdline_for_gfxbench(const char** argv, int32_t argc)
     return 1;
 }
 
-static void ApplyOptions(const ScreenshotOptions* options, rct_viewport& viewport)
+static void ApplyParkOptions(const ScreenshotOptions* options)
 {
     if (options->weather != 0)
     {
@@ -576,16 +664,6 @@ static void ApplyOptions(const ScreenshotOptions* options, rct_viewport& viewpor
         climate_force_weather(customWeather);
     }
 
-    if (options->hide_guests)
-    {
-        viewport.flags |= VIEWPORT_FLAG_INVISIBLE_PEEPS;
-    }
-
-    if (options->hide_sprites)
-    {
-        viewport.flags |= VIEWPORT_FLAG_INVISIBLE_SPRITES;
-    }
-
     if (options->mowed_grass)
     {
         CheatsSet(CheatType::SetGrassLength, GRASS_LENGTH_MOWED);
@@ -610,6 +688,19 @@ static void ApplyOptions(const ScreenshotOptions* options, rct_viewport& viewpor
     {
         CheatsSet(CheatType::RemoveLitter);
     }
+}
+
+static void ApplyViewportOptions(const ScreenshotOptions* options, rct_viewport& viewport)
+{
+    if (options->hide_guests)
+    {
+        viewport.flags |= VIEWPORT_FLAG_INVISIBLE_PEEPS;
+    }
+
+    if (options->hide_sprites)
+    {
+        viewport.flags |= VIEWPORT_FLAG_INVISIBLE_SPRITES;
+    }
 
     if (options->transparent || gConfigGeneral.transparent_screenshot)
     {
@@ -617,6 +708,97 @@ static void ApplyOptions(const ScreenshotOptions* options, rct_viewport& viewpor
     }
 }
 
+static bool IsGiantScreenshotArgs(const char** argv, int32_t argc)
+{
+    return argc == 5 && _stricmp(argv[2], "giant") == 0;
+}
+
+static bool IsValidScreenshotArgs(const char** argv, int32_t argc)
+{
+    return argc == 4 || argc == 8 || IsGiantScreenshotArgs(argv, argc);
+}
+
+/**
+ * Creates the viewport for the arguments of a screenshot of the loaded park, see cmdline_for_screenshot.
+ */
+static rct_viewport GetScreenshotViewport(const char** argv, int32_t argc, int32_t& rotation)
+{
+    rct_viewport viewport{};
+    if (IsGiantScreenshotArgs(argv, argc))
+    {
+        auto zoom = std::atoi(argv[3]);
+        rotation = std::atoi(argv[4]) & 3;
+        viewport = GetGiantViewport(gMapSize, rotation, zoom);
+        return viewport;
+    }
+
+    bool customLocation = false;
+    bool centreMapX = false;
+    bool centreMapY = false;
+    int32_t resolutionWidth = std::atoi(argv[2]);
+    int32_t resolutionHeight = std::atoi(argv[3]);
+    int32_t customX = 0;
+    int32_t customY = 0;
+    int32_t customZoom = 0;
+    int32_t customRotation = 0;
+    if (argc == 8)
+    {
+        customLocation = true;
+        if (argv[4][0] == 'c')
+            centreMapX = true;
+        else
+            customX = std::atoi(argv[4]);
+
+        if (argv[5][0] == 'c')
+            centreMapY = true;
+        else
+            customY = std::atoi(argv[5]);
+
+        customZoom = std::atoi(argv[6]);
+        customRotation = std::atoi(argv[7]) & 3;
+    }
+
+    int32_t mapSize = gMapSize;
+    if (resolutionWidth == 0 || resolutionHeight == 0)
+    {
+        resolutionWidth = (mapSize * 32 * 2) >> customZoom;
+        resolutionHeight = (mapSize * 32 * 1) >> customZoom;
+
+        resolutionWidth += 8;
+        resolutionHeight += 128;
+    }
+
+    viewport.width = resolutionWidth;
+    viewport.height = resolutionHeight;
+    viewport.view_width = viewport.width;
+    viewport.view_height = viewport.height;
+    if (customLocation)
+    {
+        if (centreMapX)
+            customX = (mapSize / 2) * 32 + 16;
+        if (centreMapY)
+            customY = (mapSize / 2) * 32 + 16;
+
+        int32_t z = tile_element_height({ customX, customY });
+        CoordsXYZ coords3d = { customX, customY, z };
+
+        auto coords2d = translate_3d_to_2d_with_z(customRotation, coords3d);
+
+        viewport.view_x = coords2d.x - ((viewport.view_width << customZoom) / 2);
+        viewport.view_y = coords2d.y - ((viewport.view_height << customZoom) / 2);
+        viewport.zoom = customZoom;
+        rotation = customRotation;
+    }
+    else
+    {
+        viewport.view_x = gSavedViewX - (viewport.view_width / 2);
+        viewport.view_y = gSavedViewY - (viewport.view_height / 2);
+        viewport.zoom = gSavedViewZoom;
+        rotation = gSavedViewRotation;
+    }
+    return viewport;
+}
+
 int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOptions* options)
 {
     // Don't include options in the count (they have been handled by CommandLine::ParseOptions already)
@@ -630,8 +812,7 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
         }
     }
 
-    bool giantScreenshot = (argc == 5) && _stricmp(argv[2], "giant") == 0;
-    if (argc != 4 && argc != 8 && !giantScreenshot)
+    if (!IsValidScreenshotArgs(argv, argc))
     {
         std::printf("Usage: openrct2 screenshot <file> <output_image> <width> <height> [<x> <y> <zoom> <rotation>]\n");
         std::printf("Usage: openrct2 screenshot <file> <output_image> giant <zoom> <rotation>\n");
@@ -639,13 +820,9 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
     }
 
     int32_t exitCode = 1;
-    rct_drawpixelinfo dpi;
     try
     {
         core_init();
-        bool customLocation = false;
-        bool centreMapX = false;
-        bool centreMapY = false;
 
         const char* inputPath = argv[0];
         const char* outputPath = argv[1];
@@ -667,93 +844,305 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
         gIntroState = INTRO_STATE_NONE;
         gScreenFlags = SCREEN_FLAGS_PLAYING;
 
-        rct_viewport viewport{};
-        if (giantScreenshot)
+        int32_t rotation = 0;
+        auto viewport = GetScreenshotViewport(argv, argc, rotation);
+        gCurrentRotation = rotation;
+
+        ApplyParkOptions(options);
+        ApplyViewportOptions(options, viewport);
+
+        // Ensure sprites appear regardless of rotation
+        reset_all_sprite_quadrant_placements();
+
+        auto renderedPalette = screenshot_get_rendered_palette();
+        RenderViewportToFile(outputPath, viewport, renderedPalette);
+    }
+    catch (const std::exception& e)
+    {
+        std::printf("%s\n", e.what());
+        exitCode = -1;
+    }
+
+    drawing_engine_dispose();
+
+    return exitCode;
+}
+
+struct BatchScreenshotView
+{
+    int32_t LineNumber{};
+    std::vector<std::string> Arguments;
+    rct_viewport Viewport{};
+    int32_t Rotation{};
+
+    // Result
+    bool Rendered{};
+    std::string Error;
+    double Seconds{};
+};
+
+static std::vector<std::string> SplitBatchLine(const std::string& line)
+{
+    std::vector<std::string> arguments;
+    std::string argument;
+    bool inArgument = false;
+    bool inQuotes = false;
+    for (auto c : line)
+    {
+        if (c == '"')
         {
-            auto zoom = std::atoi(argv[3]);
-            auto rotation = std::atoi(argv[4]) & 3;
-            viewport = GetGiantViewport(gMapSize, rotation, zoom);
-            gCurrentRotation = rotation;
+            inQuotes = !inQuotes;
+            inArgument = true;
         }
-        else
+        else if (!inQuotes && std::isspace((unsigned char)c))
         {
-            int32_t resolutionWidth = std::atoi(argv[2]);
-            int32_t resolutionHeight = std::atoi(argv[3]);
-            int32_t customX = 0;
-            int32_t customY = 0;
-            int32_t customZoom = 0;
-            int32_t customRotation = 0;
-            if (argc == 8)
+            if (inArgument)
             {
-                customLocation = true;
-                if (argv[4][0] == 'c')
-                    centreMapX = true;
-                else
-                    customX = std::atoi(argv[4]);
+                arguments.push_back(std::move(argument));
+                argument.clear();
+                inArgument = false;
+            }
+        }
+        else
+        {
+            argument.push_back(c);
+            inArgument = true;
+        }
+    }
+    if (inArgument)
+    {
+        arguments.push_back(std::move(argument));
+    }
+    return arguments;
+}
 
-                if (argv[5][0] == 'c')
-                    centreMapY = true;
-                else
-                    customY = std::atoi(argv[5]);
+static std::vector<BatchScreenshotView> ReadScreenshotBatch(const char* path)
+{
+    std::ifstream fs(path);
+    if (!fs.is_open())
+    {
+        throw std::runtime_error("Unable to open batch file.");
+    }
 
-                customZoom = std::atoi(argv[6]);
-                customRotation = std::atoi(argv[7]) & 3;
-            }
+    std::vector<BatchScreenshotView> views;
+    std::string line;
+    for (int32_t lineNumber = 1; std::getline(fs, line); lineNumber++)
+    {
+        auto arguments = SplitBatchLine(line);
+        if (arguments.empty() || arguments[0][0] == '#')
+        {
+            continue;
+        }
+
+        std::vector<const char*> argv;
+        for (const auto& argument : arguments)
+        {
+            argv.push_back(argument.c_str());
+        }
+        if (!IsValidScreenshotArgs(argv.data(), (int32_t)argv.size()))
+        {
+            throw std::runtime_error("Invalid screenshot on line " + std::to_string(lineNumber) + " of batch file.");
+        }
+
+        BatchScreenshotView view;
+        view.LineNumber = lineNumber;
+        view.Arguments = std::move(arguments);
+        views.push_back(std::move(view));
+    }
+    return views;
+}
+
+static void RenderBatchView(BatchScreenshotView& view, const rct_palette& palette)
+{
+    try
+    {
+        view.Seconds = MeasureFunctionTime(
+            [&view, &palette]() { RenderViewportToFile(view.Arguments[1], view.Viewport, palette); });
+        view.Rendered = true;
+    }
+    catch (const std::exception& e)
+    {
+        view.Error = e.what();
+    }
+}
+
+static void PrintBatchView(const BatchScreenshotView& view)
+{
+    if (view.Rendered)
+    {
+        double megapixels = ((double)view.Viewport.width * view.Viewport.height) / 1000000.0;
+        std::printf(
+            "%s: %d x %d, %.3fs, %.1f Mpx/s\n", view.Arguments[1].c_str(), view.Viewport.width, view.Viewport.height,
+            view.Seconds, megapixels / std::max(view.Seconds, 0.000001));
+    }
+    else
+    {
+        std::printf("%s: failed, %s\n", view.Arguments[1].c_str(), view.Error.c_str());
+    }
+}
+
+/**
+ * Renders all screenshots of a batch file with the current context. Each line has the arguments of the screenshot
+ * command, views of the same park are rendered after loading it once, and with multithreading enabled views with the
+ * same rotation are rendered at the same time.
+ * @return the number of screenshots that failed
+ */
+int32_t screenshot_render_batch(const char* batchPath, int32_t jobs, ScreenshotOptions* options)
+{
+    auto views = ReadScreenshotBatch(batchPath);
+    if (views.empty())
+    {
+        throw std::runtime_error("Batch file has no screenshots.");
+    }
+
+    auto context = GetContext();
+
+    // Views are only painted on several threads at once if multithreading is enabled, as the font caches are not
+    // locked otherwise
+    std::unique_ptr<JobPool> jobPool;
+    if (gConfigGeneral.multithreading)
+    {
+        jobPool = std::make_unique<JobPool>(jobs > 0 ? (size_t)jobs : 255);
+    }
+    int32_t numFailed = 0;
+    double totalMegapixels = 0;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (size_t parkStart = 0; parkStart < views.size();)
+    {
+        // Views of the same park are next to each other in the batch file
+        const auto& parkPath = views[parkStart].Arguments[0];
+        size_t parkEnd = parkStart + 1;
+        while (parkEnd < views.size() && views[parkEnd].Arguments[0] == parkPath)
+        {
+            parkEnd++;
+        }
 
-            int32_t mapSize = gMapSize;
-            if (resolutionWidth == 0 || resolutionHeight == 0)
+        bool parkLoaded = false;
+        try
+        {
+            parkLoaded = context->LoadParkFromFile(parkPath);
+            if (parkLoaded)
             {
-                resolutionWidth = (mapSize * 32 * 2) >> customZoom;
-                resolutionHeight = (mapSize * 32 * 1) >> customZoom;
+                gIntroState = INTRO_STATE_NONE;
+                gScreenFlags = SCREEN_FLAGS_PLAYING;
+                ApplyParkOptions(options);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::printf("%s: %s\n", parkPath.c_str(), e.what());
+            parkLoaded = false;
+        }
 
-                resolutionWidth += 8;
-                resolutionHeight += 128;
+        for (size_t i = parkStart; i < parkEnd; i++)
+        {
+            auto& view = views[i];
+            if (!parkLoaded)
+            {
+                view.Error = "Failed to load park.";
+                continue;
             }
 
-            viewport.width = resolutionWidth;
-            viewport.height = resolutionHeight;
-            viewport.view_width = viewport.width;
-            viewport.view_height = viewport.height;
-            if (customLocation)
+            std::vector<const char*> argv;
+            for (const auto& argument : view.Arguments)
             {
-                if (centreMapX)
-                    customX = (mapSize / 2) * 32 + 16;
-                if (centreMapY)
-                    customY = (mapSize / 2) * 32 + 16;
+                argv.push_back(argument.c_str());
+            }
+            view.Viewport = GetScreenshotViewport(argv.data(), (int32_t)argv.size(), view.Rotation);
+            ApplyViewportOptions(options, view.Viewport);
+        }
 
-                int32_t z = tile_element_height({ customX, customY });
-                CoordsXYZ coords3d = { customX, customY, z };
+        // The rotation is global, so only views with the same rotation can be rendered at the same time
+        auto renderedPalette = screenshot_get_rendered_palette();
+        for (int32_t rotation = 0; rotation < 4 && parkLoaded; rotation++)
+        {
+            gCurrentRotation = rotation;
+            reset_all_sprite_quadrant_placements();
+            for (size_t i = parkStart; i < parkEnd; i++)
+            {
+                auto& view = views[i];
+                if (view.Rotation != rotation)
+                {
+                    continue;
+                }
 
-                auto coords2d = translate_3d_to_2d_with_z(customRotation, coords3d);
+                if (jobPool != nullptr)
+                {
+                    jobPool->AddTask(
+                        [&view, &renderedPalette]() {
+                            // This thread paints the whole view, the shared paint job pool is left to the other views
+                            gViewportPaintOnCallingThread = true;
+                            RenderBatchView(view, renderedPalette);
+                        },
+                        [&view]() { PrintBatchView(view); });
+                }
+                else
+                {
+                    RenderBatchView(view, renderedPalette);
+                    PrintBatchView(view);
+                }
+            }
+            if (jobPool != nullptr)
+            {
+                jobPool->Join();
+            }
+        }
 
-                viewport.view_x = coords2d.x - ((viewport.view_width << customZoom) / 2);
-                viewport.view_y = coords2d.y - ((viewport.view_height << customZoom) / 2);
-                viewport.zoom = customZoom;
-                gCurrentRotation = customRotation;
+        for (size_t i = parkStart; i < parkEnd; i++)
+        {
+            const auto& view = views[i];
+            if (view.Rendered)
+            {
+                totalMegapixels += ((double)view.Viewport.width * view.Viewport.height) / 1000000.0;
             }
             else
             {
-                viewport.view_x = gSavedViewX - (viewport.view_width / 2);
-                viewport.view_y = gSavedViewY - (viewport.view_height / 2);
-                viewport.zoom = gSavedViewZoom;
-                gCurrentRotation = gSavedViewRotation;
+                if (!parkLoaded)
+                {
+                    PrintBatchView(view);
+                }
+                numFailed++;
             }
         }
+        parkStart = parkEnd;
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double totalTime = std::chrono::duration<double>(endTime - startTime).count();
+    int32_t numRendered = (int32_t)views.size() - numFailed;
+    std::printf("Screenshots: %d rendered, %d failed\n", numRendered, numFailed);
+    std::printf(
+        "Time: %.3fs, %.2f screenshots/s, %.1f Mpx/s\n", totalTime, numRendered / std::max(totalTime, 0.000001),
+        totalMegapixels / std::max(totalTime, 0.000001));
+    return numFailed;
+}
+
+int32_t cmdline_for_screenshot_batch(const char* batchPath, int32_t jobs, ScreenshotOptions* options)
+{
+    int32_t exitCode = 1;
+    try
+    {
+        core_init();
+        gOpenRCT2Headless = true;
 
-        ApplyOptions(options, viewport);
+        auto context = CreateContext();
+        if (!context->Initialise())
+        {
+            throw std::runtime_error("Failed to initialize context.");
+        }
 
-        dpi = CreateDPI(viewport);
+        drawing_engine_init();
 
-        RenderViewport(nullptr, viewport, dpi);
-        auto renderedPalette = screenshot_get_rendered_palette();
-        WriteDpiToFile(outputPath, &dpi, renderedPalette);
+        if (screenshot_render_batch(batchPath, jobs, options) != 0)
+        {
+            exitCode = -1;
+        }
     }
     catch (const std::exception& e)
     {
         std::printf("%s\n", e.what());
         exitCode = -1;
     }
-    ReleaseDPI(dpi);
 
     drawing_engine_dispose();
 
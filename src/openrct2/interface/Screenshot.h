@@ -37,5 +37,7 @@ std::string screenshot_dump_png(rct_drawpixelinfo* dpi);
 std::string screenshot_dump_png_32bpp(int32_t width, int32_t height, const void* pixels);
 
 void screenshot_giant();
+int32_t screenshot_render_batch(const char* batchPath, int32_t jobs, ScreenshotOptions* options);
 int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOptions* options);
+int32_t cmdline_for_screenshot_batch(const char* batchPath, int32_t jobs, ScreenshotOptions* options);
 int32_t cmdline_for_gfxbench(const char** argv, int32_t argc);
@@ -44,6 +44,8 @@ rct_viewport g_viewport_list[MAX_VIEWPORT_COUNT];
 rct_viewport* g_music_tracking_viewport;
 
 static std::unique_ptr<JobPool> _paintJobs;
+thread_local bool gViewportPaintOnCallingThread = false;
+thread_local bool gViewportPaintOffscreenOnJobPool = false;
 
 int16_t gSavedViewX;
 int16_t gSavedViewY;
@@ -915,14 +917,16 @@ void viewport_paint(
     std::vector<paint_session*> columns;
 
     bool useMultithreading = gConfigGeneral.multithreading;
-    if (window_get_main() != nullptr && viewport != window_get_main()->viewport)
+    if (window_get_main() != nullptr && viewport != window_get_main()->viewport && !gViewportPaintOffscreenOnJobPool)
+        useMultithreading = false;
+    if (gViewportPaintOnCallingThread)
         useMultithreading = false;
 
     if (useMultithreading && _paintJobs == nullptr)
     {
         _paintJobs = std::make_unique<JobPool>();
     }
-    else if (useMultithreading == false && _paintJobs != nullptr)
+    else if (useMultithreading == false && _paintJobs != nullptr && !gViewportPaintOnCallingThread)
     {
         _paintJobs.reset();
     }
@@ -127,6 +127,13 @@ extern uint8_t gSavedViewZoom;
 extern uint8_t gSavedViewRotation;
 
 extern paint_entry* gNextFreePaintStruct;
+
+// Set on threads that paint viewports at the same time as other threads, so their columns are painted on the calling
+// thread rather than on the shared paint job pool
+extern thread_local bool gViewportPaintOnCallingThread;
+// Set while painting large off-screen viewports, such as giant screenshots, so their columns are painted on the paint job
+// pool like the main viewport's
+extern thread_local bool gViewportPaintOffscreenOnJobPool;
 extern uint8_t gCurrentRotation;
 
 void viewport_init_all();
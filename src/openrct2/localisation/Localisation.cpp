@@ -30,11 +30,14 @@
 #include "Localisation.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <ctype.h>
 #include <iterator>
 #include <limits.h>
+#include <unordered_map>
+#include <vector>
 
 thread_local char gCommonStringFormatBuffer[512];
 thread_local uint8_t gCommonFormatArgs[80];
@@ -349,28 +352,13 @@ const rct_string_id DateGameShortMonthNames[MONTH_COUNT] = {
         format_push_char_safe(C);                                                                                              \
     }
 
-#define format_push_wrap(C)                                                                                                    \
-    {                                                                                                                          \
-        *ncur = (C);                                                                                                           \
-        if (ncur == (*dest))                                                                                                   \
-            ncur = nbegin;                                                                                                     \
-    }
-#define reverse_string()                                                                                                       \
-    while (nbegin < nend)                                                                                                      \
-    {                                                                                                                          \
-        tmp = *nbegin;                                                                                                         \
-        *nbegin++ = *nend;                                                                                                     \
-        *nend-- = tmp;                                                                                                         \
-    }
-
-static void format_string_part_from_raw(char** dest, size_t* size, const char* src, char** args);
+static void format_string_part_from_raw(char** dest, size_t* size, const char* src, const char* end, char** args);
 static void format_string_part(char** dest, size_t* size, rct_string_id format, char** args);
 
-static void format_append_string(char** dest, size_t* size, const utf8* string)
+static void format_append_string(char** dest, size_t* size, const utf8* string, size_t length)
 {
     if ((*size) == 0)
         return;
-    size_t length = strlen(string);
     if (length < (*size))
     {
         std::memcpy((*dest), string, length);
@@ -386,399 +374,90 @@ static void format_append_string(char** dest, size_t* size, const utf8* string)
     }
 }
 
-static void format_integer(char** dest, size_t* size, int64_t value)
+static void format_append_string(char** dest, size_t* size, const utf8* string)
 {
-    int32_t digit;
-    char *nbegin, *nend, *ncur;
-    char tmp;
-
     if ((*size) == 0)
         return;
+    format_append_string(dest, size, string, strlen(string));
+}
 
-    // Negative sign
-    if (value < 0)
-    {
-        format_push_char('-');
-        value = -value;
-    }
-
-    if (value == 0)
-    {
-        format_push_char('0');
-        return;
-    }
-
-    nbegin = (*dest);
-
-    // Right to left
-    while (value > 0 && (*size) > 1)
-    {
-        digit = value % 10;
-        value /= 10;
-
-        format_push_char_safe('0' + digit);
-    }
-
-    if (value > 0)
-    {
-        ncur = nbegin;
-
-        while (value > 0)
-        {
-            digit = value % 10;
-            value /= 10;
-
-            format_push_wrap('0' + digit);
-        }
-
-        // Reverse first half of string
-        nend = ncur - 1;
-        reverse_string();
-
-        // Reverse second half of string
-        nbegin = ncur;
-        nend = (*dest) - 1;
-        reverse_string();
+// Separators longer than this are cut, so a number always fits in the buffer it is formatted in
+static constexpr size_t MAX_NUMBER_SEPARATOR_LENGTH = 16;
 
-        format_push_char_safe('\0'); // Truncate overflowed string
-    }
-    else
-    {
-        // Reverse string
-        nend = (*dest) - 1;
-        reverse_string();
-    }
+static char* format_number_separator(char* ch, const char* separator)
+{
+    size_t length = std::min(strlen(separator), MAX_NUMBER_SEPARATOR_LENGTH);
+    ch -= length;
+    std::memcpy(ch, separator, length);
+    return ch;
 }
 
-static void format_comma_separated_integer(char** dest, size_t* size, int64_t value)
+/**
+ * Formats a number into a buffer from right to left and appends it, so it is truncated like any other string when it
+ * does not fit.
+ */
+static void format_number(char** dest, size_t* size, int64_t value, int32_t decimalPlaces, bool separateThousands)
 {
-    int32_t digit, groupIndex;
-    char *nbegin, *nend, *ncur;
-    char tmp;
-    const char* commaMark = language_get_string(STR_LOCALE_THOUSANDS_SEPARATOR);
-    const char* ch = nullptr;
+    static constexpr const char Digits[] = "0123456789";
+    char buffer[24 + 8 * MAX_NUMBER_SEPARATOR_LENGTH];
 
     if ((*size) == 0)
         return;
 
-    // Negative sign
-    if (value < 0)
+    uint64_t digits = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    char* ch = std::end(buffer);
+    if (decimalPlaces > 0)
     {
-        format_push_char('-');
-        value = -value;
-    }
-
-    if (value == 0)
-    {
-        format_push_char('0');
-        return;
+        for (int32_t i = 0; i < decimalPlaces; i++)
+        {
+            *--ch = Digits[digits % 10];
+            digits /= 10;
+        }
+        ch = format_number_separator(ch, language_get_string(STR_LOCALE_DECIMAL_POINT));
     }
 
-    nbegin = *dest;
-
-    // Groups of three digits, right to left
-    groupIndex = 0;
-    while (value > 0 && (*size) > 1)
+    const char* commaMark = separateThousands ? language_get_string(STR_LOCALE_THOUSANDS_SEPARATOR) : nullptr;
+    int32_t groupIndex = 0;
+    do
     {
-        // Append group separator
         if (groupIndex == 3)
         {
+            ch = format_number_separator(ch, commaMark);
             groupIndex = 0;
-            ch = commaMark;
         }
-
-        if (ch != nullptr)
-        {
-            format_push_char_safe(*ch++);
-            if (*ch == '\0')
-                ch = nullptr;
-        }
-        else
+        *--ch = Digits[digits % 10];
+        digits /= 10;
+        if (commaMark != nullptr)
         {
-            digit = value % 10;
-            value /= 10;
-
-            format_push_char_safe('0' + digit);
             groupIndex++;
         }
-    }
-
-    if (value > 0)
-    {
-        ncur = nbegin;
+    } while (digits > 0);
 
-        while (value > 0)
-        {
-            // Append group separator
-            if (groupIndex == 3)
-            {
-                groupIndex = 0;
-                ch = commaMark;
-            }
-
-            if (ch != nullptr)
-            {
-                format_push_wrap(*ch++);
-                if (*ch == '\0')
-                    ch = nullptr;
-            }
-            else
-            {
-                digit = value % 10;
-                value /= 10;
-
-                format_push_wrap('0' + digit);
-                groupIndex++;
-            }
-        }
-
-        // Reverse first half of string
-        nend = ncur - 1;
-        reverse_string();
-
-        // Reverse second half of string
-        nbegin = ncur;
-        nend = (*dest) - 1;
-        reverse_string();
-
-        format_push_char_safe('\0'); // Truncate overflowed string
-    }
-    else
+    if (value < 0)
     {
-        // Reverse string
-        nend = *dest - 1;
-        reverse_string();
+        *--ch = '-';
     }
+    format_append_string(dest, size, ch, std::end(buffer) - ch);
 }
 
-static void format_comma_separated_fixed_1dp(char** dest, size_t* size, int64_t value)
+static void format_integer(char** dest, size_t* size, int64_t value)
 {
-    int32_t digit, groupIndex;
-    char *nbegin, *nend, *ncur;
-    char tmp;
-    const char* commaMark = language_get_string(STR_LOCALE_THOUSANDS_SEPARATOR);
-    const char* decimalMark = language_get_string(STR_LOCALE_DECIMAL_POINT);
-    const char* ch = nullptr;
-    int32_t zeroNeeded = 1;
-
-    if ((*size) == 0)
-        return;
-
-    // Negative sign
-    if (value < 0)
-    {
-        format_push_char('-');
-        value = -value;
-    }
-
-    nbegin = (*dest);
-
-    // In the case of buffers this small,
-    // all of this would be truncated anyways.
-    format_handle_overflow(1);
-    if ((*size) > 2)
-    {
-        // One decimal place
-        digit = value % 10;
-        format_push_char_safe('0' + digit);
-
-        ch = decimalMark;
-    }
-    value /= 10;
-
-    groupIndex = 0;
-    while ((zeroNeeded || value > 0) && (*size) > 1)
-    {
-        // Append group separator
-        if (groupIndex == 3)
-        {
-            groupIndex = 0;
-            ch = commaMark;
-        }
-
-        if (ch != nullptr)
-        {
-            format_push_char_safe(*ch++);
-            if (*ch == '\0')
-                ch = nullptr;
-        }
-        else
-        {
-            zeroNeeded = 0;
-            digit = value % 10;
-            value /= 10;
-
-            format_push_char_safe('0' + digit);
-            groupIndex++;
-        }
-    }
-
-    if (zeroNeeded || value > 0)
-    {
-        ncur = nbegin;
-
-        while (zeroNeeded || value > 0)
-        {
-            // Append group separator
-            if (groupIndex == 3)
-            {
-                groupIndex = 0;
-                ch = commaMark;
-            }
-
-            if (ch != nullptr)
-            {
-                format_push_wrap(*ch++);
-                if (*ch == '\0')
-                    ch = nullptr;
-            }
-            else
-            {
-                zeroNeeded = 0;
-                digit = value % 10;
-                value /= 10;
-
-                format_push_wrap('0' + digit);
-                groupIndex++;
-            }
-        }
-
-        // Reverse first half of string
-        nend = ncur - 1;
-        reverse_string();
+    format_number(dest, size, value, 0, false);
+}
 
-        // Reverse second half of string
-        nbegin = ncur;
-        nend = (*dest) - 1;
-        reverse_string();
+static void format_comma_separated_integer(char** dest, size_t* size, int64_t value)
+{
+    format_number(dest, size, value, 0, true);
+}
 
-        format_push_char_safe('\0'); // Truncate overflowed string
-    }
-    else
-    {
-        // Reverse string
-        nend = *dest - 1;
-        reverse_string();
-    }
+static void format_comma_separated_fixed_1dp(char** dest, size_t* size, int64_t value)
+{
+    format_number(dest, size, value, 1, true);
 }
 
 static void format_comma_separated_fixed_2dp(char** dest, size_t* size, int64_t value)
 {
-    int32_t digit, groupIndex;
-    char *nbegin, *nend, *ncur;
-    char tmp;
-    const char* commaMark = language_get_string(STR_LOCALE_THOUSANDS_SEPARATOR);
-    const char* decimalMark = language_get_string(STR_LOCALE_DECIMAL_POINT);
-    const char* ch = nullptr;
-    int32_t zeroNeeded = 1;
-
-    if ((*size) == 0)
-        return;
-
-    // Negative sign
-    if (value < 0)
-    {
-        format_push_char('-');
-        value = -value;
-    }
-
-    nbegin = (*dest);
-
-    // In the case of buffers this small,
-    // all of this would be truncated anyways.
-    format_handle_overflow(1);
-    if ((*size) < 3)
-    {
-        value /= 100;
-    }
-    else
-    {
-        // Two decimal places
-        digit = value % 10;
-        value /= 10;
-        format_push_char_safe('0' + digit);
-
-        digit = value % 10;
-        value /= 10;
-        format_push_char_safe('0' + digit);
-
-        ch = decimalMark;
-    }
-
-    groupIndex = 0;
-    while ((zeroNeeded || value > 0) && (*size) > 1)
-    {
-        // Append group separator
-        if (groupIndex == 3)
-        {
-            groupIndex = 0;
-            ch = commaMark;
-        }
-
-        if (ch != nullptr)
-        {
-            format_push_char_safe(*ch++);
-            if (*ch == '\0')
-                ch = nullptr;
-        }
-        else
-        {
-            zeroNeeded = 0;
-            digit = value % 10;
-            value /= 10;
-
-            format_push_char_safe('0' + digit);
-            groupIndex++;
-        }
-    }
-
-    if (zeroNeeded || value > 0)
-    {
-        ncur = nbegin;
-
-        while (zeroNeeded || value > 0)
-        {
-            // Append group separator
-            if (groupIndex == 3)
-            {
-                groupIndex = 0;
-                ch = commaMark;
-            }
-
-            if (ch != nullptr)
-            {
-                format_push_wrap(*ch++);
-                if (*ch == '\0')
-                    ch = nullptr;
-            }
-            else
-            {
-                zeroNeeded = 0;
-                digit = value % 10;
-                value /= 10;
-
-                format_push_wrap('0' + digit);
-                groupIndex++;
-            }
-        }
-
-        // Reverse first half of string
-        nend = ncur - 1;
-        reverse_string();
-
-        // Reverse second half of string
-        nbegin = ncur;
-        nend = (*dest) - 1;
-        reverse_string();
-
-        format_push_char_safe('\0'); // Truncate overflowed string
-    }
-    else
-    {
-        // Reverse string
-        nend = *dest - 1;
-        reverse_string();
-    }
+    format_number(dest, size, value, 2, true);
 }
 
 static void format_currency(char** dest, size_t* size, int64_t value)
@@ -1153,7 +832,7 @@ static void format_string_code(uint32_t format_code, char** dest, size_t* size,
     }
 }
 
-static void format_string_part_from_raw(utf8** dest, size_t* size, const utf8* src, char** args)
+static void format_string_part_from_raw(utf8** dest, size_t* size, const utf8* src, const utf8* end, char** args)
 {
 #ifdef DEBUG
     if (gDebugStringFormatting)
@@ -1162,7 +841,7 @@ static void format_string_part_from_raw(utf8** dest, size_t* size, const utf8* s
     }
 #endif
 
-    while (*size > 1)
+    while (*size > 1 && src != end)
     {
         uint32_t code = utf8_get_next(src, &src);
         if (code < ' ')
@@ -1220,6 +899,147 @@ static void format_string_part_from_raw(utf8** dest, size_t* size, const utf8* s
     }
 }
 
+/**
+ * A language string split into the runs of text copied as they are and the format codes that take arguments, so it
+ * does not have to be decoded every time it is formatted.
+ */
+struct FormatTemplate
+{
+    struct Op
+    {
+        // The format code, or 0 for a run of text
+        uint32_t Code;
+        uint32_t Offset;
+        uint32_t Length;
+    };
+
+    const utf8* Source{};
+    uint32_t Generation{};
+    bool IsCompiled{};
+    std::vector<Op> Ops;
+};
+
+static std::atomic<uint32_t> _formatTemplateGeneration;
+// Each thread compiles its own templates so formatting does not need a lock
+static thread_local std::unordered_map<rct_string_id, FormatTemplate> _formatTemplates;
+
+/**
+ * Splits the string the same way format_string_part_from_raw walks it. A string that would not be copied byte for byte
+ * is not compiled and is formatted from the raw string instead.
+ */
+static void format_compile_template(FormatTemplate& formatTemplate, const utf8* src)
+{
+    formatTemplate.Source = src;
+    formatTemplate.IsCompiled = false;
+    formatTemplate.Ops.clear();
+
+    const utf8* ch = src;
+    for (;;)
+    {
+        const utf8* codeStart = ch;
+        uint32_t code = utf8_get_next(ch, &ch);
+        if (code == 0)
+        {
+            break;
+        }
+
+        if (code < ' ')
+        {
+            int32_t argLength = code <= 4 ? 1 : (code <= 16 ? 0 : (code <= 22 ? 2 : 4));
+            for (int32_t i = 0; i < argLength; i++)
+            {
+                if (*ch++ == '\0')
+                {
+                    return;
+                }
+            }
+        }
+        else if (code > 'z' && (code < FORMAT_COLOUR_CODE_START || code == FORMAT_COMMA1DP16))
+        {
+            formatTemplate.Ops.push_back({ code, 0, 0 });
+            continue;
+        }
+        else if (code > 'z')
+        {
+            utf8 encoded[8];
+            auto encodedLength = (size_t)(utf8_write_codepoint(encoded, code) - encoded);
+            if (encodedLength != (size_t)(ch - codeStart) || std::memcmp(encoded, codeStart, encodedLength) != 0)
+            {
+                // Not encoded the way it would be written back
+                return;
+            }
+        }
+
+        auto offset = (uint32_t)(codeStart - src);
+        auto length = (uint32_t)(ch - codeStart);
+        if (!formatTemplate.Ops.empty() && formatTemplate.Ops.back().Code == 0)
+        {
+            formatTemplate.Ops.back().Length += length;
+        }
+        else
+        {
+            formatTemplate.Ops.push_back({ 0, offset, length });
+        }
+    }
+    formatTemplate.IsCompiled = true;
+}
+
+static const FormatTemplate* format_get_template(rct_string_id format, const utf8* src)
+{
+    auto& formatTemplate = _formatTemplates[format];
+    uint32_t generation = _formatTemplateGeneration;
+    if (formatTemplate.Source != src || formatTemplate.Generation != generation)
+    {
+        format_compile_template(formatTemplate, src);
+        formatTemplate.Generation = generation;
+    }
+    return formatTemplate.IsCompiled ? &formatTemplate : nullptr;
+}
+
+/**
+ * Makes the compiled language strings be compiled again the next time they are formatted, for when strings are
+ * changed.
+ */
+void format_string_invalidate_templates()
+{
+    _formatTemplateGeneration++;
+}
+
+static void format_string_part_from_template(utf8** dest, size_t* size, const FormatTemplate& formatTemplate, char** args)
+{
+#ifdef DEBUG
+    if (gDebugStringFormatting)
+    {
+        printf("format_string_part_from_raw(\"%s\")\n", formatTemplate.Source);
+    }
+#endif
+
+    for (const auto& op : formatTemplate.Ops)
+    {
+        if (*size <= 1)
+        {
+            break;
+        }
+
+        if (op.Code != 0)
+        {
+            format_string_code(op.Code, dest, size, args);
+        }
+        else if (op.Length < *size)
+        {
+            std::memcpy(*dest, formatTemplate.Source + op.Offset, op.Length);
+            *dest += op.Length;
+            *size -= op.Length;
+        }
+        else
+        {
+            // Truncated the same way as the raw string, without splitting characters or format codes
+            const utf8* text = formatTemplate.Source + op.Offset;
+            format_string_part_from_raw(dest, size, text, text + op.Length, args);
+        }
+    }
+}
+
 static void format_string_part(utf8** dest, size_t* size, rct_string_id format, char** args)
 {
     if (format == STR_NONE)
@@ -1233,7 +1053,15 @@ static void format_string_part(utf8** dest, size_t* size, rct_string_id format,
     {
         // Language string
         const utf8* rawString = language_get_string(format);
-        format_string_part_from_raw(dest, size, rawString, args);
+        auto formatTemplate = format_get_template(format, rawString);
+        if (formatTemplate != nullptr)
+        {
+            format_string_part_from_template(dest, size, *formatTemplate, args);
+        }
+        else
+        {
+            format_string_part_from_raw(dest, size, rawString, nullptr, args);
+        }
     }
     else if (format <= USER_STRING_END)
     {
@@ -1269,16 +1097,12 @@ static void format_string_part(utf8** dest, size_t* size, rct_string_id format,
 
 std::string format_string(rct_string_id format, const void* args)
 {
-    std::string buffer(256, 0);
-    size_t len{};
+    // Formatted into a buffer kept by the thread so only the returned string is allocated
+    thread_local std::vector<utf8> buffer(256);
     for (;;)
     {
         format_string(buffer.data(), buffer.size(), format, args);
-        len = buffer.find('\0');
-        if (len == std::string::npos)
-        {
-            len = buffer.size();
-        }
+        size_t len = strnlen(buffer.data(), buffer.size());
         if (len >= buffer.size() - 1)
         {
             // Null terminator to close to end of buffer, grow buffer and try again
@@ -1286,11 +1110,9 @@ std::string format_string(rct_string_id format, const void* args)
         }
         else
         {
-            buffer.resize(len);
-            break;
+            return std::string(buffer.data(), len);
         }
     }
-    return buffer;
 }
 
 /**
@@ -1351,7 +1173,7 @@ void format_string_raw(utf8* dest, size_t size, const utf8* src, const void* arg
 
     utf8* end = dest;
     size_t left = size;
-    format_string_part_from_raw(&end, &left, src, (char**)&args);
+    format_string_part_from_raw(&end, &left, src, nullptr, (char**)&args);
     if (left == 0)
     {
         // Replace last character with null terminator
@@ -16,6 +16,7 @@
 #include "../object/ObjectManager.h"
 #include "Language.h"
 #include "LanguagePack.h"
+#include "Localisation.h"
 #include "StringIds.h"
 
 #include <stdexcept>
@@ -96,6 +97,7 @@ void LocalisationService::OpenLanguage(int32_t id, IObjectManager& objectManager
     {
         _currentLanguage = id;
         TryLoadFonts(*this);
+        format_string_invalidate_templates();
 
         // Objects and their localised strings need to be refreshed
         objectManager.ResetObjects();
@@ -111,6 +113,7 @@ void LocalisationService::CloseLanguages()
     _languageFallback = nullptr;
     _languageCurrent = nullptr;
     _currentLanguage = LANGUAGE_UNDEFINED;
+    format_string_invalidate_templates();
 }
 
 std::tuple<rct_string_id, rct_string_id, rct_string_id> LocalisationService::GetLocalisedScenarioStrings(
@@ -136,6 +139,7 @@ rct_string_id LocalisationService::AllocateObjectString(const std::string& targe
     auto stringId = _availableObjectStringIds.top();
     _availableObjectStringIds.pop();
     _languageCurrent->SetString(stringId, target);
+    format_string_invalidate_templates();
     return stringId;
 }
 
@@ -146,6 +150,7 @@ void LocalisationService::FreeObjectString(rct_string_id stringId)
         if (_languageCurrent != nullptr)
         {
             _languageCurrent->RemoveString(stringId);
+            format_string_invalidate_templates();
         }
         _availableObjectStringIds.push(stringId);
     }
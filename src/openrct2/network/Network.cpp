@@ -31,7 +31,7 @@
 // This string specifies which version of network stream current build uses.
 // It is used for making sure only compatible builds get connected, even within
 // single OpenRCT2 version.
-#define NETWORK_STREAM_VERSION "2"
+#define NETWORK_STREAM_VERSION "4"
 #define NETWORK_STREAM_ID OPENRCT2_VERSION "-" NETWORK_STREAM_VERSION
 
 static Peep* _pickup_peep = nullptr;
@@ -46,6 +46,7 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 #    include "../Cheats.h"
 #    include "../ParkImporter.h"
 #    include "../Version.h"
+#    include "../actions/BatchAction.hpp"
 #    include "../actions/GameAction.h"
 #    include "../config/Config.h"
 #    include "../core/Console.hpp"
@@ -68,6 +69,7 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 #    include "NetworkAction.h"
 #    include "NetworkConnection.h"
 #    include "NetworkGroup.h"
+#    include "NetworkIOThread.h"
 #    include "NetworkKey.h"
 #    include "NetworkPacket.h"
 #    include "NetworkPlayer.h"
@@ -179,6 +181,8 @@ public:
     void Client_Send_GAME_ACTION(const GameAction* action);
     void Server_Send_GAME_ACTION(const GameAction* action);
     void Server_Send_TICK();
+    void Server_Send_FRAME();
+    void Server_Continue_FRAME();
     void Server_Send_PLAYERINFO(int32_t playerId);
     void Server_Send_PLAYERLIST();
     void Client_Send_PING();
@@ -215,6 +219,7 @@ private:
     void CloseConnection();
 
     bool ProcessConnection(NetworkConnection& connection);
+    bool ProcessIOThreadedConnection(NetworkConnection& connection);
     void ProcessPacket(NetworkConnection& connection, NetworkPacket& packet);
     void AddClient(std::unique_ptr<ITcpSocket>&& socket);
     void ServerClientDisconnected(std::unique_ptr<NetworkConnection>& connection);
@@ -243,6 +248,30 @@ private:
     };
 
     std::map<uint32_t, ServerTickData_t> _serverTickData;
+
+    // The tick currently being run by the server and the game actions executed during it, sent as one frame
+    struct PendingFrame
+    {
+        bool Active = false;
+        uint32_t Tick = 0;
+        uint32_t Srand0 = 0;
+        uint32_t Flags = 0;
+        rct_sprite_checksum Checksum = {};
+        uint32_t NumActions = 0;
+        NetworkPacket Actions;
+    };
+    PendingFrame _pendingFrame;
+
+    // The compressed map last sent to a joining client, split into MAP packets that share their payload with every
+    // connection it is queued on. Clients joining during the same tick get the same map unless an action changed it.
+    struct MapPayloadCache
+    {
+        bool Valid = false;
+        uint32_t Tick = 0;
+        std::vector<const ObjectRepositoryItem*> Objects;
+        std::vector<std::unique_ptr<NetworkPacket>> Chunks;
+    };
+    MapPayloadCache _mapPayloadCache;
     std::map<uint32_t, PlayerListUpdate> _pendingPlayerLists;
     std::multimap<uint32_t, NetworkPlayer> _pendingPlayerInfo;
     bool _playerListInvalidated = false;
@@ -256,6 +285,7 @@ private:
     std::unique_ptr<ITcpSocket> _listenSocket;
     std::unique_ptr<NetworkConnection> _serverConnection;
     std::unique_ptr<INetworkServerAdvertiser> _advertiser;
+    std::unique_ptr<INetworkIOThread> _ioThread;
     uint16_t listening_port = 0;
     SOCKET_STATUS _lastConnectStatus = SOCKET_STATUS_CLOSED;
     uint32_t last_ping_sent_time = 0;
@@ -294,6 +324,9 @@ private:
     void Client_Handle_GAME_ACTION(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Handle_GAME_ACTION(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_TICK(NetworkConnection& connection, NetworkPacket& packet);
+    void Client_Handle_FRAME(NetworkConnection& connection, NetworkPacket& packet);
+    void Client_ReceiveTick(uint32_t serverTick, uint32_t srand0, const std::string& spriteHash);
+    void Client_ReceiveGameAction(uint32_t tick, uint32_t actionType, const uint8_t* data, size_t size);
     void Client_Handle_PLAYERINFO(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_PLAYERLIST(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_PING(NetworkConnection& connection, NetworkPacket& packet);
@@ -332,6 +365,7 @@ Network::Network()
     client_command_handlers[NETWORK_COMMAND_CHAT] = &Network::Client_Handle_CHAT;
     client_command_handlers[NETWORK_COMMAND_GAME_ACTION] = &Network::Client_Handle_GAME_ACTION;
     client_command_handlers[NETWORK_COMMAND_TICK] = &Network::Client_Handle_TICK;
+    client_command_handlers[NETWORK_COMMAND_FRAME] = &Network::Client_Handle_FRAME;
     client_command_handlers[NETWORK_COMMAND_PLAYERLIST] = &Network::Client_Handle_PLAYERLIST;
     client_command_handlers[NETWORK_COMMAND_PLAYERINFO] = &Network::Client_Handle_PLAYERINFO;
     client_command_handlers[NETWORK_COMMAND_PING] = &Network::Client_Handle_PING;
@@ -413,6 +447,8 @@ void Network::Close()
         CloseConnection();
 
         client_connection_list.clear();
+        _pendingFrame.Active = false;
+        _mapPayloadCache = {};
         GameActions::ClearQueue();
         GameActions::ResumeQueue();
         player_list.clear();
@@ -450,6 +486,7 @@ void Network::CloseConnection()
     }
     else if (mode == NETWORK_MODE_SERVER)
     {
+        _ioThread.reset();
         _listenSocket.reset();
         _advertiser.reset();
     }
@@ -588,6 +625,15 @@ bool Network::BeginServer(uint16_t port, const std::string& address)
         return false;
     }
 
+    if (gConfigNetwork.io_thread)
+    {
+        _ioThread = CreateNetworkIOThread();
+        if (_ioThread == nullptr)
+        {
+            log_warning("Network I/O thread is not supported on this platform, using the game thread.");
+        }
+    }
+
     ServerName = gConfigNetwork.server_name;
     ServerDescription = gConfigNetwork.server_description;
     ServerGreeting = gConfigNetwork.server_greeting;
@@ -698,6 +744,7 @@ void Network::Flush()
     }
     else
     {
+        Server_Send_FRAME();
         for (auto& it : client_connection_list)
         {
             it->SendQueuedPackets();
@@ -915,6 +962,9 @@ const char* Network::FormatChat(NetworkPlayer* fromplayer, const char* text)
 
 void Network::SendPacketToClients(NetworkPacket& packet, bool front, bool gameCmd)
 {
+    // Keep everything else in order with the frame of the tick it was sent during
+    Server_Send_FRAME();
+
     for (auto& client_connection : client_connection_list)
     {
         if (client_connection->IsDisconnected)
@@ -1511,34 +1561,50 @@ void Network::Server_Send_MAP(NetworkConnection* connection)
         objects = objManager.GetPackableObjects();
     }
 
-    size_t out_size;
-    uint8_t* header = save_for_network(out_size, objects);
-    if (header == nullptr)
+    // Sending to all clients happens when a new map has been loaded, which may not have changed the tick
+    auto& cache = _mapPayloadCache;
+    if (connection == nullptr || !cache.Valid || cache.Tick != gCurrentTicks || cache.Objects != objects)
     {
-        if (connection)
+        cache = {};
+
+        size_t out_size;
+        uint8_t* header = save_for_network(out_size, objects);
+        if (header == nullptr)
         {
-            connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
-            connection->Socket->Disconnect();
+            if (connection)
+            {
+                connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+                connection->Socket->Disconnect();
+            }
+            return;
         }
-        return;
+        size_t chunksize = CHUNK_SIZE;
+        for (size_t i = 0; i < out_size; i += chunksize)
+        {
+            size_t datasize = std::min(chunksize, out_size - i);
+            std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
+            *packet << (uint32_t)NETWORK_COMMAND_MAP << (uint32_t)out_size << (uint32_t)i;
+            packet->Write(&header[i], datasize);
+            cache.Chunks.push_back(std::move(packet));
+        }
+        free(header);
+
+        cache.Valid = true;
+        cache.Tick = gCurrentTicks;
+        cache.Objects = objects;
     }
-    size_t chunksize = CHUNK_SIZE;
-    for (size_t i = 0; i < out_size; i += chunksize)
+
+    for (auto& chunk : cache.Chunks)
     {
-        size_t datasize = std::min(chunksize, out_size - i);
-        std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
-        *packet << (uint32_t)NETWORK_COMMAND_MAP << (uint32_t)out_size << (uint32_t)i;
-        packet->Write(&header[i], datasize);
         if (connection)
         {
-            connection->QueuePacket(std::move(packet));
+            connection->QueuePacket(NetworkPacket::Duplicate(*chunk));
         }
         else
         {
-            SendPacketToClients(*packet);
+            SendPacketToClients(*chunk);
         }
     }
-    free(header);
 }
 
 uint8_t* Network::save_for_network(size_t& out_size, const std::vector<const ObjectRepositoryItem*>& objects) const
@@ -1633,11 +1699,31 @@ void Network::Client_Send_GAME_ACTION(const GameAction* action)
 
 void Network::Server_Send_GAME_ACTION(const GameAction* action)
 {
-    std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
+    // The map has changed since it was last sent
+    _mapPayloadCache.Valid = false;
 
     DataSerialiser stream(true);
     action->Serialise(stream);
 
+    if (_pendingFrame.Active && _pendingFrame.Tick == gCurrentTicks)
+    {
+        // Add to the frame of the current tick rather than sending a packet of its own
+        auto& ms = stream.GetStream();
+        // The type and length take up at most 5 bytes each
+        const size_t actionSize = 10 + ms.GetLength();
+        if (_pendingFrame.NumActions != 0 && _pendingFrame.Actions.Data->size() + actionSize > CHUNK_SIZE)
+        {
+            Server_Continue_FRAME();
+        }
+        openrct2_assert(actionSize <= CHUNK_SIZE, "Game action of %u bytes does not fit in a packet", (uint32_t)actionSize);
+        _pendingFrame.Actions.WriteVarInt(action->GetType());
+        _pendingFrame.Actions.WriteVarInt((uint32_t)ms.GetLength());
+        _pendingFrame.Actions.Write((const uint8_t*)ms.GetData(), ms.GetLength());
+        _pendingFrame.NumActions++;
+        return;
+    }
+
+    std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
     *packet << (uint32_t)NETWORK_COMMAND_GAME_ACTION << gCurrentTicks << action->GetType() << stream;
 
     SendPacketToClients(*packet);
@@ -1645,9 +1731,19 @@ void Network::Server_Send_GAME_ACTION(const GameAction* action)
 
 void Network::Server_Send_TICK()
 {
-    std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
-    *packet << (uint32_t)NETWORK_COMMAND_TICK << gCurrentTicks << scenario_rand_state().s0;
-    uint32_t flags = 0;
+    // Only start the frame here, it is sent once the tick is complete along with the game actions executed in it.
+    Server_Send_FRAME();
+
+    // The tick is about to change the map, release the payload rather than keeping it until the next join
+    _mapPayloadCache = {};
+
+    _pendingFrame.Active = true;
+    _pendingFrame.Tick = gCurrentTicks;
+    _pendingFrame.Srand0 = scenario_rand_state().s0;
+    _pendingFrame.Flags = 0;
+    _pendingFrame.NumActions = 0;
+    _pendingFrame.Actions.Clear();
+
     // Simple counter which limits how often a sprite checksum gets sent.
     // This can get somewhat expensive, so we don't want to push it every tick in release,
     // but debug version can check more often.
@@ -1656,20 +1752,52 @@ void Network::Server_Send_TICK()
     if (checksum_counter >= 100)
     {
         checksum_counter = 0;
-        flags |= NETWORK_TICK_FLAG_CHECKSUMS;
+        _pendingFrame.Flags |= NETWORK_TICK_FLAG_CHECKSUMS;
+        _pendingFrame.Checksum = sprite_checksum();
     }
-    // Send flags always, so we can understand packet structure on the other end,
-    // and allow for some expansion.
-    *packet << flags;
-    if (flags & NETWORK_TICK_FLAG_CHECKSUMS)
+}
+
+/**
+ * Sends the pending frame, the tick header followed by the game actions executed during that tick. Everything other
+ * than the 32 bit command is variable length encoded and the checksum is sent in binary.
+ */
+void Network::Server_Send_FRAME()
+{
+    if (!_pendingFrame.Active)
     {
-        rct_sprite_checksum checksum = sprite_checksum();
-        packet->WriteString(checksum.ToString().c_str());
+        return;
     }
+    _pendingFrame.Active = false;
 
+    std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
+    *packet << (uint32_t)NETWORK_COMMAND_FRAME;
+    packet->WriteVarInt(_pendingFrame.Tick);
+    *packet << _pendingFrame.Srand0;
+    packet->WriteVarInt(_pendingFrame.Flags);
+    if (_pendingFrame.Flags & NETWORK_TICK_FLAG_CHECKSUMS)
+    {
+        packet->Write(_pendingFrame.Checksum.raw.data(), _pendingFrame.Checksum.raw.size());
+    }
+    packet->WriteVarInt(_pendingFrame.NumActions);
+    packet->Write(_pendingFrame.Actions.Data->data(), _pendingFrame.Actions.Data->size());
     SendPacketToClients(*packet);
 }
 
+/**
+ * Sends the game actions of the pending frame so far and starts another frame for the same tick, so the packet stays
+ * within its 16 bit length. Clients read the same tick twice and queue the actions of both frames in order.
+ */
+void Network::Server_Continue_FRAME()
+{
+    Server_Send_FRAME();
+
+    // The checksum has been sent with the first part already
+    _pendingFrame.Active = true;
+    _pendingFrame.Flags &= ~NETWORK_TICK_FLAG_CHECKSUMS;
+    _pendingFrame.NumActions = 0;
+    _pendingFrame.Actions.Clear();
+}
+
 void Network::Server_Send_PLAYERINFO(int32_t playerId)
 {
     std::unique_ptr<NetworkPacket> packet(NetworkPacket::Allocate());
@@ -1807,6 +1935,11 @@ void Network::Server_Send_EVENT_PLAYER_DISCONNECTED(const char* playerName, cons
 
 bool Network::ProcessConnection(NetworkConnection& connection)
 {
+    if (connection.IsIOThreaded())
+    {
+        return ProcessIOThreadedConnection(connection);
+    }
+
     int32_t packetStatus;
     do
     {
@@ -1848,6 +1981,38 @@ bool Network::ProcessConnection(NetworkConnection& connection)
     return true;
 }
 
+bool Network::ProcessIOThreadedConnection(NetworkConnection& connection)
+{
+    // The socket is read by the I/O thread, only the packets it has received need processing here
+    std::unique_ptr<NetworkPacket> packet;
+    while ((packet = connection.PopReceivedPacket()) != nullptr)
+    {
+        ProcessPacket(connection, *packet);
+        if (connection.Socket == nullptr)
+        {
+            return false;
+        }
+    }
+    if (connection.IsIODisconnected())
+    {
+        if (!connection.GetLastDisconnectReason())
+        {
+            connection.SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+        }
+        return false;
+    }
+    connection.SendQueuedPackets();
+    if (!connection.ReceivedPacketRecently())
+    {
+        if (!connection.GetLastDisconnectReason())
+        {
+            connection.SetLastDisconnectReason(STR_MULTIPLAYER_NO_DATA);
+        }
+        return false;
+    }
+    return true;
+}
+
 void Network::ProcessPacket(NetworkConnection& connection, NetworkPacket& packet)
 {
     uint32_t command;
@@ -1990,6 +2155,10 @@ void Network::ProcessDisconnectedClients()
             ServerClientDisconnected(connection);
             RemovePlayer(connection);
 
+            if (_ioThread != nullptr)
+            {
+                _ioThread->RemoveConnection(*connection);
+            }
             it = client_connection_list.erase(it);
         }
         else
@@ -2009,6 +2178,11 @@ void Network::AddClient(std::unique_ptr<ITcpSocket>&& socket)
     // Store connection
     auto connection = std::make_unique<NetworkConnection>();
     connection->Socket = std::move(socket);
+    if (_ioThread != nullptr)
+    {
+        connection->AttachIOThread(_ioThread.get());
+        _ioThread->AddConnection(*connection);
+    }
 
     client_connection_list.push_back(std::move(connection));
 }
@@ -2834,9 +3008,14 @@ void Network::Client_Handle_GAME_ACTION([[maybe_unused]] NetworkConnection& conn
     uint32_t actionType;
     packet >> tick >> actionType;
 
-    MemoryStream stream;
     size_t size = packet.Size - packet.BytesRead;
-    stream.WriteArray(packet.Read(size), size);
+    Client_ReceiveGameAction(tick, actionType, packet.Read(size), size);
+}
+
+void Network::Client_ReceiveGameAction(uint32_t tick, uint32_t actionType, const uint8_t* data, size_t size)
+{
+    MemoryStream stream;
+    stream.WriteArray(data, size);
     stream.SetPosition(0);
 
     DataSerialiser ds(false, stream);
@@ -2883,9 +3062,9 @@ void Network::Server_Handle_GAME_ACTION(NetworkConnection& connection, NetworkPa
         return;
     }
 
-    // Check if player's group permission allows command to run
+    // Check if player's group permission allows command to run, a batch is checked per action once it has been read
     NetworkGroup* group = GetGroupByID(connection.Player->Group);
-    if (group == nullptr || group->CanPerformCommand(actionType) == false)
+    if (group == nullptr || (actionType != GAME_COMMAND_BATCH && group->CanPerformCommand(actionType) == false))
     {
         Server_Send_SHOWERROR(connection, STR_CANT_DO_THIS, STR_PERMISSION_DENIED);
         return;
@@ -2901,35 +3080,62 @@ void Network::Server_Handle_GAME_ACTION(NetworkConnection& connection, NetworkPa
         return;
     }
 
+    DataSerialiser stream(false);
+    size_t size = packet.Size - packet.BytesRead;
+    stream.GetStream().WriteArray(packet.Read(size), size);
+    stream.GetStream().SetPosition(0);
+
+    ga->Serialise(stream);
+    // Set player to sender, should be 0 if sent from client.
+    ga->SetPlayer(NetworkPlayerId_t{ connection.Player->Id });
+
+    // The actions of a batch are subject to the same permissions and cooldowns as when sent one by one. Every type is
+    // checked before any cooldown is set so a rejected action leaves none behind, and each type gets its cooldown only
+    // once so a batch may contain the same type several times.
+    std::map<uint32_t, uint32_t> cooldownTimes;
+    cooldownTimes[actionType] = ga->GetCooldownTime();
+    if (actionType == GAME_COMMAND_BATCH)
+    {
+        for (const auto& action : static_cast<const BatchAction&>(*ga).GetActions())
+        {
+            uint32_t type = action->GetType();
+            if (type == GAME_COMMAND_TOGGLE_PAUSE || type == GAME_COMMAND_LOAD_OR_QUIT
+                || group->CanPerformCommand(type) == false)
+            {
+                Server_Send_SHOWERROR(connection, STR_CANT_DO_THIS, STR_PERMISSION_DENIED);
+                return;
+            }
+
+            uint32_t& cooldownTime = cooldownTimes[type];
+            cooldownTime = std::max(cooldownTime, action->GetCooldownTime());
+
+            // Only the flags of the batch apply to its actions, the client can't set flags such as ghost per action
+            action->SetFlags(0);
+        }
+    }
+
     // Player who is hosting is not affected by cooldowns.
     if ((player->Flags & NETWORK_PLAYER_FLAG_ISSERVER) == 0)
     {
-        auto cooldownIt = player->CooldownTime.find(actionType);
-        if (cooldownIt != std::end(player->CooldownTime))
+        for (const auto& cooldown : cooldownTimes)
         {
-            if (cooldownIt->second > 0)
+            auto cooldownIt = player->CooldownTime.find(cooldown.first);
+            if (cooldownIt != std::end(player->CooldownTime) && cooldownIt->second > 0)
             {
                 Server_Send_SHOWERROR(connection, STR_CANT_DO_THIS, STR_NETWORK_ACTION_RATE_LIMIT_MESSAGE);
                 return;
             }
         }
 
-        uint32_t cooldownTime = ga->GetCooldownTime();
-        if (cooldownTime > 0)
+        for (const auto& cooldown : cooldownTimes)
         {
-            player->CooldownTime[actionType] = cooldownTime;
+            if (cooldown.second > 0)
+            {
+                player->CooldownTime[cooldown.first] = cooldown.second;
+            }
         }
     }
 
-    DataSerialiser stream(false);
-    size_t size = packet.Size - packet.BytesRead;
-    stream.GetStream().WriteArray(packet.Read(size), size);
-    stream.GetStream().SetPosition(0);
-
-    ga->Serialise(stream);
-    // Set player to sender, should be 0 if sent from client.
-    ga->SetPlayer(NetworkPlayerId_t{ connection.Player->Id });
-
     GameActions::Enqueue(std::move(ga), tick);
 }
 
@@ -2941,18 +3147,76 @@ void Network::Client_Handle_TICK([[maybe_unused]] NetworkConnection& connection,
 
     packet >> serverTick >> srand0 >> flags;
 
-    ServerTickData_t tickData;
-    tickData.srand0 = srand0;
-    tickData.tick = serverTick;
-
+    std::string spriteHash;
     if (flags & NETWORK_TICK_FLAG_CHECKSUMS)
     {
         const char* text = packet.ReadString();
         if (text != nullptr)
         {
-            tickData.spriteHash = text;
+            spriteHash = text;
+        }
+    }
+    Client_ReceiveTick(serverTick, srand0, spriteHash);
+}
+
+void Network::Client_Handle_FRAME([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
+{
+    uint32_t serverTick;
+    uint32_t srand0;
+    uint32_t flags;
+    if (!packet.ReadVarInt(serverTick))
+    {
+        return;
+    }
+    packet >> srand0;
+    if (!packet.ReadVarInt(flags))
+    {
+        return;
+    }
+
+    std::string spriteHash;
+    if (flags & NETWORK_TICK_FLAG_CHECKSUMS)
+    {
+        rct_sprite_checksum checksum;
+        const uint8_t* raw = packet.Read(checksum.raw.size());
+        if (raw == nullptr)
+        {
+            return;
         }
+        std::copy_n(raw, checksum.raw.size(), checksum.raw.begin());
+        spriteHash = checksum.ToString();
+    }
+    Client_ReceiveTick(serverTick, srand0, spriteHash);
+
+    // The game actions the server executed during this tick
+    uint32_t numActions;
+    if (!packet.ReadVarInt(numActions))
+    {
+        return;
     }
+    for (uint32_t i = 0; i < numActions; i++)
+    {
+        uint32_t actionType;
+        uint32_t size;
+        if (!packet.ReadVarInt(actionType) || !packet.ReadVarInt(size))
+        {
+            return;
+        }
+        const uint8_t* data = packet.Read(size);
+        if (data == nullptr)
+        {
+            return;
+        }
+        Client_ReceiveGameAction(serverTick, actionType, data, size);
+    }
+}
+
+void Network::Client_ReceiveTick(uint32_t serverTick, uint32_t srand0, const std::string& spriteHash)
+{
+    ServerTickData_t tickData;
+    tickData.srand0 = srand0;
+    tickData.tick = serverTick;
+    tickData.spriteHash = spriteHash;
 
     // Don't let the history grow too much.
     while (_serverTickData.size() >= 100)
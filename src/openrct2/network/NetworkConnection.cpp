@@ -17,9 +17,16 @@
 #    include "Socket.h"
 #    include "network.h"
 
+#    include <algorithm>
+#    include <cstring>
+
 constexpr size_t NETWORK_DISCONNECT_REASON_BUFFER_SIZE = 256;
+constexpr size_t MAX_PACKETS_PER_SEND = 32;
+// Large enough to always hold a complete packet of the largest possible size.
+constexpr size_t RECEIVE_BUFFER_SIZE = 128 * 1024;
 
 NetworkConnection::NetworkConnection()
+    : _receiveBuffer(RECEIVE_BUFFER_SIZE)
 {
     ResetLastPacketTime();
 }
@@ -31,113 +38,314 @@ NetworkConnection::~NetworkConnection()
 
 int32_t NetworkConnection::ReadPacket()
 {
-    if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Size))
+    int32_t status = ReceivePacket();
+    if (status == NETWORK_READPACKET_SUCCESS)
+    {
+        _lastPacketTime = platform_get_ticks();
+
+        RecordPacketStats(InboundPacket, false);
+    }
+    return status;
+}
+
+int32_t NetworkConnection::ReceivePacket()
+{
+    // Packets are parsed out of the receive buffer, which is only read into from the socket once it no longer
+    // contains a complete packet. This way many small packets are received with a single call.
+    NETWORK_READPACKET status = NETWORK_READPACKET_MORE_DATA;
+    while (!ParseBufferedPacket())
     {
-        // read packet size
-        void* buffer = &((char*)&InboundPacket.Size)[InboundPacket.BytesTransferred];
-        size_t bufferLength = sizeof(InboundPacket.Size) - InboundPacket.BytesTransferred;
+        if (status == NETWORK_READPACKET_SUCCESS && _receiveBufferEnd != _receiveBuffer.size())
+        {
+            // The last read did not fill the buffer so there is no point reading again this time
+            return NETWORK_READPACKET_MORE_DATA;
+        }
+        if (_receiveBufferStart == _receiveBufferEnd)
+        {
+            _receiveBufferStart = 0;
+            _receiveBufferEnd = 0;
+        }
+        else if (_receiveBufferEnd == _receiveBuffer.size())
+        {
+            // Move the incomplete packet to the front of the buffer to make room for the rest of it
+            std::memmove(
+                _receiveBuffer.data(), &_receiveBuffer[_receiveBufferStart], _receiveBufferEnd - _receiveBufferStart);
+            _receiveBufferEnd -= _receiveBufferStart;
+            _receiveBufferStart = 0;
+        }
+
         size_t readBytes;
-        NETWORK_READPACKET status = Socket->ReceiveData(buffer, bufferLength, &readBytes);
+        status = Socket->ReceiveData(
+            &_receiveBuffer[_receiveBufferEnd], _receiveBuffer.size() - _receiveBufferEnd, &readBytes);
         if (status != NETWORK_READPACKET_SUCCESS)
         {
             return status;
         }
+        _receiveBufferEnd += readBytes;
+    }
+
+    if (InboundPacket.Size == 0) // Can't have a size 0 packet
+    {
+        return NETWORK_READPACKET_DISCONNECTED;
+    }
+    return NETWORK_READPACKET_SUCCESS;
+}
+
+bool NetworkConnection::ParseBufferedPacket()
+{
+    size_t available = _receiveBufferEnd - _receiveBufferStart;
+    uint16_t size;
+    if (available < sizeof(size))
+    {
+        return false;
+    }
+    std::memcpy(&size, &_receiveBuffer[_receiveBufferStart], sizeof(size));
+    size = Convert::NetworkToHost(size);
+    if (size != 0 && available < sizeof(size) + size)
+    {
+        return false;
+    }
+
+    // The payload is copied into the existing inbound packet data, which keeps its capacity between packets
+    const uint8_t* payload = &_receiveBuffer[_receiveBufferStart + sizeof(size)];
+    InboundPacket.Size = size;
+    InboundPacket.Data->assign(payload, payload + size);
+    InboundPacket.BytesTransferred = sizeof(size) + size;
+    _receiveBufferStart += sizeof(size) + size;
+    return true;
+}
 
-        InboundPacket.BytesTransferred += readBytes;
-        if (InboundPacket.BytesTransferred == sizeof(InboundPacket.Size))
+void NetworkConnection::QueuePacket(std::unique_ptr<NetworkPacket> packet, bool front)
+{
+    if (AuthStatus == NETWORK_AUTH_OK || !packet->CommandRequiresAuth())
+    {
+        packet->Size = (uint16_t)packet->Data->size();
+        if (_ioThread != nullptr)
         {
-            InboundPacket.Size = Convert::NetworkToHost(InboundPacket.Size);
-            if (InboundPacket.Size == 0) // Can't have a size 0 packet
+            // The I/O thread owns the outbound queue, statistics are recorded here instead of once sent
+            RecordPacketStats(*packet, true);
+            OutboundPacket outbound{ std::move(packet), front };
+            if (!_ioOutboundOverflow.empty() || !_ioOutboundPackets.TryPush(std::move(outbound)))
             {
-                return NETWORK_READPACKET_DISCONNECTED;
+                // The queue is full, keep the packet until the I/O thread has taken some out
+                _ioOutboundOverflow.push_back(std::move(outbound));
             }
-            InboundPacket.Data->resize(InboundPacket.Size);
+            _ioWakePending = true;
+        }
+        else
+        {
+            AddOutboundPacket(std::move(packet), front);
         }
     }
-    else
+}
+
+void NetworkConnection::AddOutboundPacket(std::unique_ptr<NetworkPacket> packet, bool front)
+{
+    if (front)
     {
-        // read packet data
-        if (InboundPacket.Data->capacity() > 0)
+        // If the first packet was already partially sent add new packet to second position
+        if (!_outboundPackets.empty() && _outboundPackets.front()->BytesTransferred > 0)
         {
-            void* buffer = &InboundPacket.GetData()[InboundPacket.BytesTransferred - sizeof(InboundPacket.Size)];
-            size_t bufferLength = sizeof(InboundPacket.Size) + InboundPacket.Size - InboundPacket.BytesTransferred;
-            size_t readBytes;
-            NETWORK_READPACKET status = Socket->ReceiveData(buffer, bufferLength, &readBytes);
-            if (status != NETWORK_READPACKET_SUCCESS)
-            {
-                return status;
-            }
-
-            InboundPacket.BytesTransferred += readBytes;
+            auto it = _outboundPackets.begin();
+            it++; // Second position
+            _outboundPackets.insert(it, std::move(packet));
         }
-        if (InboundPacket.BytesTransferred == sizeof(InboundPacket.Size) + InboundPacket.Size)
+        else
         {
-            _lastPacketTime = platform_get_ticks();
-
-            RecordPacketStats(InboundPacket, false);
-
-            return NETWORK_READPACKET_SUCCESS;
+            _outboundPackets.push_front(std::move(packet));
         }
     }
-    return NETWORK_READPACKET_MORE_DATA;
+    else
+    {
+        _outboundPackets.push_back(std::move(packet));
+    }
 }
 
-bool NetworkConnection::SendPacket(NetworkPacket& packet)
+void NetworkConnection::SendQueuedPackets()
 {
-    uint16_t sizen = Convert::HostToNetwork(packet.Size);
-    std::vector<uint8_t> tosend;
-    tosend.reserve(sizeof(sizen) + packet.Size);
-    tosend.insert(tosend.end(), (uint8_t*)&sizen, (uint8_t*)&sizen + sizeof(sizen));
-    tosend.insert(tosend.end(), packet.Data->begin(), packet.Data->end());
+    if (_ioThread != nullptr)
+    {
+        while (!_ioOutboundOverflow.empty() && _ioOutboundPackets.TryPush(std::move(_ioOutboundOverflow.front())))
+        {
+            _ioOutboundOverflow.pop_front();
+        }
+        // The I/O thread stopped reading the socket when the received packets did not fit in the queue, any that were
+        // popped since have made room again
+        if (_ioReceiveBlocked.load(std::memory_order_acquire))
+        {
+            _ioReceiveBlocked.store(false, std::memory_order_relaxed);
+            _ioWakePending = true;
+        }
+        if (_ioWakePending)
+        {
+            _ioWakePending = false;
+            _ioThread->Wake();
+        }
+    }
+    else
+    {
+        SendOutboundPackets();
+    }
+}
 
-    const void* buffer = &tosend[packet.BytesTransferred];
-    size_t bufferSize = tosend.size() - packet.BytesTransferred;
-    size_t sent = Socket->SendData(buffer, bufferSize);
-    if (sent > 0)
+void NetworkConnection::SendOutboundPackets()
+{
+    while (!_outboundPackets.empty())
     {
-        packet.BytesTransferred += sent;
+        size_t numPackets = SendPacketBatch();
+        if (numPackets == 0)
+        {
+            break;
+        }
+        for (size_t i = 0; i < numPackets; i++)
+        {
+            _outboundPackets.pop_front();
+        }
     }
+}
+
+void NetworkConnection::AttachIOThread(INetworkIOThread* ioThread)
+{
+    _ioThread = ioThread;
+}
+
+bool NetworkConnection::IsIOThreaded() const
+{
+    return _ioThread != nullptr;
+}
+
+bool NetworkConnection::IsIODisconnected() const
+{
+    return _ioDisconnected.load(std::memory_order_acquire);
+}
 
-    bool sendComplete = packet.BytesTransferred == tosend.size();
-    if (sendComplete)
+std::unique_ptr<NetworkPacket> NetworkConnection::PopReceivedPacket()
+{
+    std::unique_ptr<NetworkPacket> packet;
+    if (!_ioInboundPackets.TryPop(packet))
     {
-        RecordPacketStats(packet, true);
+        return nullptr;
     }
-    return sendComplete;
+
+    _lastPacketTime = platform_get_ticks();
+
+    RecordPacketStats(*packet, false);
+
+    return packet;
 }
 
-void NetworkConnection::QueuePacket(std::unique_ptr<NetworkPacket> packet, bool front)
+bool NetworkConnection::IsIOReceiveBlocked() const
 {
-    if (AuthStatus == NETWORK_AUTH_OK || !packet->CommandRequiresAuth())
+    return _ioInboundPending != nullptr;
+}
+
+bool NetworkConnection::IOReceivePackets()
+{
+    if (_ioInboundPending != nullptr && !_ioInboundPackets.TryPush(std::move(_ioInboundPending)))
     {
-        packet->Size = (uint16_t)packet->Data->size();
-        if (front)
+        _ioReceiveBlocked.store(true, std::memory_order_release);
+        return true;
+    }
+
+    for (;;)
+    {
+        switch (ReceivePacket())
         {
-            // If the first packet was already partially sent add new packet to second position
-            if (!_outboundPackets.empty() && _outboundPackets.front()->BytesTransferred > 0)
+            case NETWORK_READPACKET_SUCCESS:
             {
-                auto it = _outboundPackets.begin();
-                it++; // Second position
-                _outboundPackets.insert(it, std::move(packet));
-            }
-            else
-            {
-                _outboundPackets.push_front(std::move(packet));
+                auto packet = NetworkPacket::Allocate();
+                packet->Size = InboundPacket.Size;
+                packet->Data = std::move(InboundPacket.Data);
+                InboundPacket.Data = std::make_shared<std::vector<uint8_t>>();
+                InboundPacket.Clear();
+                if (!_ioInboundPackets.TryPush(std::move(packet)))
+                {
+                    // Stop reading the socket until the game thread has made room in the queue
+                    _ioInboundPending = std::move(packet);
+                    _ioReceiveBlocked.store(true, std::memory_order_release);
+                    return true;
+                }
+                break;
             }
-        }
-        else
-        {
-            _outboundPackets.push_back(std::move(packet));
+            case NETWORK_READPACKET_MORE_DATA:
+                break;
+            case NETWORK_READPACKET_NO_DATA:
+                return true;
+            default:
+                _ioDisconnected.store(true, std::memory_order_release);
+                return false;
         }
     }
 }
 
-void NetworkConnection::SendQueuedPackets()
+bool NetworkConnection::IOSendPackets()
+{
+    OutboundPacket outbound;
+    while (_ioOutboundPackets.TryPop(outbound))
+    {
+        AddOutboundPacket(std::move(outbound.Packet), outbound.Front);
+    }
+    SendOutboundPackets();
+    return !_outboundPackets.empty();
+}
+
+size_t NetworkConnection::SendPacketBatch()
 {
-    while (!_outboundPackets.empty() && SendPacket(*_outboundPackets.front()))
+    // Send the size header and payload of each queued packet straight from the packet data, the payload of a
+    // broadcast packet is shared between all the connections it is queued on.
+    uint16_t headers[MAX_PACKETS_PER_SEND];
+    SocketSendBuffer buffers[MAX_PACKETS_PER_SEND * 2];
+    size_t numBuffers = 0;
+    size_t numPackets = 0;
+    size_t skip = 0;
+    for (auto it = _outboundPackets.begin(); it != _outboundPackets.end() && numPackets < MAX_PACKETS_PER_SEND; it++)
     {
-        _outboundPackets.remove(_outboundPackets.front());
+        const auto& packet = **it;
+        headers[numPackets] = Convert::HostToNetwork(packet.Size);
+        buffers[numBuffers++] = { &headers[numPackets], sizeof(packet.Size) };
+        buffers[numBuffers++] = { packet.Data->data(), packet.Data->size() };
+        if (numPackets == 0)
+        {
+            // Only the packet at the front of the queue can have been partially sent
+            skip = packet.BytesTransferred;
+        }
+        numPackets++;
+    }
+
+    // Skip over the part of the front packet that has already been sent
+    size_t firstBuffer = 0;
+    while (skip > 0 && skip >= buffers[firstBuffer].Size)
+    {
+        skip -= buffers[firstBuffer].Size;
+        firstBuffer++;
+    }
+    buffers[firstBuffer].Data = (const uint8_t*)buffers[firstBuffer].Data + skip;
+    buffers[firstBuffer].Size -= skip;
+
+    size_t sent = Socket->SendData(&buffers[firstBuffer], numBuffers - firstBuffer);
+
+    // Account the sent bytes to each packet in turn
+    size_t numCompleted = 0;
+    auto it = _outboundPackets.begin();
+    while (sent > 0 && numCompleted < numPackets)
+    {
+        auto& packet = **it;
+        size_t packetLength = sizeof(packet.Size) + packet.Size;
+        size_t length = std::min(sent, packetLength - packet.BytesTransferred);
+        packet.BytesTransferred += length;
+        sent -= length;
+        if (packet.BytesTransferred != packetLength)
+        {
+            break;
+        }
+        if (_ioThread == nullptr)
+        {
+            RecordPacketStats(packet, true);
+        }
+        numCompleted++;
+        it++;
     }
+    return numCompleted;
 }
 
 void NetworkConnection::ResetLastPacketTime()
@@ -186,7 +394,7 @@ void NetworkConnection::SetLastDisconnectReason(const rct_string_id string_id, v
 
 void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool sending)
 {
-    uint32_t packetSize = (uint32_t)packet.BytesTransferred;
+    uint32_t packetSize = (uint32_t)(sizeof(packet.Size) + packet.Size);
     uint32_t trafficGroup = NETWORK_STATISTICS_GROUP_BASE;
 
     switch (packet.GetCommand())
@@ -11,11 +11,15 @@
 
 #ifndef DISABLE_NETWORK
 #    include "../common.h"
+#    include "../core/SpscQueue.hpp"
+#    include "NetworkIOThread.h"
 #    include "NetworkKey.h"
 #    include "NetworkPacket.h"
 #    include "NetworkTypes.h"
 #    include "Socket.h"
 
+#    include <atomic>
+#    include <deque>
 #    include <list>
 #    include <memory>
 #    include <vector>
@@ -46,17 +50,54 @@ public:
     void ResetLastPacketTime();
     bool ReceivedPacketRecently();
 
+    // Used when the socket is serviced by a network I/O thread
+    void AttachIOThread(INetworkIOThread* ioThread);
+    bool IsIOThreaded() const;
+    bool IsIODisconnected() const;
+    std::unique_ptr<NetworkPacket> PopReceivedPacket();
+    bool IsIOReceiveBlocked() const;
+    bool IOReceivePackets();
+    bool IOSendPackets();
+
     const utf8* GetLastDisconnectReason() const;
     void SetLastDisconnectReason(const utf8* src);
     void SetLastDisconnectReason(const rct_string_id string_id, void* args = nullptr);
 
 private:
     std::list<std::unique_ptr<NetworkPacket>> _outboundPackets;
+    std::vector<uint8_t> _receiveBuffer;
+    size_t _receiveBufferStart = 0;
+    size_t _receiveBufferEnd = 0;
+
+    struct OutboundPacket
+    {
+        std::unique_ptr<NetworkPacket> Packet;
+        bool Front = false;
+    };
+
+    static constexpr size_t IO_INBOUND_QUEUE_SIZE = 256;
+    static constexpr size_t IO_OUTBOUND_QUEUE_SIZE = 1024;
+
+    INetworkIOThread* _ioThread = nullptr;
+    SpscQueue<std::unique_ptr<NetworkPacket>, IO_INBOUND_QUEUE_SIZE> _ioInboundPackets;
+    SpscQueue<OutboundPacket, IO_OUTBOUND_QUEUE_SIZE> _ioOutboundPackets;
+    // Only accessed by the I/O thread, a received packet that did not fit in the queue
+    std::unique_ptr<NetworkPacket> _ioInboundPending;
+    // Set by the I/O thread when it stops reading the socket, cleared by the game thread to make it read again
+    std::atomic<bool> _ioReceiveBlocked{ false };
+    // Only accessed by the game thread, packets to send that did not fit in the queue
+    std::deque<OutboundPacket> _ioOutboundOverflow;
+    std::atomic<bool> _ioDisconnected{ false };
+    bool _ioWakePending = false;
     uint32_t _lastPacketTime = 0;
     utf8* _lastDisconnectReason = nullptr;
 
+    int32_t ReceivePacket();
+    bool ParseBufferedPacket();
+    void AddOutboundPacket(std::unique_ptr<NetworkPacket> packet, bool front);
+    void SendOutboundPackets();
     void RecordPacketStats(const NetworkPacket& packet, bool sending);
-    bool SendPacket(NetworkPacket& packet);
+    size_t SendPacketBatch();
 };
 
 #endif // DISABLE_NETWORK
@@ -0,0 +1,239 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include "NetworkIOThread.h"
+
+#    include "../Diagnostic.h"
+#    include "NetworkConnection.h"
+
+#    ifdef __linux__
+#        include <atomic>
+#        include <cerrno>
+#        include <mutex>
+#        include <sys/epoll.h>
+#        include <sys/eventfd.h>
+#        include <thread>
+#        include <unistd.h>
+#        include <unordered_map>
+
+class EpollNetworkIOThread final : public INetworkIOThread
+{
+private:
+    static constexpr size_t MAX_EVENTS = 64;
+
+    int32_t _epoll = -1;
+    int32_t _wakeEvent = -1;
+    std::atomic<bool> _stop{ false };
+    std::thread _thread;
+
+    // Held by the I/O thread while it services connections, so removing a connection waits until it is no longer used
+    std::mutex _mutex;
+    struct ConnectionState
+    {
+        // Waiting for the socket to become writable
+        bool WaitingForWrite = false;
+        // Not reading the socket until the game thread has made room for the received packets
+        bool ReceiveBlocked = false;
+    };
+
+    // Registered connections and the events they are waiting for
+    std::unordered_map<NetworkConnection*, ConnectionState> _connections;
+
+public:
+    EpollNetworkIOThread(int32_t epoll, int32_t wakeEvent)
+        : _epoll(epoll)
+        , _wakeEvent(wakeEvent)
+    {
+        _thread = std::thread([this] { Run(); });
+    }
+
+    ~EpollNetworkIOThread() override
+    {
+        _stop = true;
+        Wake();
+        _thread.join();
+        close(_wakeEvent);
+        close(_epoll);
+    }
+
+    void AddConnection(NetworkConnection& connection) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = &connection;
+        if (epoll_ctl(_epoll, EPOLL_CTL_ADD, (int32_t)connection.Socket->GetHandle(), &ev) != 0)
+        {
+            log_error("Unable to add connection to network I/O thread, errno = %d", errno);
+            return;
+        }
+        _connections[&connection] = {};
+    }
+
+    void RemoveConnection(NetworkConnection& connection) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_connections.erase(&connection) != 0)
+        {
+            epoll_ctl(_epoll, EPOLL_CTL_DEL, (int32_t)connection.Socket->GetHandle(), nullptr);
+        }
+    }
+
+    void Wake() override
+    {
+        uint64_t value = 1;
+        [[maybe_unused]] auto result = write(_wakeEvent, &value, sizeof(value));
+    }
+
+private:
+    void Run()
+    {
+        epoll_event events[MAX_EVENTS];
+        while (!_stop)
+        {
+            int32_t numEvents = epoll_wait(_epoll, events, MAX_EVENTS, -1);
+            if (numEvents < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                log_error("Network I/O thread stopped, errno = %d", errno);
+                break;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (int32_t i = 0; i < numEvents; i++)
+            {
+                const auto& ev = events[i];
+                if (ev.data.ptr == nullptr)
+                {
+                    // The game thread has queued packets to send or made room for received packets
+                    uint64_t value;
+                    [[maybe_unused]] auto result = read(_wakeEvent, &value, sizeof(value));
+                    for (auto it = _connections.begin(); it != _connections.end();)
+                    {
+                        if (it->second.ReceiveBlocked && !ReceivePackets(*it->first, it->second))
+                        {
+                            it = RemoveDisconnected(it);
+                            continue;
+                        }
+                        SendPackets(*it->first, it->second);
+                        it++;
+                    }
+                    continue;
+                }
+
+                // The connection may have been removed after the events were returned
+                auto connection = _connections.find((NetworkConnection*)ev.data.ptr);
+                if (connection == _connections.end())
+                {
+                    continue;
+                }
+                if (ev.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                {
+                    if (!ReceivePackets(*connection->first, connection->second))
+                    {
+                        RemoveDisconnected(connection);
+                        continue;
+                    }
+                }
+                if (ev.events & EPOLLOUT)
+                {
+                    SendPackets(*connection->first, connection->second);
+                }
+            }
+        }
+    }
+
+    using ConnectionIterator = std::unordered_map<NetworkConnection*, ConnectionState>::iterator;
+
+    ConnectionIterator RemoveDisconnected(ConnectionIterator it)
+    {
+        epoll_ctl(_epoll, EPOLL_CTL_DEL, (int32_t)it->first->Socket->GetHandle(), nullptr);
+        return _connections.erase(it);
+    }
+
+    bool ReceivePackets(NetworkConnection& connection, ConnectionState& state)
+    {
+        if (!connection.IOReceivePackets())
+        {
+            return false;
+        }
+        UpdateEvents(connection, state, state.WaitingForWrite, connection.IsIOReceiveBlocked());
+        return true;
+    }
+
+    void SendPackets(NetworkConnection& connection, ConnectionState& state)
+    {
+        // Only ask to be told when the socket is writable while there are packets it could not take yet
+        bool pending = connection.IOSendPackets();
+        UpdateEvents(connection, state, pending, state.ReceiveBlocked);
+    }
+
+    void UpdateEvents(NetworkConnection& connection, ConnectionState& state, bool waitingForWrite, bool receiveBlocked)
+    {
+        if (waitingForWrite == state.WaitingForWrite && receiveBlocked == state.ReceiveBlocked)
+        {
+            return;
+        }
+
+        epoll_event ev{};
+        if (!receiveBlocked)
+        {
+            ev.events |= EPOLLIN | EPOLLRDHUP;
+        }
+        if (waitingForWrite)
+        {
+            ev.events |= EPOLLOUT;
+        }
+        ev.data.ptr = &connection;
+        epoll_ctl(_epoll, EPOLL_CTL_MOD, (int32_t)connection.Socket->GetHandle(), &ev);
+        state.WaitingForWrite = waitingForWrite;
+        state.ReceiveBlocked = receiveBlocked;
+    }
+};
+
+std::unique_ptr<INetworkIOThread> CreateNetworkIOThread()
+{
+    int32_t epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll == -1)
+    {
+        return nullptr;
+    }
+    int32_t wakeEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeEvent == -1)
+    {
+        close(epoll);
+        return nullptr;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;
+    if (epoll_ctl(epoll, EPOLL_CTL_ADD, wakeEvent, &ev) != 0)
+    {
+        close(wakeEvent);
+        close(epoll);
+        return nullptr;
+    }
+    return std::make_unique<EpollNetworkIOThread>(epoll, wakeEvent);
+}
+
+#    else
+
+std::unique_ptr<INetworkIOThread> CreateNetworkIOThread()
+{
+    return nullptr;
+}
+
+#    endif // __linux__
+
+#endif // DISABLE_NETWORK
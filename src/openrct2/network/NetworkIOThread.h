@@ -0,0 +1,38 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifndef DISABLE_NETWORK
+#    include "../common.h"
+
+#    include <memory>
+
+class NetworkConnection;
+
+/**
+ * Services the sockets of the server's client connections on a dedicated thread. Received packets are passed to the
+ * game thread and packets to send are passed back through queues on each connection, so the game tick does not pay
+ * for socket calls and network latency does not depend on the tick duration.
+ */
+interface INetworkIOThread
+{
+    virtual ~INetworkIOThread() = default;
+
+    virtual void AddConnection(NetworkConnection& connection) abstract;
+    virtual void RemoveConnection(NetworkConnection& connection) abstract;
+    virtual void Wake() abstract;
+};
+
+/**
+ * Starts a network I/O thread, returns nullptr if this is not supported on the current platform.
+ */
+std::unique_ptr<INetworkIOThread> CreateNetworkIOThread();
+
+#endif // DISABLE_NETWORK
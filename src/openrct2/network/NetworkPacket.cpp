@@ -22,6 +22,7 @@ std::unique_ptr<NetworkPacket> NetworkPacket::Allocate()
 
 std::unique_ptr<NetworkPacket> NetworkPacket::Duplicate(NetworkPacket& packet)
 {
+    // The payload is shared with the original packet rather than copied, it must not be modified after this.
     return std::make_unique<NetworkPacket>(packet);
 }
 
@@ -74,6 +75,38 @@ void NetworkPacket::WriteString(const utf8* string)
     Write((uint8_t*)string, strlen(string) + 1);
 }
 
+/**
+ * Writes a value in 7 bit groups, least significant first, with the top bit set on all but the last byte.
+ */
+void NetworkPacket::WriteVarInt(uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        Data->push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    Data->push_back((uint8_t)value);
+}
+
+bool NetworkPacket::ReadVarInt(uint32_t& value)
+{
+    value = 0;
+    for (int32_t shift = 0; shift < 35; shift += 7)
+    {
+        if (BytesRead >= Size)
+        {
+            return false;
+        }
+        uint8_t byte = GetData()[BytesRead++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 const uint8_t* NetworkPacket::Read(size_t size)
 {
     if (BytesRead + size > NetworkPacket::Size)
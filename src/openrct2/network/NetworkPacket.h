@@ -39,6 +39,9 @@ public:
     void Write(const uint8_t* bytes, size_t size);
     void WriteString(const utf8* string);
 
+    bool ReadVarInt(uint32_t& value);
+    void WriteVarInt(uint32_t value);
+
     template<typename T> NetworkPacket& operator>>(T& value)
     {
         if (BytesRead + sizeof(value) > Size)
@@ -67,6 +67,7 @@ enum NETWORK_COMMAND
     NETWORK_COMMAND_PLAYERINFO,
     NETWORK_COMMAND_REQUEST_GAMESTATE,
     NETWORK_COMMAND_GAMESTATE,
+    NETWORK_COMMAND_FRAME,
     NETWORK_COMMAND_MAX,
     NETWORK_COMMAND_INVALID = -1
 };
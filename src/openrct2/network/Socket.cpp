@@ -46,6 +46,7 @@
     #include <netinet/tcp.h>
     #include <sys/ioctl.h>
     #include <sys/socket.h>
+    #include <sys/uio.h>
     #include "../common.h"
     using SOCKET = int32_t;
     #define SOCKET_ERROR -1
@@ -65,6 +66,9 @@
 
 constexpr auto CONNECT_TIMEOUT = std::chrono::milliseconds(3000);
 
+// Maximum number of buffers passed to a single vectored send call, well within IOV_MAX on all platforms.
+constexpr size_t MAX_SEND_VECTORS = 64;
+
 #    ifdef _WIN32
 static bool _wsaInitialised = false;
 #    endif
@@ -488,6 +492,89 @@ public:
         return totalSent;
     }
 
+    size_t SendData(const SocketSendBuffer* buffers, size_t count) override
+    {
+        if (_status != SOCKET_STATUS_CONNECTED)
+        {
+            throw std::runtime_error("Socket not connected.");
+        }
+
+        // Gather as many buffers as possible into each call, skipping over whatever has already been sent.
+        size_t totalSent = 0;
+        size_t bufferIndex = 0;
+        size_t bufferOffset = 0;
+        while (bufferIndex < count)
+        {
+#    ifdef _WIN32
+            WSABUF vectors[MAX_SEND_VECTORS];
+#    else
+            iovec vectors[MAX_SEND_VECTORS];
+#    endif
+            size_t numVectors = 0;
+            for (size_t i = bufferIndex; i < count && numVectors < MAX_SEND_VECTORS; i++)
+            {
+                size_t offset = i == bufferIndex ? bufferOffset : 0;
+                if (buffers[i].Size <= offset)
+                {
+                    continue;
+                }
+                auto& entry = vectors[numVectors++];
+#    ifdef _WIN32
+                entry.buf = (CHAR*)buffers[i].Data + offset;
+                entry.len = (ULONG)(buffers[i].Size - offset);
+#    else
+                entry.iov_base = (uint8_t*)buffers[i].Data + offset;
+                entry.iov_len = buffers[i].Size - offset;
+#    endif
+            }
+            if (numVectors == 0)
+            {
+                break;
+            }
+
+#    ifdef _WIN32
+            DWORD sentBytes = 0;
+            if (WSASend(_socket, vectors, (DWORD)numVectors, &sentBytes, 0, nullptr, nullptr) == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    else
+            msghdr message = {};
+            message.msg_iov = vectors;
+            message.msg_iovlen = numVectors;
+            ssize_t sentBytes = sendmsg(_socket, &message, FLAG_NO_PIPE);
+            if (sentBytes == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    endif
+            if (sentBytes == 0)
+            {
+                return totalSent;
+            }
+            totalSent += sentBytes;
+
+            // Advance past the bytes that were sent
+            size_t remaining = sentBytes;
+            while (remaining > 0 && bufferIndex < count)
+            {
+                size_t available = buffers[bufferIndex].Size - bufferOffset;
+                if (remaining < available)
+                {
+                    bufferOffset += remaining;
+                    remaining = 0;
+                }
+                else
+                {
+                    remaining -= available;
+                    bufferIndex++;
+                    bufferOffset = 0;
+                }
+            }
+        }
+        return totalSent;
+    }
+
     NETWORK_READPACKET ReceiveData(void* buffer, size_t size, size_t* sizeReceived) override
     {
         if (_status != SOCKET_STATUS_CONNECTED)
@@ -546,6 +633,11 @@ public:
         return _hostName.empty() ? nullptr : _hostName.c_str();
     }
 
+    uintptr_t GetHandle() const override
+    {
+        return (uintptr_t)_socket;
+    }
+
 private:
     explicit TcpSocket(SOCKET socket, const std::string& hostName)
     {
@@ -146,6 +146,7 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
 {
     paint_session* session = nullptr;
 
+    std::unique_lock<std::mutex> lock(_paintSessionMutex);
     if (_freePaintSessions.empty() == false)
     {
         // Re-use.
@@ -161,6 +162,7 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
         _paintSessionPool.emplace_back(std::make_unique<paint_session>());
         session = _paintSessionPool.back().get();
     }
+    lock.unlock();
 
     session->DPI = *dpi;
     session->EndOfPaintStructArray = &session->PaintStructs[4000 - 1];
@@ -185,5 +187,6 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
 
 void Painter::ReleaseSession(paint_session* session)
 {
+    std::lock_guard<std::mutex> lock(_paintSessionMutex);
     _freePaintSessions.push_back(session);
 }
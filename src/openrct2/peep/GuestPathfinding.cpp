@@ -15,8 +15,13 @@
 #include "../world/Entrance.h"
 #include "../world/Footpath.h"
 #include "Peep.h"
+#include "Staff.h"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <iterator>
+#include <unordered_map>
 
 static bool _peepPathFindIsStaff;
 static int8_t _peepPathFindNumJunctions;
@@ -1158,6 +1163,109 @@ static void peep_pathfind_heuristic_search(
     }
 }
 
+/**
+ * Everything the heuristic search of a staff member depends on besides the path network itself. Staff members
+ * heading for the same goal from the same junction with the same patrol area and junction history get the same
+ * result, so it is computed once and shared until the path network changes. The patrol area and history are kept in
+ * full, their hashes only pick the bucket.
+ */
+struct StaffPathSearchKey
+{
+    TileCoordsXYZ Start;
+    TileCoordsXYZ Goal;
+    uint32_t PatrolAreaHash;
+    uint32_t HistoryHash;
+    std::array<uint32_t, STAFF_PATROL_AREA_SIZE> PatrolArea;
+    std::array<rct12_xyzd8, 4> History;
+    int32_t MaxTilesChecked;
+    ride_id_t QueueRideIndex;
+    uint8_t StaffType;
+    uint8_t Edge;
+    int8_t MaxJunctions;
+    bool InPatrolArea;
+    bool IgnoreForeignQueues;
+
+    bool operator==(const StaffPathSearchKey& rhs) const
+    {
+        return Start == rhs.Start && Goal == rhs.Goal && PatrolAreaHash == rhs.PatrolAreaHash
+            && HistoryHash == rhs.HistoryHash && MaxTilesChecked == rhs.MaxTilesChecked && QueueRideIndex == rhs.QueueRideIndex
+            && StaffType == rhs.StaffType && Edge == rhs.Edge && MaxJunctions == rhs.MaxJunctions
+            && InPatrolArea == rhs.InPatrolArea && IgnoreForeignQueues == rhs.IgnoreForeignQueues
+            && PatrolArea == rhs.PatrolArea && std::memcmp(History.data(), rhs.History.data(), sizeof(History)) == 0;
+    }
+};
+
+struct StaffPathSearchKeyHash
+{
+    size_t operator()(const StaffPathSearchKey& key) const
+    {
+        size_t hash = key.PatrolAreaHash ^ (key.HistoryHash * 31);
+        hash = hash * 31 + ((key.Start.x << 16) | (key.Start.y << 8) | key.Start.z);
+        hash = hash * 31 + ((key.Goal.x << 16) | (key.Goal.y << 8) | key.Goal.z);
+        hash = hash * 31 + ((key.Edge << 24) | (key.StaffType << 16) | (key.InPatrolArea << 8) | key.MaxJunctions);
+        hash = hash * 31 + key.MaxTilesChecked;
+        return hash;
+    }
+};
+
+struct StaffPathSearchResult
+{
+    uint16_t Score;
+    uint8_t Steps;
+};
+
+static constexpr size_t StaffPathSearchCacheMaxSize = 4096;
+
+static std::unordered_map<StaffPathSearchKey, StaffPathSearchResult, StaffPathSearchKeyHash> _staffPathSearchCache;
+static uint32_t _staffPathSearchCacheVersion;
+
+static uint32_t fnv1a_hash(uint32_t hash, const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void staff_path_search_key_set_patrol_area(StaffPathSearchKey& key, Peep* staff)
+{
+    // Staff without a patrol area can walk anywhere in the park.
+    if (!(gStaffModes[staff->staff_id] & 2))
+    {
+        key.PatrolArea.fill(0);
+        key.PatrolAreaHash = 0;
+        return;
+    }
+
+    const uint32_t* patrolArea = &gStaffPatrolAreas[staff->staff_id * STAFF_PATROL_AREA_SIZE];
+    std::copy_n(patrolArea, STAFF_PATROL_AREA_SIZE, key.PatrolArea.begin());
+    key.PatrolAreaHash = fnv1a_hash(2166136261u, key.PatrolArea.data(), sizeof(key.PatrolArea));
+}
+
+static StaffPathSearchResult* staff_path_search_cache_find(const StaffPathSearchKey& key)
+{
+    if (_staffPathSearchCacheVersion != gFootpathNetworkVersion)
+    {
+        _staffPathSearchCache.clear();
+        _staffPathSearchCacheVersion = gFootpathNetworkVersion;
+        return nullptr;
+    }
+
+    auto it = _staffPathSearchCache.find(key);
+    return it != _staffPathSearchCache.end() ? &it->second : nullptr;
+}
+
+static void staff_path_search_cache_insert(const StaffPathSearchKey& key, StaffPathSearchResult result)
+{
+    if (_staffPathSearchCache.size() >= StaffPathSearchCacheMaxSize)
+    {
+        _staffPathSearchCache.clear();
+    }
+    _staffPathSearchCache[key] = result;
+}
+
 /**
  * Returns:
  *   -1   - no direction chosen
@@ -1354,6 +1462,21 @@ Direction peep_pathfind_choose_direction(TileCoordsXYZ loc, Peep* peep)
          * or for different edges with equal value, the edge with the
          * least steps (best_sub). */
         int32_t numEdges = bitcount(edges);
+
+        StaffPathSearchKey searchKey{};
+        if (peep->type == PEEP_TYPE_STAFF)
+        {
+            searchKey.Goal = goal;
+            staff_path_search_key_set_patrol_area(searchKey, peep);
+            std::copy(std::begin(peep->pathfind_history), std::end(peep->pathfind_history), searchKey.History.begin());
+            searchKey.HistoryHash = fnv1a_hash(2166136261u, searchKey.History.data(), sizeof(searchKey.History));
+            searchKey.MaxTilesChecked = maxTilesChecked / numEdges;
+            searchKey.QueueRideIndex = gPeepPathFindQueueRideIndex;
+            searchKey.StaffType = peep->staff_type;
+            searchKey.MaxJunctions = _peepPathFindMaxJunctions;
+            searchKey.IgnoreForeignQueues = gPeepPathFindIgnoreForeignQueues;
+        }
+
         for (int32_t test_edge = chosen_edge; test_edge != -1; test_edge = bitscanforward(edges))
         {
             edges &= ~(1 << test_edge);
@@ -1419,9 +1542,31 @@ Direction peep_pathfind_choose_direction(TileCoordsXYZ loc, Peep* peep)
             }
 #endif // defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
 
-            peep_pathfind_heuristic_search(
-                { loc.x, loc.y, height }, peep, first_tile_element, inPatrolArea, 0, &score, test_edge, &endJunctions,
-                endJunctionList, endDirectionList, &endXYZ, &endSteps);
+            StaffPathSearchResult* cachedResult = nullptr;
+            if (peep->type == PEEP_TYPE_STAFF)
+            {
+                searchKey.Start = { loc.x, loc.y, height };
+                searchKey.Edge = test_edge;
+                searchKey.InPatrolArea = inPatrolArea;
+                cachedResult = staff_path_search_cache_find(searchKey);
+            }
+
+            if (cachedResult != nullptr)
+            {
+                score = cachedResult->Score;
+                endSteps = cachedResult->Steps;
+            }
+            else
+            {
+                peep_pathfind_heuristic_search(
+                    { loc.x, loc.y, height }, peep, first_tile_element, inPatrolArea, 0, &score, test_edge, &endJunctions,
+                    endJunctionList, endDirectionList, &endXYZ, &endSteps);
+
+                if (peep->type == PEEP_TYPE_STAFF)
+                {
+                    staff_path_search_cache_insert(searchKey, { score, endSteps });
+                }
+            }
 
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
             if (gPathFindDebug)
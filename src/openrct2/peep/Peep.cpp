@@ -14,6 +14,7 @@
 #include "../Game.h"
 #include "../Input.h"
 #include "../OpenRCT2.h"
+#include "../ReplayManager.h"
 #include "../audio/AudioMixer.h"
 #include "../audio/audio.h"
 #include "../config/Config.h"
@@ -46,8 +47,11 @@
 #include "Staff.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iterator>
 #include <limits>
+#include <unordered_set>
+#include <vector>
 
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
 bool gPathFindDebug = false;
@@ -59,6 +63,8 @@ uint16_t gNumGuestsInPark;
 uint16_t gNumGuestsInParkLastWeek;
 uint16_t gNumGuestsHeadingForPark;
 
+PeepTickStats gPeepTickStats;
+
 money16 gGuestInitialCash;
 uint8_t gGuestInitialHappiness;
 uint8_t gGuestInitialHunger;
@@ -398,24 +404,69 @@ int32_t peep_get_staff_count()
     return count;
 }
 
+struct PeepTick128Deferral
+{
+    uint16_t SpriteIndex;
+    uint8_t PeepType;
+    uint32_t PeepId;
+    uint32_t DueTick;
+};
+
+// Most 128 tick updates that can be carried over, past this they run even if the budget is used up.
+static constexpr size_t PEEP_TICK128_BACKLOG_MAX = 1024;
+
+// Peeps whose 128 tick update did not fit in the work budget of the tick they were due on.
+static std::vector<PeepTick128Deferral> _peepTick128Backlog;
+// Sprite indices in the backlog, so a peep is not queued again while it is still waiting.
+static std::unordered_set<uint16_t> _peepTick128BacklogIndices;
+
 /**
- *
- *  rct2: 0x0068F0A9
+ * The slot scheduler changes the order in which the game state evolves, so it is only used when
+ * nothing else has to reproduce the simulation tick for tick (multiplayer and replays).
  */
-void peep_update_all()
+static bool peep_use_slot_scheduler()
 {
-    int32_t i;
-    uint16_t spriteIndex;
-    Peep* peep;
+    if (!gConfigGeneral.peep_slot_scheduler)
+        return false;
+    if (network_get_mode() != NETWORK_MODE_NONE)
+        return false;
 
-    if (gScreenFlags & SCREEN_FLAGS_EDITOR)
-        return;
+    auto replayManager = OpenRCT2::GetContext()->GetReplayManager();
+    if (replayManager != nullptr
+        && (replayManager->IsRecording() || replayManager->IsReplaying() || replayManager->IsNormalising()))
+    {
+        return false;
+    }
+    return true;
+}
 
-    spriteIndex = gSpriteListHead[SPRITE_LIST_PEEP];
-    i = 0;
+static void peep_tick128_backlog_clear()
+{
+    _peepTick128Backlog.clear();
+    _peepTick128BacklogIndices.clear();
+}
+
+static void peep_128_tick_update_timed(Peep* peep, int32_t index)
+{
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    peep_128_tick_update(peep, index);
+    const auto endTime = std::chrono::high_resolution_clock::now();
+
+    gPeepTickStats.Tick128Updates++;
+    gPeepTickStats.Tick128Microseconds += std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+}
+
+/**
+ * Original scheduling, each peep does its 128 tick update when its position in the peep list
+ * matches the current tick.
+ */
+static void peep_update_all_legacy()
+{
+    int32_t i = 0;
+    uint16_t spriteIndex = gSpriteListHead[SPRITE_LIST_PEEP];
     while (spriteIndex != SPRITE_INDEX_NULL)
     {
-        peep = &(get_sprite(spriteIndex)->peep);
+        Peep* peep = &(get_sprite(spriteIndex)->peep);
         spriteIndex = peep->next;
 
         if ((uint32_t)(i & 0x7F) != (gCurrentTicks & 0x7F))
@@ -425,6 +476,7 @@ void peep_update_all()
         else
         {
             peep_128_tick_update(peep, i);
+            gPeepTickStats.Tick128Updates++;
             if (peep->linked_list_index == SPRITE_LIST_PEEP)
             {
                 peep->Update();
@@ -435,6 +487,102 @@ void peep_update_all()
     }
 }
 
+/**
+ * Each peep does its 128 tick update in the slot given by its sprite index, which does not change
+ * for the lifetime of the peep, so adding or removing peeps does not shift the work between ticks.
+ * At most peep_tick_budget updates run per tick, the rest is carried over to the following ticks.
+ */
+static void peep_update_all_slot_scheduled()
+{
+    const uint32_t budget = gConfigGeneral.peep_tick_budget > 0 ? gConfigGeneral.peep_tick_budget
+                                                                 : std::numeric_limits<uint32_t>::max();
+    uint32_t numUpdates = 0;
+
+    // The update index is shifted by the delay so the 512 and 1024 tick subtasks of a deferred
+    // guest still run on the same rounds as if it had not been deferred.
+    std::vector<PeepTick128Deferral> backlog;
+    std::swap(backlog, _peepTick128Backlog);
+    for (const auto& deferral : backlog)
+    {
+        if (numUpdates >= budget)
+        {
+            _peepTick128Backlog.push_back(deferral);
+            continue;
+        }
+        _peepTick128BacklogIndices.erase(deferral.SpriteIndex);
+
+        // The sprite may have been removed, or reused by another peep, since the update was deferred
+        auto sprite = get_sprite(deferral.SpriteIndex);
+        if (sprite->generic.sprite_identifier != SPRITE_IDENTIFIER_PEEP || sprite->peep.type != deferral.PeepType
+            || sprite->peep.id != deferral.PeepId)
+        {
+            continue;
+        }
+
+        peep_128_tick_update_timed(&sprite->peep, deferral.SpriteIndex + (gCurrentTicks - deferral.DueTick));
+        numUpdates++;
+    }
+
+    uint16_t spriteIndex = gSpriteListHead[SPRITE_LIST_PEEP];
+    while (spriteIndex != SPRITE_INDEX_NULL)
+    {
+        Peep* peep = &(get_sprite(spriteIndex)->peep);
+        spriteIndex = peep->next;
+
+        // A peep still waiting for the update of its previous slot is not queued a second time
+        if ((uint32_t)(peep->sprite_index & 0x7F) == (gCurrentTicks & 0x7F)
+            && _peepTick128BacklogIndices.count(peep->sprite_index) == 0)
+        {
+            if (numUpdates < budget || _peepTick128Backlog.size() >= PEEP_TICK128_BACKLOG_MAX)
+            {
+                peep_128_tick_update_timed(peep, peep->sprite_index);
+                numUpdates++;
+                if (peep->linked_list_index != SPRITE_LIST_PEEP)
+                {
+                    continue;
+                }
+            }
+            else
+            {
+                _peepTick128Backlog.push_back({ peep->sprite_index, peep->type, peep->id, gCurrentTicks });
+                _peepTick128BacklogIndices.insert(peep->sprite_index);
+            }
+        }
+        peep->Update();
+    }
+}
+
+/**
+ *
+ *  rct2: 0x0068F0A9
+ */
+void peep_update_all()
+{
+    if (gScreenFlags & SCREEN_FLAGS_EDITOR)
+        return;
+
+    gPeepTickStats.Tick128Updates = 0;
+    gPeepTickStats.Tick128Microseconds = 0;
+
+    if (peep_use_slot_scheduler())
+    {
+        peep_update_all_slot_scheduled();
+    }
+    else
+    {
+        peep_tick128_backlog_clear();
+        peep_update_all_legacy();
+    }
+
+    gPeepTickStats.Deferred = (uint32_t)_peepTick128Backlog.size();
+}
+
+void peep_tick_scheduler_reset()
+{
+    peep_tick128_backlog_clear();
+    gPeepTickStats = {};
+}
+
 /**
  *
  *  rct2: 0x0068F41A
@@ -844,7 +992,7 @@ void peep_sprite_remove(Peep* peep)
 
         gStaffModes[peep->staff_id] = 0;
         peep->type = PEEP_TYPE_INVALID;
-        staff_update_greyed_patrol_areas();
+        staff_update_greyed_patrol_areas_for_type(peep->staff_type);
         peep->type = PEEP_TYPE_STAFF;
 
         news_item_disable_news(NEWS_ITEM_PEEP, peep->sprite_index);
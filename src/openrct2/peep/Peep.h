@@ -949,6 +949,15 @@ extern uint8_t gGuestInitialThirst;
 
 extern uint32_t gNextGuestNumber;
 
+struct PeepTickStats
+{
+    uint32_t Tick128Updates;      // 128 tick updates run during the last tick
+    uint32_t Deferred;            // 128 tick updates carried over because of the work budget
+    uint64_t Tick128Microseconds; // time spent in 128 tick updates during the last tick
+};
+
+extern PeepTickStats gPeepTickStats;
+
 extern uint8_t gPeepWarningThrottle[16];
 
 extern TileCoordsXYZ gPeepPathFindGoalPosition;
@@ -959,6 +968,7 @@ Peep* try_get_guest(uint16_t spriteIndex);
 int32_t peep_get_staff_count();
 bool peep_can_be_picked_up(Peep* peep);
 void peep_update_all();
+void peep_tick_scheduler_reset();
 void peep_problem_warnings_update();
 void peep_stop_crowd_noise();
 void peep_update_crowd_noise();
@@ -41,6 +41,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 
 // clang-format off
 const rct_string_id StaffCostumeNames[] = {
@@ -124,39 +125,141 @@ bool staff_hire_new_member(STAFF_TYPE staffType, ENTERTAINER_COSTUME entertainer
     return res->Error == GA_ERROR::OK;
 }
 
+// Patrol areas are stored in a bit map of 64 x 64 patrol quads, each covering 4 x 4 tiles.
+// Every row of quads spans two consecutive 32-bit words, the lower word holding the western half.
+static int32_t staff_get_patrol_quad_index(int32_t x, int32_t y)
+{
+    x = (x & 0x1F80) >> 7;
+    y = (y & 0x1F80) >> 1;
+    return x | y;
+}
+
+static uint64_t staff_get_patrol_row(int32_t staffIndex, int32_t quadY)
+{
+    const uint32_t* row = &gStaffPatrolAreas[staffIndex * STAFF_PATROL_AREA_SIZE + quadY * 2];
+    return row[0] | (((uint64_t)row[1]) << 32);
+}
+
 /**
- *
- *  rct2: 0x006C0C3F
+ * Converts an inclusive range of map coordinates to an inclusive range of patrol quads, returning false if
+ * the range lies completely outside of the map.
  */
-void staff_update_greyed_patrol_areas()
+static bool staff_get_patrol_quad_range(const MapRange& range, int32_t* left, int32_t* top, int32_t* right, int32_t* bottom)
 {
-    Peep* peep;
+    auto normalised = range.Normalise();
+    *left = std::max(normalised.GetLeft(), 0) >> 7;
+    *top = std::max(normalised.GetTop(), 0) >> 7;
+    *right = std::min(normalised.GetRight(), (MAXIMUM_MAP_SIZE_TECHNICAL * 32) - 1) >> 7;
+    *bottom = std::min(normalised.GetBottom(), (MAXIMUM_MAP_SIZE_TECHNICAL * 32) - 1) >> 7;
+    return *left <= *right && *top <= *bottom;
+}
 
-    for (int32_t staff_type = 0; staff_type < STAFF_TYPE_COUNT; ++staff_type)
+static uint64_t staff_get_patrol_row_mask(int32_t left, int32_t right)
+{
+    uint64_t mask = std::numeric_limits<uint64_t>::max() << left;
+    if (right < 63)
     {
-        int32_t staffPatrolOffset = (staff_type + STAFF_MAX_COUNT) * STAFF_PATROL_AREA_SIZE;
-        for (int32_t i = 0; i < STAFF_PATROL_AREA_SIZE; i++)
-        {
-            gStaffPatrolAreas[staffPatrolOffset + i] = 0;
-        }
+        mask &= (((uint64_t)1) << (right + 1)) - 1;
+    }
+    return mask;
+}
 
-        for (uint16_t sprite_index = gSpriteListHead[SPRITE_LIST_PEEP]; sprite_index != SPRITE_INDEX_NULL;
-             sprite_index = peep->next)
-        {
-            peep = GET_PEEP(sprite_index);
+/**
+ * Returns true if any patrol quad overlapping the range is part of the patrol area.
+ */
+bool staff_is_patrol_area_intersecting(int32_t staffIndex, const MapRange& range)
+{
+    int32_t left, top, right, bottom;
+    if (!staff_get_patrol_quad_range(range, &left, &top, &right, &bottom))
+        return false;
+
+    uint64_t mask = staff_get_patrol_row_mask(left, right);
+    for (int32_t quadY = top; quadY <= bottom; quadY++)
+    {
+        if (staff_get_patrol_row(staffIndex, quadY) & mask)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Returns true if every patrol quad overlapping the range is part of the patrol area.
+ */
+bool staff_is_patrol_area_covering(int32_t staffIndex, const MapRange& range)
+{
+    int32_t left, top, right, bottom;
+    if (!staff_get_patrol_quad_range(range, &left, &top, &right, &bottom))
+        return false;
 
-            if (peep->type == PEEP_TYPE_STAFF && staff_type == peep->staff_type)
+    uint64_t mask = staff_get_patrol_row_mask(left, right);
+    for (int32_t quadY = top; quadY <= bottom; quadY++)
+    {
+        if ((staff_get_patrol_row(staffIndex, quadY) & mask) != mask)
+            return false;
+    }
+    return true;
+}
+
+bool staff_has_patrol_area(int32_t staffIndex)
+{
+    const uint32_t* area = &gStaffPatrolAreas[staffIndex * STAFF_PATROL_AREA_SIZE];
+    return std::any_of(area, area + STAFF_PATROL_AREA_SIZE, [](uint32_t word) { return word != 0; });
+}
+
+void staff_update_greyed_patrol_areas_for_type(uint8_t staffType)
+{
+    uint32_t* greyedArea = &gStaffPatrolAreas[(staffType + STAFF_MAX_COUNT) * STAFF_PATROL_AREA_SIZE];
+    std::fill_n(greyedArea, STAFF_PATROL_AREA_SIZE, 0);
+
+    uint16_t spriteIndex;
+    Peep* peep;
+    FOR_ALL_STAFF (spriteIndex, peep)
+    {
+        if (peep->staff_type == staffType)
+        {
+            const uint32_t* peepArea = &gStaffPatrolAreas[peep->staff_id * STAFF_PATROL_AREA_SIZE];
+            for (int32_t i = 0; i < STAFF_PATROL_AREA_SIZE; i++)
             {
-                int32_t peepPatrolOffset = peep->staff_id * STAFF_PATROL_AREA_SIZE;
-                for (int32_t i = 0; i < STAFF_PATROL_AREA_SIZE; i++)
-                {
-                    gStaffPatrolAreas[staffPatrolOffset + i] |= gStaffPatrolAreas[peepPatrolOffset + i];
-                }
+                greyedArea[i] |= peepArea[i];
             }
         }
     }
 }
 
+/**
+ *
+ *  rct2: 0x006C0C3F
+ */
+void staff_update_greyed_patrol_areas()
+{
+    for (uint8_t staffType = 0; staffType < STAFF_TYPE_COUNT; ++staffType)
+    {
+        staff_update_greyed_patrol_areas_for_type(staffType);
+    }
+}
+
+/**
+ * Updates the merged patrol area of the staff type for the single patrol quad at x, y after one of its staff
+ * members has had that quad toggled. Only when a quad is removed do the other staff members need to be checked.
+ */
+void staff_update_greyed_patrol_area(uint8_t staffType, int32_t x, int32_t y)
+{
+    const int32_t greyedIndex = staffType + STAFF_MAX_COUNT;
+
+    bool isSet = false;
+    uint16_t spriteIndex;
+    Peep* peep;
+    FOR_ALL_STAFF (spriteIndex, peep)
+    {
+        if (peep->staff_type == staffType && staff_is_patrol_area_set(peep->staff_id, x, y))
+        {
+            isSet = true;
+            break;
+        }
+    }
+    staff_set_patrol_area(greyedIndex, x, y, isSet);
+}
+
 static bool staff_is_location_in_patrol_area(Peep* peep, int32_t x, int32_t y)
 {
     // Patrol quads are stored in a bit map (8 patrol quads per byte)
@@ -182,20 +285,31 @@ bool staff_is_location_in_patrol(Peep* staff, int32_t x, int32_t y)
     return staff_is_location_in_patrol_area(staff, x, y);
 }
 
+/**
+ * Returns true if the eight tiles surrounding x, y all lie within patrol quads of the staff member, in which case
+ * only land ownership decides whether those tiles are part of the patrol.
+ */
+static bool staff_is_patrol_neighbourhood_covered(Peep* staff, int32_t x, int32_t y)
+{
+    if (!(gStaffModes[staff->staff_id] & 2))
+        return true;
+
+    // Any 4x4 quad containing x, y also contains one of its neighbours, so covering the 3x3 block is equivalent.
+    return staff_is_patrol_area_covering(staff->staff_id, { x - 32, y - 32, x + 32, y + 32 });
+}
+
 bool staff_is_location_on_patrol_edge(Peep* mechanic, int32_t x, int32_t y)
 {
     // Check whether the location x,y is inside and on the edge of the
     // patrol zone for mechanic.
-    bool onZoneEdge = false;
-    int32_t neighbourDir = 0;
-    while (!onZoneEdge && neighbourDir <= 7)
+    for (int32_t neighbourDir = 0; neighbourDir <= 7; neighbourDir++)
     {
         int32_t neighbourX = x + CoordsDirectionDelta[neighbourDir].x;
         int32_t neighbourY = y + CoordsDirectionDelta[neighbourDir].y;
-        onZoneEdge = !staff_is_location_in_patrol(mechanic, neighbourX, neighbourY);
-        neighbourDir++;
+        if (!map_is_location_owned_or_has_rights({ neighbourX, neighbourY }))
+            return true;
     }
-    return onZoneEdge;
+    return !staff_is_patrol_neighbourhood_covered(mechanic, x, y);
 }
 
 bool staff_can_ignore_wide_flag(Peep* staff, int32_t x, int32_t y, uint8_t z, TileElement* path)
@@ -323,26 +437,20 @@ bool staff_can_ignore_wide_flag(Peep* staff, int32_t x, int32_t y, uint8_t z, Ti
  */
 static uint8_t staff_get_valid_patrol_directions(Peep* peep, int16_t x, int16_t y)
 {
-    uint8_t directions = 0;
-
-    if (staff_is_location_in_patrol(peep, x - 32, y))
-    {
-        directions |= (1 << 0);
-    }
-
-    if (staff_is_location_in_patrol(peep, x, y + 32))
-    {
-        directions |= (1 << 1);
-    }
-
-    if (staff_is_location_in_patrol(peep, x + 32, y))
-    {
-        directions |= (1 << 2);
-    }
+    static constexpr const CoordsXY PatrolDirectionDelta[] = { { -32, 0 }, { 0, 32 }, { 32, 0 }, { 0, -32 } };
 
-    if (staff_is_location_in_patrol(peep, x, y - 32))
+    const bool covered = staff_is_patrol_neighbourhood_covered(peep, x, y);
+    uint8_t directions = 0;
+    for (int32_t i = 0; i < 4; i++)
     {
-        directions |= (1 << 3);
+        int32_t neighbourX = x + PatrolDirectionDelta[i].x;
+        int32_t neighbourY = y + PatrolDirectionDelta[i].y;
+        bool inPatrol = covered ? map_is_location_owned_or_has_rights({ neighbourX, neighbourY })
+                                : staff_is_location_in_patrol(peep, neighbourX, neighbourY);
+        if (inPatrol)
+        {
+            directions |= (1 << i);
+        }
     }
 
     if (directions == 0)
@@ -376,43 +484,28 @@ void staff_reset_stats()
 
 bool staff_is_patrol_area_set(int32_t staffIndex, int32_t x, int32_t y)
 {
-    x = (x & 0x1F80) >> 7;
-    y = (y & 0x1F80) >> 1;
-
-    int32_t peepOffset = staffIndex * STAFF_PATROL_AREA_SIZE;
-    int32_t offset = (x | y) >> 5;
-    int32_t bitIndex = (x | y) & 0x1F;
-    return gStaffPatrolAreas[peepOffset + offset] & (((uint32_t)1) << bitIndex);
+    int32_t quadIndex = staff_get_patrol_quad_index(x, y);
+    return gStaffPatrolAreas[staffIndex * STAFF_PATROL_AREA_SIZE + (quadIndex >> 5)] & (((uint32_t)1) << (quadIndex & 0x1F));
 }
 
 void staff_set_patrol_area(int32_t staffIndex, int32_t x, int32_t y, bool value)
 {
-    x = (x & 0x1F80) >> 7;
-    y = (y & 0x1F80) >> 1;
-
-    int32_t peepOffset = staffIndex * STAFF_PATROL_AREA_SIZE;
-    int32_t offset = (x | y) >> 5;
-    int32_t bitIndex = (x | y) & 0x1F;
-    uint32_t* addr = &gStaffPatrolAreas[peepOffset + offset];
+    int32_t quadIndex = staff_get_patrol_quad_index(x, y);
+    uint32_t* addr = &gStaffPatrolAreas[staffIndex * STAFF_PATROL_AREA_SIZE + (quadIndex >> 5)];
     if (value)
     {
-        *addr |= (1 << bitIndex);
+        *addr |= (1 << (quadIndex & 0x1F));
     }
     else
     {
-        *addr &= ~(1 << bitIndex);
+        *addr &= ~(1 << (quadIndex & 0x1F));
     }
 }
 
 void staff_toggle_patrol_area(int32_t staffIndex, int32_t x, int32_t y)
 {
-    x = (x & 0x1F80) >> 7;
-    y = (y & 0x1F80) >> 1;
-
-    int32_t peepOffset = staffIndex * STAFF_PATROL_AREA_SIZE;
-    int32_t offset = (x | y) >> 5;
-    int32_t bitIndex = (x | y) & 0x1F;
-    gStaffPatrolAreas[peepOffset + offset] ^= (1 << bitIndex);
+    int32_t quadIndex = staff_get_patrol_quad_index(x, y);
+    gStaffPatrolAreas[staffIndex * STAFF_PATROL_AREA_SIZE + (quadIndex >> 5)] ^= (1 << (quadIndex & 0x1F));
 }
 
 /**
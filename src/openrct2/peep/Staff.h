@@ -75,6 +75,8 @@ void staff_reset_modes();
 void staff_set_name(uint16_t spriteIndex, const char* name);
 bool staff_hire_new_member(STAFF_TYPE staffType, ENTERTAINER_COSTUME entertainerType);
 void staff_update_greyed_patrol_areas();
+void staff_update_greyed_patrol_area(uint8_t staffType, int32_t x, int32_t y);
+void staff_update_greyed_patrol_areas_for_type(uint8_t staffType);
 bool staff_is_location_in_patrol(Peep* mechanic, int32_t x, int32_t y);
 bool staff_is_location_on_patrol_edge(Peep* mechanic, int32_t x, int32_t y);
 bool staff_can_ignore_wide_flag(Peep* mechanic, int32_t x, int32_t y, uint8_t z, TileElement* path);
@@ -83,6 +85,9 @@ void staff_reset_stats();
 bool staff_is_patrol_area_set(int32_t staffIndex, int32_t x, int32_t y);
 void staff_set_patrol_area(int32_t staffIndex, int32_t x, int32_t y, bool value);
 void staff_toggle_patrol_area(int32_t staffIndex, int32_t x, int32_t y);
+bool staff_has_patrol_area(int32_t staffIndex);
+bool staff_is_patrol_area_intersecting(int32_t staffIndex, const MapRange& range);
+bool staff_is_patrol_area_covering(int32_t staffIndex, const MapRange& range);
 colour_t staff_get_colour(uint8_t staffType);
 bool staff_set_colour(uint8_t staffType, colour_t value);
 uint32_t staff_get_available_entertainer_costumes();
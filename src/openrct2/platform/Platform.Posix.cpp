@@ -13,10 +13,13 @@
 #    include "Platform2.h"
 #    include "platform.h"
 
+#    include <cerrno>
 #    include <cstdlib>
 #    include <cstring>
 #    include <ctime>
 #    include <pwd.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
 
 namespace Platform
 {
@@ -96,6 +99,39 @@ namespace Platform
         }
         return isSupported;
     }
+
+    int32_t RunProcess(const std::string& path, const std::vector<std::string>& args)
+    {
+        // Set up before forking, the child process only calls execv
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(path.c_str()));
+        for (const auto& arg : args)
+        {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        pid_t pid = fork();
+        if (pid == -1)
+        {
+            return -1;
+        }
+        if (pid == 0)
+        {
+            execv(path.c_str(), argv.data());
+            _exit(127);
+        }
+
+        int status;
+        while (waitpid(pid, &status, 0) == -1)
+        {
+            if (errno != EINTR)
+            {
+                return -1;
+            }
+        }
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
 } // namespace Platform
 
 #endif
@@ -277,6 +277,56 @@ namespace Platform
         return isSupported;
     }
 
+    /**
+     * Quotes an argument so CommandLineToArgvW, which the C runtime also follows, splits it off unchanged.
+     */
+    static std::wstring WIN32_QuoteArgument(const std::wstring& arg)
+    {
+        std::wstring result = L"\"";
+        size_t numBackslashes = 0;
+        for (auto c : arg)
+        {
+            if (c == L'\\')
+            {
+                numBackslashes++;
+                continue;
+            }
+
+            // Backslashes are only special in front of a quote
+            result.append(c == L'"' ? numBackslashes * 2 + 1 : numBackslashes, L'\\');
+            numBackslashes = 0;
+            result += c;
+        }
+        result.append(numBackslashes * 2, L'\\');
+        return result + L"\"";
+    }
+
+    int32_t RunProcess(const std::string& path, const std::vector<std::string>& args)
+    {
+        auto wpath = String::ToWideChar(path);
+        std::wstring commandLine = WIN32_QuoteArgument(wpath);
+        for (const auto& arg : args)
+        {
+            commandLine += L" " + WIN32_QuoteArgument(String::ToWideChar(arg));
+        }
+
+        STARTUPINFOW startupInfo = {};
+        startupInfo.cb = sizeof(startupInfo);
+        PROCESS_INFORMATION processInfo = {};
+        if (!CreateProcessW(
+                wpath.c_str(), commandLine.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startupInfo, &processInfo))
+        {
+            return -1;
+        }
+
+        DWORD exitCode = (DWORD)-1;
+        WaitForSingleObject(processInfo.hProcess, INFINITE);
+        GetExitCodeProcess(processInfo.hProcess, &exitCode);
+        CloseHandle(processInfo.hThread);
+        CloseHandle(processInfo.hProcess);
+        return (int32_t)exitCode;
+    }
+
 #    ifdef __USE_SHGETKNOWNFOLDERPATH__
     static std::string WIN32_GetKnownFolderPath(REFKNOWNFOLDERID rfid)
     {
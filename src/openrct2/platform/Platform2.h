@@ -13,6 +13,7 @@
 
 #include <ctime>
 #include <string>
+#include <vector>
 
 enum class SPECIAL_FOLDER
 {
@@ -46,4 +47,10 @@ namespace Platform
 #endif
 
     bool IsColourTerminalSupported();
+
+    /**
+     * Runs an executable with the given arguments, passed on as they are without a shell, and waits for it to exit.
+     * Returns the exit code, or -1 if it could not be run.
+     */
+    int32_t RunProcess(const std::string& path, const std::vector<std::string>& args);
 } // namespace Platform
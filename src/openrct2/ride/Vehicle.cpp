@@ -43,6 +43,8 @@
 
 #include <algorithm>
 #include <iterator>
+#include <unordered_map>
+#include <vector>
 
 static void vehicle_update(rct_vehicle* vehicle);
 static void vehicle_update_crossings(const rct_vehicle* vehicle);
@@ -764,73 +766,97 @@ static const struct
 
 // clang-format on
 
-static bool vehicle_move_info_valid(int32_t cd, int32_t typeAndDirection, int32_t offset)
+// Number of track type and direction combinations in each of the gTrackVehicleInfo lists.
+static constexpr const uint16_t TrackVehicleInfoListSizes[] = {
+    1024, 692, 404, 404, 404, 208, 208, 208, 208, 824, 824, 824, 824, 824, 824, 868, 868,
+};
+static_assert(std::size(TrackVehicleInfoListSizes) == std::size(gTrackVehicleInfo));
+
+/**
+ * All the gTrackVehicleInfo lists copied into one contiguous array at startup, so that the move info of a car is found
+ * with a single bounds check and an index rather than a switch and a chain of pointers. Lists that are shared between
+ * several track pieces are only stored once.
+ */
+struct TrackVehicleInfoTable
 {
-    if (cd >= static_cast<int32_t>(std::size(gTrackVehicleInfo)))
+    struct Entry
     {
-        return false;
-    }
-    int32_t size = 0;
-    switch (cd)
+        uint32_t Offset;
+        uint16_t Size;
+    };
+
+    uint16_t ListOffsets[std::size(gTrackVehicleInfo)];
+    std::vector<Entry> Entries;
+    std::vector<rct_vehicle_info> Infos;
+
+    TrackVehicleInfoTable()
     {
-        case 0:
-            size = 1024;
-            break;
-        case 1:
-            size = 692;
-            break;
-        case 2:
-        case 3:
-        case 4:
-            size = 404;
-            break;
-        case 5:
-        case 6:
-        case 7:
-        case 8:
-            size = 208;
-            break;
-        case 9:
-        case 10:
-        case 11:
-        case 12:
-        case 13:
-        case 14:
-            size = 824;
-            break;
-        case 15:
-        case 16:
-            size = 868;
-            break;
+        std::unordered_map<const rct_vehicle_info*, uint32_t> copiedLists;
+        uint16_t offset = 0;
+        for (size_t cd = 0; cd < std::size(gTrackVehicleInfo); cd++)
+        {
+            ListOffsets[cd] = offset;
+            for (uint16_t typeAndDirection = 0; typeAndDirection < TrackVehicleInfoListSizes[cd]; typeAndDirection++)
+            {
+                const rct_vehicle_info_list* list = gTrackVehicleInfo[cd][typeAndDirection];
+                auto copied = copiedLists.find(list->info);
+                if (copied == copiedLists.end())
+                {
+                    copied = copiedLists.emplace(list->info, (uint32_t)Infos.size()).first;
+                    Infos.insert(Infos.end(), list->info, list->info + list->size);
+                }
+                Entries.push_back({ copied->second, list->size });
+            }
+            offset += TrackVehicleInfoListSizes[cd];
+        }
     }
-    if (typeAndDirection >= size)
+
+    const Entry* GetEntry(int32_t cd, int32_t typeAndDirection) const
     {
-        return false;
+        if (cd < 0 || cd >= static_cast<int32_t>(std::size(gTrackVehicleInfo)) || typeAndDirection < 0
+            || typeAndDirection >= TrackVehicleInfoListSizes[cd])
+        {
+            return nullptr;
+        }
+        return &Entries[ListOffsets[cd] + typeAndDirection];
     }
-    if (offset >= gTrackVehicleInfo[cd][typeAndDirection]->size)
+};
+
+static const TrackVehicleInfoTable _trackVehicleInfoTable;
+static constexpr const rct_vehicle_info ZeroVehicleInfo = {};
+
+/**
+ * Returns the move info list of a track piece and its size, for the motion loops that step through a piece without
+ * looking it up again for every step. An invalid piece has an empty list.
+ */
+static const rct_vehicle_info* vehicle_get_move_info_list(int32_t cd, int32_t typeAndDirection, uint16_t* outSize)
+{
+    const auto* entry = _trackVehicleInfoTable.GetEntry(cd, typeAndDirection);
+    if (entry == nullptr)
     {
-        return false;
+        *outSize = 0;
+        return &ZeroVehicleInfo;
     }
-    return true;
+    *outSize = entry->Size;
+    return &_trackVehicleInfoTable.Infos[entry->Offset];
 }
 
 const rct_vehicle_info* vehicle_get_move_info(int32_t cd, int32_t typeAndDirection, int32_t offset)
 {
-    if (!vehicle_move_info_valid(cd, typeAndDirection, offset))
+    uint16_t size;
+    const rct_vehicle_info* list = vehicle_get_move_info_list(cd, typeAndDirection, &size);
+    if (offset >= size)
     {
-        static constexpr const rct_vehicle_info zero = {};
-        return &zero;
+        return &ZeroVehicleInfo;
     }
-    return &gTrackVehicleInfo[cd][typeAndDirection]->info[offset];
+    return &list[offset];
 }
 
 uint16_t vehicle_get_move_info_size(int32_t cd, int32_t typeAndDirection)
 {
-    if (!vehicle_move_info_valid(cd, typeAndDirection, 0))
-    {
-        return 0;
-    }
-    return gTrackVehicleInfo[cd][typeAndDirection]->size;
+    uint16_t size;
+    vehicle_get_move_info_list(cd, typeAndDirection, &size);
+    return size;
 }
 
 rct_vehicle* try_get_vehicle(uint16_t spriteIndex)
@@ -1343,6 +1369,9 @@ void vehicle_update_all()
     if ((gScreenFlags & SCREEN_FLAGS_TRACK_DESIGNER) && gS6Info.editor_step != EDITOR_STEP_ROLLERCOASTER_DESIGNER)
         return;
 
+    // Collision detection only looks at other vehicles, so give it an index without the peeps and litter.
+    sprite_vehicle_spatial_index_begin();
+
     sprite_index = gSpriteListHead[SPRITE_LIST_VEHICLE_HEAD];
     while (sprite_index != SPRITE_INDEX_NULL)
     {
@@ -1351,6 +1380,8 @@ void vehicle_update_all()
 
         vehicle_update(vehicle);
     }
+
+    sprite_vehicle_spatial_index_end();
 }
 
 /**
@@ -6445,11 +6476,11 @@ bool vehicle_update_dodgems_collision(rct_vehicle* vehicle, int16_t x, int16_t y
         location.x += xy_offset.x;
         location.y += xy_offset.y;
 
-        uint16_t spriteIdx = sprite_get_first_in_quadrant(location.x * 32, location.y * 32);
+        uint16_t spriteIdx = sprite_get_first_vehicle_in_quadrant(location.x * 32, location.y * 32);
         while (spriteIdx != SPRITE_INDEX_NULL)
         {
             rct_vehicle* vehicle2 = GET_VEHICLE(spriteIdx);
-            spriteIdx = vehicle2->next_in_quadrant;
+            spriteIdx = sprite_get_next_vehicle_in_quadrant(spriteIdx);
 
             if (vehicle2 == vehicle)
                 continue;
@@ -7681,8 +7712,8 @@ static bool vehicle_update_motion_collision_detection(
         location.x += xy_offset.x;
         location.y += xy_offset.y;
 
-        collideId = sprite_get_first_in_quadrant(location.x * 32, location.y * 32);
-        for (; collideId != SPRITE_INDEX_NULL; collideId = collideVehicle->next_in_quadrant)
+        collideId = sprite_get_first_vehicle_in_quadrant(location.x * 32, location.y * 32);
+        for (; collideId != SPRITE_INDEX_NULL; collideId = sprite_get_next_vehicle_in_quadrant(collideId))
         {
             collideVehicle = GET_VEHICLE(collideId);
             if (collideVehicle == vehicle)
@@ -8132,23 +8163,39 @@ loc_6DB41D:
 }
 
 /**
- *
- *  rct2: 0x006DAEB9
+ * Whether a track piece changes the acceleration or state of the cars moving along it. Most pieces don't, so the motion
+ * loops only check the rest of the conditions for these.
  */
-static bool vehicle_update_track_motion_forwards(
-    rct_vehicle* vehicle, rct_ride_entry_vehicle* vehicleEntry, Ride* ride, rct_ride_entry* rideEntry)
+static bool vehicle_track_type_affects_motion(int32_t trackType)
 {
-    registers regs = {};
-loc_6DAEB9:
-    regs.edi = vehicle->track_type;
-    regs.cx = vehicle->track_type >> 2;
-    int32_t trackType = vehicle->track_type >> 2;
+    switch (trackType)
+    {
+        case TRACK_ELEM_HEARTLINE_TRANSFER_UP:
+        case TRACK_ELEM_HEARTLINE_TRANSFER_DOWN:
+        case TRACK_ELEM_BRAKES:
+        case TRACK_ELEM_BOOSTER:
+        case TRACK_ELEM_POWERED_LIFT:
+        case TRACK_ELEM_BRAKE_FOR_DROP:
+        case TRACK_ELEM_LOG_FLUME_REVERSER:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * The part of moving a car forwards by one step that depends on the special track piece it is on.
+ */
+static void vehicle_update_track_motion_forwards_special_track(
+    rct_vehicle* vehicle, rct_ride_entry_vehicle** vehicleEntry, Ride* ride, int32_t trackType)
+{
+    int32_t speed;
     if (trackType == TRACK_ELEM_HEARTLINE_TRANSFER_UP || trackType == TRACK_ELEM_HEARTLINE_TRANSFER_DOWN)
     {
         if (vehicle->track_progress == 80)
         {
             vehicle->vehicle_type ^= 1;
-            vehicleEntry = vehicle_get_vehicle_entry(vehicle);
+            *vehicleEntry = vehicle_get_vehicle_entry(vehicle);
         }
         if (_vehicleVelocityF64E08 >= 0x40000)
         {
@@ -8164,8 +8211,8 @@ loc_6DAEB9:
         if (!(ride->lifecycle_flags & RIDE_LIFECYCLE_BROKEN_DOWN && ride->breakdown_reason_pending == BREAKDOWN_BRAKES_FAILURE
               && ride->mechanic_status == RIDE_MECHANIC_STATUS_HAS_FIXED_STATION_BRAKES))
         {
-            regs.eax = vehicle->brake_speed << 16;
-            if (regs.eax < _vehicleVelocityF64E08)
+            speed = vehicle->brake_speed << 16;
+            if (speed < _vehicleVelocityF64E08)
             {
                 vehicle->acceleration = -_vehicleVelocityF64E08 * 16;
             }
@@ -8181,9 +8228,9 @@ loc_6DAEB9:
     }
     else if (track_element_is_booster(ride->type, trackType))
     {
-        regs.eax = get_booster_speed(ride->type, (vehicle->brake_speed << 16));
+        speed = get_booster_speed(ride->type, (vehicle->brake_speed << 16));
 
-        if (regs.eax > _vehicleVelocityF64E08)
+        if (speed > _vehicleVelocityF64E08)
         {
             vehicle->acceleration = RideProperties[ride->type].booster_acceleration << 16; //_vehicleVelocityF64E08 * 1.2;
         }
@@ -8218,8 +8265,8 @@ loc_6DAEB9:
         {
             if (vehicle->track_progress == 32)
             {
-                vehicle->vehicle_type = vehicleEntry->log_flume_reverser_vehicle_type;
-                vehicleEntry = vehicle_get_vehicle_entry(vehicle);
+                vehicle->vehicle_type = (*vehicleEntry)->log_flume_reverser_vehicle_type;
+                *vehicleEntry = vehicle_get_vehicle_entry(vehicle);
             }
         }
         else
@@ -8227,13 +8274,31 @@ loc_6DAEB9:
             vehicle->track_progress += 17;
         }
     }
+}
 
-    regs.ax = vehicle->track_progress + 1;
+/**
+ *
+ *  rct2: 0x006DAEB9
+ */
+static bool vehicle_update_track_motion_forwards(
+    rct_vehicle* vehicle, rct_ride_entry_vehicle* vehicleEntry, Ride* ride, rct_ride_entry* rideEntry)
+{
+    registers regs = {};
+loc_6DAEB9:
+    regs.edi = vehicle->track_type;
+    regs.cx = vehicle->track_type >> 2;
+    int32_t trackType = vehicle->track_type >> 2;
+    if (vehicle_track_type_affects_motion(trackType) || ride->type == RIDE_TYPE_REVERSE_FREEFALL_COASTER)
+    {
+        vehicle_update_track_motion_forwards_special_track(vehicle, &vehicleEntry, ride, trackType);
+    }
 
-    const rct_vehicle_info* moveInfo = vehicle_get_move_info(vehicle->var_CD, vehicle->track_type, 0);
+    regs.ax = vehicle->track_progress + 1;
 
-    // Track Total Progress is in the two bytes before the move info list
-    uint16_t trackTotalProgress = vehicle_get_move_info_size(vehicle->var_CD, vehicle->track_type);
+    // Track Total Progress is the size of the move info list, which is looked up again only when the car moves on to
+    // the next piece
+    uint16_t trackTotalProgress;
+    const rct_vehicle_info* moveInfos = vehicle_get_move_info_list(vehicle->var_CD, vehicle->track_type, &trackTotalProgress);
     if (regs.ax >= trackTotalProgress)
     {
         vehicle_update_crossings(vehicle);
@@ -8246,13 +8311,15 @@ loc_6DAEB9:
             return false;
         }
         regs.ax = 0;
+        moveInfos = vehicle_get_move_info_list(vehicle->var_CD, vehicle->track_type, &trackTotalProgress);
     }
 
     vehicle->track_progress = regs.ax;
     vehicle_update_handle_water_splash(vehicle);
 
     // loc_6DB706
-    moveInfo = vehicle_get_move_info(vehicle->var_CD, vehicle->track_type, vehicle->track_progress);
+    const rct_vehicle_info* moveInfo = vehicle->track_progress < trackTotalProgress ? &moveInfos[vehicle->track_progress]
+                                                                                    : &ZeroVehicleInfo;
     trackType = vehicle->track_type >> 2;
     {
         int16_t x = vehicle->track_x + moveInfo->x;
@@ -8535,16 +8602,11 @@ static bool vehicle_update_track_motion_backwards_get_new_track(
 }
 
 /**
- *
- *  rct2: 0x006DBA33
+ * The part of moving a car backwards by one step that depends on the special track piece it is on.
  */
-static bool vehicle_update_track_motion_backwards(
-    rct_vehicle* vehicle, rct_ride_entry_vehicle* vehicleEntry, Ride* ride, rct_ride_entry* rideEntry)
+static void vehicle_update_track_motion_backwards_special_track(rct_vehicle* vehicle, Ride* ride, uint16_t trackType)
 {
-    registers regs = {};
-
-loc_6DBA33:;
-    uint16_t trackType = vehicle->track_type >> 2;
+    int32_t speed;
     if (trackType == TRACK_ELEM_FLAT && ride->type == RIDE_TYPE_REVERSE_FREEFALL_COASTER)
     {
         int32_t unkVelocity = _vehicleVelocityF64E08;
@@ -8557,24 +8619,41 @@ loc_6DBA33:;
 
     if (trackType == TRACK_ELEM_BRAKES)
     {
-        regs.eax = -(vehicle->brake_speed << 16);
-        if (regs.eax > _vehicleVelocityF64E08)
+        speed = -(vehicle->brake_speed << 16);
+        if (speed > _vehicleVelocityF64E08)
         {
-            regs.eax = _vehicleVelocityF64E08 * -16;
-            vehicle->acceleration = regs.eax;
+            speed = _vehicleVelocityF64E08 * -16;
+            vehicle->acceleration = speed;
         }
     }
 
     if (track_element_is_booster(ride->type, trackType))
     {
-        regs.eax = get_booster_speed(ride->type, (vehicle->brake_speed << 16));
+        speed = get_booster_speed(ride->type, (vehicle->brake_speed << 16));
 
-        if (regs.eax < _vehicleVelocityF64E08)
+        if (speed < _vehicleVelocityF64E08)
         {
-            regs.eax = RideProperties[ride->type].booster_acceleration << 16;
-            vehicle->acceleration = regs.eax;
+            speed = RideProperties[ride->type].booster_acceleration << 16;
+            vehicle->acceleration = speed;
         }
     }
+}
+
+/**
+ *
+ *  rct2: 0x006DBA33
+ */
+static bool vehicle_update_track_motion_backwards(
+    rct_vehicle* vehicle, rct_ride_entry_vehicle* vehicleEntry, Ride* ride, rct_ride_entry* rideEntry)
+{
+    registers regs = {};
+
+loc_6DBA33:;
+    uint16_t trackType = vehicle->track_type >> 2;
+    if (vehicle_track_type_affects_motion(trackType) || ride->type == RIDE_TYPE_REVERSE_FREEFALL_COASTER)
+    {
+        vehicle_update_track_motion_backwards_special_track(vehicle, ride, trackType);
+    }
 
     regs.ax = vehicle->track_progress - 1;
     if (regs.ax == -1)
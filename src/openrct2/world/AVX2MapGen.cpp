@@ -0,0 +1,150 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../common.h"
+#include "../core/Guard.hpp"
+#include "MapGen.h"
+
+#ifdef __AVX2__
+
+#    include <immintrin.h>
+
+namespace
+{
+    // Rounds down, except for whole numbers that are not positive which are rounded to one less, like the scalar noise
+    __m256i simplex_floor_avx2(__m256 value)
+    {
+        const __m256i truncated = _mm256_cvttps_epi32(value);
+        const __m256i positive = _mm256_castps_si256(_mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_GT_OQ));
+        return _mm256_sub_epi32(truncated, _mm256_andnot_si256(positive, _mm256_set1_epi32(1)));
+    }
+
+    __m256 simplex_corner_avx2(__m256 x, __m256 y, __m256i hash)
+    {
+        const __m256 signBit = _mm256_set1_ps(-0.0f);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i two = _mm256_set1_epi32(2);
+
+        // The gradient picked by the low 3 bits of the hash, dotted with (x, y)
+        const __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(7));
+        const __m256 xFirst = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+        __m256 u = _mm256_blendv_ps(y, x, xFirst);
+        __m256 v = _mm256_mul_ps(_mm256_blendv_ps(x, y, xFirst), _mm256_set1_ps(2.0f));
+        const __m256 negateU = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(h, one), one));
+        const __m256 negateV = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(h, two), two));
+        u = _mm256_xor_ps(u, _mm256_and_ps(negateU, signBit));
+        v = _mm256_xor_ps(v, _mm256_and_ps(negateV, signBit));
+        const __m256 gradient = _mm256_add_ps(u, v);
+
+        __m256 t = _mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(0.5f), _mm256_mul_ps(x, x)), _mm256_mul_ps(y, y));
+        const __m256 outside = _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_LT_OQ);
+        t = _mm256_mul_ps(t, t);
+        return _mm256_andnot_ps(outside, _mm256_mul_ps(_mm256_mul_ps(t, t), gradient));
+    }
+
+    /**
+     * The same steps as the scalar simplex noise for 8 points at once, so the results are exactly the same. The
+     * permutation table is widened to 32 bits so it can be gathered from.
+     */
+    __m256 simplex_noise_avx2(const int32_t* perm, __m256 x, __m256 y)
+    {
+        const __m256 F2 = _mm256_set1_ps(0.366025403f);
+        const __m256 G2 = _mm256_set1_ps(0.211324865f);
+        const __m256i one = _mm256_set1_epi32(1);
+
+        // Skew the input space to determine which simplex cell we're in
+        const __m256 s = _mm256_mul_ps(_mm256_add_ps(x, y), F2);
+        const __m256i i = simplex_floor_avx2(_mm256_add_ps(x, s));
+        const __m256i j = simplex_floor_avx2(_mm256_add_ps(y, s));
+
+        const __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(i, j)), G2);
+        const __m256 x0 = _mm256_sub_ps(x, _mm256_sub_ps(_mm256_cvtepi32_ps(i), t));
+        const __m256 y0 = _mm256_sub_ps(y, _mm256_sub_ps(_mm256_cvtepi32_ps(j), t));
+
+        // Offsets for the middle corner, (1, 0) in the lower triangle and (0, 1) in the upper one
+        const __m256i lower = _mm256_castps_si256(_mm256_cmp_ps(x0, y0, _CMP_GT_OQ));
+        const __m256i i1 = _mm256_and_si256(lower, one);
+        const __m256i j1 = _mm256_andnot_si256(lower, one);
+
+        const __m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_cvtepi32_ps(i1)), G2);
+        const __m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_cvtepi32_ps(j1)), G2);
+        const __m256 x2 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_set1_ps(1.0f)), _mm256_set1_ps(2.0f * 0.211324865f));
+        const __m256 y2 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_set1_ps(1.0f)), _mm256_set1_ps(2.0f * 0.211324865f));
+
+        const __m256i ii = _mm256_and_si256(i, _mm256_set1_epi32(0xFF));
+        const __m256i jj = _mm256_and_si256(j, _mm256_set1_epi32(0xFF));
+        const __m256i hash0 = _mm256_i32gather_epi32(perm, _mm256_add_epi32(ii, _mm256_i32gather_epi32(perm, jj, 4)), 4);
+        const __m256i hash1 = _mm256_i32gather_epi32(
+            perm,
+            _mm256_add_epi32(_mm256_add_epi32(ii, i1), _mm256_i32gather_epi32(perm, _mm256_add_epi32(jj, j1), 4)), 4);
+        const __m256i hash2 = _mm256_i32gather_epi32(
+            perm, _mm256_add_epi32(_mm256_add_epi32(ii, one), _mm256_i32gather_epi32(perm, _mm256_add_epi32(jj, one), 4)),
+            4);
+
+        const __m256 n0 = simplex_corner_avx2(x0, y0, hash0);
+        const __m256 n1 = simplex_corner_avx2(x1, y1, hash1);
+        const __m256 n2 = simplex_corner_avx2(x2, y2, hash2);
+        return _mm256_mul_ps(_mm256_set1_ps(40.0f), _mm256_add_ps(_mm256_add_ps(n0, n1), n2));
+    }
+} // namespace
+
+void mapgen_fractal_noise_avx2(
+    const uint8_t* perm, int32_t x, int32_t y, int32_t count, float frequency, int32_t octaves, float lacunarity,
+    float persistence, float* dst)
+{
+    const int32_t simdCount = count > 0 ? (count & ~7) : 0;
+    if (simdCount != 0)
+    {
+        int32_t widePerm[512];
+        for (int32_t i = 0; i < 512; i++)
+        {
+            widePerm[i] = perm[i];
+        }
+
+        for (int32_t xx = 0; xx < simdCount; xx += 8)
+        {
+            const __m256 pointX = _mm256_cvtepi32_ps(
+                _mm256_add_epi32(_mm256_set1_epi32(x + xx), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+            const __m256 pointY = _mm256_cvtepi32_ps(_mm256_set1_epi32(y));
+            __m256 total = _mm256_setzero_ps();
+            float octaveFrequency = frequency;
+            float amplitude = persistence;
+            for (int32_t i = 0; i < octaves; i++)
+            {
+                const __m256 noise = simplex_noise_avx2(
+                    widePerm, _mm256_mul_ps(pointX, _mm256_set1_ps(octaveFrequency)),
+                    _mm256_mul_ps(pointY, _mm256_set1_ps(octaveFrequency)));
+                total = _mm256_add_ps(total, _mm256_mul_ps(noise, _mm256_set1_ps(amplitude)));
+                octaveFrequency *= lacunarity;
+                amplitude *= persistence;
+            }
+            _mm256_storeu_ps(dst + xx, total);
+        }
+    }
+    if (simdCount != count)
+    {
+        mapgen_fractal_noise_scalar(
+            perm, x + simdCount, y, count - simdCount, frequency, octaves, lacunarity, persistence, dst + simdCount);
+    }
+}
+
+#else
+
+#    ifdef OPENRCT2_X86
+#        error You have to compile this file with AVX2 enabled, when targeting x86!
+#    endif
+
+void mapgen_fractal_noise_avx2(
+    const uint8_t* perm, int32_t x, int32_t y, int32_t count, float frequency, int32_t octaves, float lacunarity,
+    float persistence, float* dst)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+#endif // __AVX2__
@@ -51,6 +51,9 @@ uint8_t gFootpathConstructValidDirections;
 money32 gFootpathPrice;
 uint8_t gFootpathGroundFlags;
 
+// Incremented whenever the walkable path network may have changed, used to invalidate cached path searches.
+uint32_t gFootpathNetworkVersion;
+
 static uint8_t* _footpathQueueChainNext;
 static uint8_t _footpathQueueChain[64];
 
@@ -994,6 +997,7 @@ void footpath_connect_edges(int32_t x, int32_t y, TileElement* tileElement, int3
     rct_neighbour_list neighbourList;
     rct_neighbour neighbour;
 
+    gFootpathNetworkVersion++;
     footpath_update_queue_chains();
 
     neighbour_list_init(&neighbourList);
@@ -1192,6 +1196,7 @@ void footpath_queue_chain_push(ride_id_t rideIndex)
  */
 void footpath_update_queue_chains()
 {
+    gFootpathNetworkVersion++;
     for (uint8_t* queueChainPtr = _footpathQueueChain; queueChainPtr < _footpathQueueChainNext; queueChainPtr++)
     {
         ride_id_t rideIndex = *queueChainPtr;
@@ -1617,23 +1622,36 @@ void PathElement::SetShouldDrawPathOverSupports(bool on)
     log_verbose("Setting 'draw path over supports' to %d", (size_t)on);
 }
 
+// The bit for an element of a tile in a mask of wide paths, elements past the 63rd all share the last bit
+static uint64_t footpath_wide_element_bit(int32_t index)
+{
+    return 1ULL << std::min(index, 63);
+}
+
 /**
  *
  *  rct2: 0x006A8B12
  *  clears the wide footpath flag for all footpaths
  *  at location
  */
-static void footpath_clear_wide(int32_t x, int32_t y)
+static uint64_t footpath_clear_wide(int32_t x, int32_t y)
 {
+    uint64_t wideElements = 0;
     TileElement* tileElement = map_get_first_element_at(x / 32, y / 32);
     if (tileElement == nullptr)
-        return;
+        return wideElements;
+    int32_t index = 0;
     do
     {
-        if (tileElement->GetType() != TILE_ELEMENT_TYPE_PATH)
-            continue;
-        tileElement->AsPath()->SetWide(false);
+        if (tileElement->GetType() == TILE_ELEMENT_TYPE_PATH)
+        {
+            if (tileElement->AsPath()->IsWide())
+                wideElements |= footpath_wide_element_bit(index);
+            tileElement->AsPath()->SetWide(false);
+        }
+        index++;
     } while (!(tileElement++)->IsLastForTile());
+    return wideElements;
 }
 
 /**
@@ -1678,7 +1696,8 @@ void footpath_update_path_wide_flags(int32_t x, int32_t y)
     if (y > 0x1FDF)
         return;
 
-    footpath_clear_wide(x, y);
+    uint64_t oldWideElements = footpath_clear_wide(x, y);
+    uint64_t newWideElements = 0;
     /* Rather than clearing the wide flag of the following tiles and
      * checking the state of them later, leave them intact and assume
      * they were cleared. Consequently only the wide flag for this single
@@ -1700,8 +1719,10 @@ void footpath_update_path_wide_flags(int32_t x, int32_t y)
     TileElement* tileElement = map_get_first_element_at(x / 32, y / 32);
     if (tileElement == nullptr)
         return;
+    int32_t index = -1;
     do
     {
+        index++;
         if (tileElement->GetType() != TILE_ELEMENT_TYPE_PATH)
             continue;
 
@@ -1866,9 +1887,18 @@ void footpath_update_path_wide_flags(int32_t x, int32_t y)
         {
             uint8_t e = tileElement->AsPath()->GetEdgesAndCorners();
             if ((e != 0b10101111) && (e != 0b01011111) && (e != 0b11101111))
+            {
                 tileElement->AsPath()->SetWide(true);
+                newWideElements |= footpath_wide_element_bit(index);
+            }
         }
     } while (!(tileElement++)->IsLastForTile());
+
+    // Elements sharing the last bit can not be told apart, so any of them counts as a change
+    if (newWideElements != oldWideElements || ((newWideElements | oldWideElements) & footpath_wide_element_bit(63)))
+    {
+        gFootpathNetworkVersion++;
+    }
 }
 
 bool footpath_is_blocked_by_vehicle(const TileCoordsXYZ& position)
@@ -2126,6 +2156,7 @@ static void footpath_fix_corners_around(int32_t x, int32_t y, TileElement* pathE
  */
 void footpath_remove_edges_at(int32_t x, int32_t y, TileElement* tileElement)
 {
+    gFootpathNetworkVersion++;
     if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK)
     {
         auto rideIndex = tileElement->AsTrack()->GetRideIndex();
@@ -167,6 +167,7 @@ extern uint8_t gFootpathConstructSlope;
 extern uint8_t gFootpathConstructValidDirections;
 extern money32 gFootpathPrice;
 extern uint8_t gFootpathGroundFlags;
+extern uint32_t gFootpathNetworkVersion;
 
 extern const LocationXY16 word_981D6C[4];
 extern const LocationXY16 BinUseOffsets[4];
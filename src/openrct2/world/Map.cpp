@@ -28,6 +28,7 @@
 #include "../audio/audio.h"
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
+#include "../drawing/LightFX.h"
 #include "../interface/Cursors.h"
 #include "../interface/Window.h"
 #include "../localisation/Date.h"
@@ -948,6 +949,8 @@ bool map_is_location_at_edge(const CoordsXY& loc)
  */
 void tile_element_remove(TileElement* tileElement)
 {
+    gFootpathNetworkVersion++;
+
     // Replace Nth element by (N+1)th element.
     // This loop will make tileElement point to the old last element position,
     // after copy it to it's new position
@@ -1001,6 +1004,9 @@ void map_remove_all_rides()
                 break;
         }
     } while (tile_element_iterator_next(&it));
+
+    // Queues no longer lead to their rides
+    gFootpathNetworkVersion++;
 }
 
 /**
@@ -1219,6 +1225,7 @@ TileElement* tile_element_insert(const TileCoordsXYZ& loc, int32_t occupiedQuadr
     }
 
     gNextFreeTileElement = newTileElement;
+    gFootpathNetworkVersion++;
     return insertedElement;
 }
 
@@ -1987,6 +1994,10 @@ static void map_invalidate_tile_under_zoom(int32_t x, int32_t y, int32_t z0, int
     x2 = screenCoord.x + 32;
     y2 = screenCoord.y + 32 - z0;
 
+#ifdef __ENABLE_LIGHTFX__
+    lightfx_invalidate_occlusion(x1, y1, x2, y2);
+#endif
+
     for (int32_t i = 0; i < MAX_VIEWPORT_COUNT; i++)
     {
         rct_viewport* viewport = &g_viewport_list[i];
@@ -2055,6 +2066,10 @@ void map_invalidate_region(const LocationXY16& mins, const LocationXY16& maxs)
     bottom += 32;
     top -= 32 + 2080;
 
+#ifdef __ENABLE_LIGHTFX__
+    lightfx_invalidate_occlusion(left, top, right, bottom);
+#endif
+
     for (int32_t i = 0; i < MAX_VIEWPORT_COUNT; i++)
     {
         rct_viewport* viewport = &g_viewport_list[i];
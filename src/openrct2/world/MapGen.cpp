@@ -12,8 +12,10 @@
 #include "../Context.h"
 #include "../Game.h"
 #include "../common.h"
+#include "../config/Config.h"
 #include "../core/Guard.hpp"
 #include "../core/Imaging.h"
+#include "../core/JobPool.hpp"
 #include "../core/String.hpp"
 #include "../localisation/StringIds.h"
 #include "../object/Object.h"
@@ -28,7 +30,9 @@
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <functional>
 #include <iterator>
+#include <memory>
 #include <vector>
 
 #pragma region Height map struct
@@ -106,6 +110,43 @@ static void set_height(int32_t x, int32_t y, int32_t height)
         _height[x + y * _heightSize] = height;
 }
 
+// Bands are not made smaller than this many lines, so each job has enough work to be worth it
+static constexpr int32_t MAPGEN_MIN_BAND_HEIGHT = 16;
+
+static std::unique_ptr<JobPool> _mapGenJobs;
+
+/**
+ * Runs a function for bands of lines of a height map on the job pool, if multithreading is enabled. Each line has to only
+ * depend on what was there before, so the result is the same however the lines are split up.
+ */
+static void mapgen_run_in_bands(int32_t height, const std::function<void(int32_t, int32_t)>& fn)
+{
+    bool useMultithreading = gConfigGeneral.multithreading;
+    if (useMultithreading && _mapGenJobs == nullptr)
+    {
+        _mapGenJobs = std::make_unique<JobPool>();
+    }
+    else if (!useMultithreading && _mapGenJobs != nullptr)
+    {
+        _mapGenJobs.reset();
+    }
+
+    int32_t bandCount = std::min<int32_t>(std::thread::hardware_concurrency(), height / MAPGEN_MIN_BAND_HEIGHT);
+    if (_mapGenJobs == nullptr || bandCount <= 1)
+    {
+        fn(0, height);
+        return;
+    }
+
+    for (int32_t band = 0; band < bandCount; band++)
+    {
+        int32_t top = (height * band) / bandCount;
+        int32_t bottom = (height * (band + 1)) / bandCount;
+        _mapGenJobs->AddTask([&fn, top, bottom]() { fn(top, bottom); });
+    }
+    _mapGenJobs->Join();
+}
+
 void mapgen_generate_blank(mapgen_settings* settings)
 {
     int32_t x, y;
@@ -411,32 +452,32 @@ static void mapgen_set_water_level(int32_t waterLevel)
  */
 static void mapgen_smooth_height(int32_t iterations)
 {
-    int32_t i, x, y, xx, yy, avg;
-    int32_t arraySize = _heightSize * _heightSize * sizeof(uint8_t);
-    uint8_t* copyHeight = new uint8_t[arraySize];
+    std::vector<uint8_t> copyHeight(_heightSize * _heightSize);
 
-    for (i = 0; i < iterations; i++)
+    for (int32_t i = 0; i < iterations; i++)
     {
-        std::memcpy(copyHeight, _height, arraySize);
-        for (y = 1; y < _heightSize - 1; y++)
-        {
-            for (x = 1; x < _heightSize - 1; x++)
+        std::copy_n(_height, copyHeight.size(), copyHeight.begin());
+        mapgen_run_in_bands(_heightSize - 2, [&copyHeight](int32_t top, int32_t bottom) {
+            for (int32_t y = top + 1; y < bottom + 1; y++)
             {
-                avg = 0;
-                for (yy = -1; yy <= 1; yy++)
+                const uint8_t* above = &copyHeight[(y - 1) * _heightSize];
+                const uint8_t* line = &copyHeight[y * _heightSize];
+                const uint8_t* below = &copyHeight[(y + 1) * _heightSize];
+                uint8_t* dst = &_height[y * _heightSize];
+
+                // Keep the sums of the columns either side, so each tile only adds one more column
+                int32_t left = above[0] + line[0] + below[0];
+                int32_t middle = above[1] + line[1] + below[1];
+                for (int32_t x = 1; x < _heightSize - 1; x++)
                 {
-                    for (xx = -1; xx <= 1; xx++)
-                    {
-                        avg += copyHeight[(y + yy) * _heightSize + (x + xx)];
-                    }
+                    int32_t right = above[x + 1] + line[x + 1] + below[x + 1];
+                    dst[x] = (left + middle + right) / 9;
+                    left = middle;
+                    middle = right;
                 }
-                avg /= 9;
-                set_height(x, y, avg);
             }
-        }
+        });
     }
-
-    delete[] copyHeight;
 }
 
 /**
@@ -492,34 +533,50 @@ static void mapgen_set_height()
  *   - https://code.google.com/p/fractalterraingeneration/wiki/Fractional_Brownian_Motion
  */
 
-static float generate(float x, float y);
+static float generate(const uint8_t* perm, float x, float y);
 static int32_t fast_floor(float x);
 static float grad(int32_t hash, float x, float y);
 
-static uint8_t perm[512];
+static uint8_t _perm[512];
+
+static void (*mapgen_fractal_noise_fn)(
+    const uint8_t* perm, int32_t x, int32_t y, int32_t count, float frequency, int32_t octaves, float lacunarity,
+    float persistence, float* dst)
+    = nullptr;
 
 static void noise_rand()
 {
-    for (auto& i : perm)
+    for (auto& i : _perm)
     {
         i = util_rand() & 0xFF;
     }
 }
 
-static float fractal_noise(int32_t x, int32_t y, float frequency, int32_t octaves, float lacunarity, float persistence)
+static float fractal_noise(
+    const uint8_t* perm, int32_t x, int32_t y, float frequency, int32_t octaves, float lacunarity, float persistence)
 {
     float total = 0.0f;
     float amplitude = persistence;
     for (int32_t i = 0; i < octaves; i++)
     {
-        total += generate(x * frequency, y * frequency) * amplitude;
+        total += generate(perm, x * frequency, y * frequency) * amplitude;
         frequency *= lacunarity;
         amplitude *= persistence;
     }
     return total;
 }
 
-static float generate(float x, float y)
+void mapgen_fractal_noise_scalar(
+    const uint8_t* perm, int32_t x, int32_t y, int32_t count, float frequency, int32_t octaves, float lacunarity,
+    float persistence, float* dst)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        dst[i] = fractal_noise(perm, x + i, y, frequency, octaves, lacunarity, persistence);
+    }
+}
+
+static float generate(const uint8_t* perm, float x, float y)
 {
     const float F2 = 0.366025403f; // F2 = 0.5*(sqrt(3.0)-1.0)
     const float G2 = 0.211324865f; // G2 = (3.0-sqrt(3.0))/6.0
@@ -563,8 +620,8 @@ static float generate(float x, float y)
     float y2 = y0 - 1.0f + 2.0f * G2;
 
     // Wrap the integer indices at 256, to avoid indexing perm[] out of bounds
-    int32_t ii = i % 256;
-    int32_t jj = j % 256;
+    int32_t ii = i & 0xFF;
+    int32_t jj = j & 0xFF;
 
     // Calculate the contribution from the three corners
     float t0 = 0.5f - x0 * x0 - y0 * y0;
@@ -620,8 +677,6 @@ static float grad(int32_t hash, float x, float y)
 
 static void mapgen_simplex(mapgen_settings* settings)
 {
-    int32_t x, y;
-
     float freq = settings->simplex_base_freq * (1.0f / _heightSize);
     int32_t octaves = settings->simplex_octaves;
 
@@ -629,16 +684,31 @@ static void mapgen_simplex(mapgen_settings* settings)
     int32_t high = settings->simplex_high;
 
     noise_rand();
-    for (y = 0; y < _heightSize; y++)
-    {
-        for (x = 0; x < _heightSize; x++)
+    if (mapgen_fractal_noise_fn == nullptr)
+    {
+        if (avx2_available())
+            mapgen_fractal_noise_fn = mapgen_fractal_noise_avx2;
+        else if (sse41_available())
+            mapgen_fractal_noise_fn = mapgen_fractal_noise_sse4_1;
+        else
+            mapgen_fractal_noise_fn = mapgen_fractal_noise_scalar;
+    }
+
+    // The noise of each point only depends on the permutation table, so the lines can be generated in any order
+    mapgen_run_in_bands(_heightSize, [=](int32_t top, int32_t bottom) {
+        std::vector<float> noise(_heightSize);
+        for (int32_t y = top; y < bottom; y++)
         {
-            float noiseValue = std::clamp(fractal_noise(x, y, freq, octaves, 2.0f, 0.65f), -1.0f, 1.0f);
-            float normalisedNoiseValue = (noiseValue + 1.0f) / 2.0f;
+            mapgen_fractal_noise_fn(_perm, 0, y, _heightSize, freq, octaves, 2.0f, 0.65f, noise.data());
+            for (int32_t x = 0; x < _heightSize; x++)
+            {
+                float noiseValue = std::clamp(noise[x], -1.0f, 1.0f);
+                float normalisedNoiseValue = (noiseValue + 1.0f) / 2.0f;
 
-            set_height(x, y, low + (int32_t)(normalisedNoiseValue * high));
+                set_height(x, y, low + (int32_t)(normalisedNoiseValue * high));
+            }
         }
-    }
+    });
 }
 
 #pragma endregion
@@ -726,46 +796,40 @@ void mapgen_unload_heightmap()
 static void mapgen_smooth_heightmap(uint8_t* src, int32_t strength)
 {
     // Create buffer to store one channel
-    uint8_t* dest = new uint8_t[_heightMapData.width * _heightMapData.height];
+    std::vector<uint8_t> dest(_heightMapData.width * _heightMapData.height);
 
     for (int32_t i = 0; i < strength; i++)
     {
         // Calculate box blur value to all pixels of the surface
-        for (uint32_t y = 0; y < _heightMapData.height; y++)
-        {
-            for (uint32_t x = 0; x < _heightMapData.width; x++)
+        mapgen_run_in_bands(_heightMapData.height, [src, &dest](int32_t top, int32_t bottom) {
+            for (int32_t y = top; y < bottom; y++)
             {
-                uint32_t heightSum = 0;
-
-                // Loop over neighbour pixels, all of them have the same weight
-                for (int8_t offsetX = -1; offsetX <= 1; offsetX++)
+                for (uint32_t x = 0; x < _heightMapData.width; x++)
                 {
-                    for (int8_t offsetY = -1; offsetY <= 1; offsetY++)
+                    uint32_t heightSum = 0;
+
+                    // Loop over neighbour pixels, all of them have the same weight
+                    for (int8_t offsetX = -1; offsetX <= 1; offsetX++)
                     {
-                        // Clamp x and y so they stay within the image
-                        // This assumes the height map is not tiled, and increases the weight of the edges
-                        const int32_t readX = std::clamp<int32_t>(x + offsetX, 0, _heightMapData.width - 1);
-                        const int32_t readY = std::clamp<int32_t>(y + offsetY, 0, _heightMapData.height - 1);
-                        heightSum += src[readX + readY * _heightMapData.width];
+                        for (int8_t offsetY = -1; offsetY <= 1; offsetY++)
+                        {
+                            // Clamp x and y so they stay within the image
+                            // This assumes the height map is not tiled, and increases the weight of the edges
+                            const int32_t readX = std::clamp<int32_t>(x + offsetX, 0, _heightMapData.width - 1);
+                            const int32_t readY = std::clamp<int32_t>(y + offsetY, 0, _heightMapData.height - 1);
+                            heightSum += src[readX + readY * _heightMapData.width];
+                        }
                     }
-                }
 
-                // Take average
-                dest[x + y * _heightMapData.width] = heightSum / 9;
+                    // Take average
+                    dest[x + y * _heightMapData.width] = heightSum / 9;
+                }
             }
-        }
+        });
 
         // Now apply the blur to the source pixels
-        for (uint32_t y = 0; y < _heightMapData.height; y++)
-        {
-            for (uint32_t x = 0; x < _heightMapData.width; x++)
-            {
-                src[x + y * _heightMapData.width] = dest[x + y * _heightMapData.width];
-            }
-        }
+        std::copy(dest.begin(), dest.end(), src);
     }
-
-    delete[] dest;
 }
 
 void mapgen_generate_from_heightmap(mapgen_settings* settings)
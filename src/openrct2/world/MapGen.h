@@ -42,3 +42,16 @@ void mapgen_generate_custom_simplex(mapgen_settings* settings);
 bool mapgen_load_heightmap(const utf8* path);
 void mapgen_unload_heightmap();
 void mapgen_generate_from_heightmap(mapgen_settings* settings);
+
+/**
+ * Generates the fractal simplex noise of count points of a line, starting at x.
+ */
+void mapgen_fractal_noise_scalar(
+    const uint8_t* perm, int32_t x, int32_t y, int32_t count, float frequency, int32_t octaves, float lacunarity,
+    float persistence, float* dst);
+void mapgen_fractal_noise_sse4_1(
+    const uint8_t* perm, int32_t x, int32_t y, int32_t count, float frequency, int32_t octaves, float lacunarity,
+    float persistence, float* dst);
+void mapgen_fractal_noise_avx2(
+    const uint8_t* perm, int32_t x, int32_t y, int32_t count, float frequency, int32_t octaves, float lacunarity,
+    float persistence, float* dst);
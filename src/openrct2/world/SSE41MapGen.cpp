@@ -0,0 +1,142 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../common.h"
+#include "../core/Guard.hpp"
+#include "MapGen.h"
+
+#ifdef __SSE4_1__
+
+#    include <immintrin.h>
+
+namespace
+{
+    // Rounds down, except for whole numbers that are not positive which are rounded to one less, like the scalar noise
+    __m128i simplex_floor_sse4_1(__m128 value)
+    {
+        const __m128i truncated = _mm_cvttps_epi32(value);
+        const __m128i positive = _mm_castps_si128(_mm_cmpgt_ps(value, _mm_setzero_ps()));
+        return _mm_sub_epi32(truncated, _mm_andnot_si128(positive, _mm_set1_epi32(1)));
+    }
+
+    __m128 simplex_corner_sse4_1(__m128 x, __m128 y, __m128i hash)
+    {
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128i two = _mm_set1_epi32(2);
+
+        // The gradient picked by the low 3 bits of the hash, dotted with (x, y)
+        const __m128i h = _mm_and_si128(hash, _mm_set1_epi32(7));
+        const __m128 xFirst = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+        __m128 u = _mm_blendv_ps(y, x, xFirst);
+        __m128 v = _mm_mul_ps(_mm_blendv_ps(x, y, xFirst), _mm_set1_ps(2.0f));
+        const __m128 negateU = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(h, one), one));
+        const __m128 negateV = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(h, two), two));
+        u = _mm_xor_ps(u, _mm_and_ps(negateU, signBit));
+        v = _mm_xor_ps(v, _mm_and_ps(negateV, signBit));
+        const __m128 gradient = _mm_add_ps(u, v);
+
+        __m128 t = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.5f), _mm_mul_ps(x, x)), _mm_mul_ps(y, y));
+        const __m128 outside = _mm_cmplt_ps(t, _mm_setzero_ps());
+        t = _mm_mul_ps(t, t);
+        return _mm_andnot_ps(outside, _mm_mul_ps(_mm_mul_ps(t, t), gradient));
+    }
+
+    /**
+     * The same steps as the scalar simplex noise for 4 points at once, so the results are exactly the same.
+     */
+    __m128 simplex_noise_sse4_1(const uint8_t* perm, __m128 x, __m128 y)
+    {
+        const __m128 F2 = _mm_set1_ps(0.366025403f);
+        const __m128 G2 = _mm_set1_ps(0.211324865f);
+        const __m128i one = _mm_set1_epi32(1);
+
+        // Skew the input space to determine which simplex cell we're in
+        const __m128 s = _mm_mul_ps(_mm_add_ps(x, y), F2);
+        const __m128i i = simplex_floor_sse4_1(_mm_add_ps(x, s));
+        const __m128i j = simplex_floor_sse4_1(_mm_add_ps(y, s));
+
+        const __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(i, j)), G2);
+        const __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+        const __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+
+        // Offsets for the middle corner, (1, 0) in the lower triangle and (0, 1) in the upper one
+        const __m128i lower = _mm_castps_si128(_mm_cmpgt_ps(x0, y0));
+        const __m128i i1 = _mm_and_si128(lower, one);
+        const __m128i j1 = _mm_andnot_si128(lower, one);
+
+        const __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, _mm_cvtepi32_ps(i1)), G2);
+        const __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, _mm_cvtepi32_ps(j1)), G2);
+        const __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, _mm_set1_ps(1.0f)), _mm_set1_ps(2.0f * 0.211324865f));
+        const __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, _mm_set1_ps(1.0f)), _mm_set1_ps(2.0f * 0.211324865f));
+
+        // The permutation table is looked up for each point on its own
+        alignas(16) int32_t ii[4], jj[4], ii1[4], jj1[4];
+        _mm_store_si128((__m128i*)ii, _mm_and_si128(i, _mm_set1_epi32(0xFF)));
+        _mm_store_si128((__m128i*)jj, _mm_and_si128(j, _mm_set1_epi32(0xFF)));
+        _mm_store_si128((__m128i*)ii1, i1);
+        _mm_store_si128((__m128i*)jj1, j1);
+        alignas(16) int32_t hash0[4], hash1[4], hash2[4];
+        for (int32_t k = 0; k < 4; k++)
+        {
+            hash0[k] = perm[ii[k] + perm[jj[k]]];
+            hash1[k] = perm[ii[k] + ii1[k] + perm[jj[k] + jj1[k]]];
+            hash2[k] = perm[ii[k] + 1 + perm[jj[k] + 1]];
+        }
+
+        const __m128 n0 = simplex_corner_sse4_1(x0, y0, _mm_load_si128((const __m128i*)hash0));
+        const __m128 n1 = simplex_corner_sse4_1(x1, y1, _mm_load_si128((const __m128i*)hash1));
+        const __m128 n2 = simplex_corner_sse4_1(x2, y2, _mm_load_si128((const __m128i*)hash2));
+        return _mm_mul_ps(_mm_set1_ps(40.0f), _mm_add_ps(_mm_add_ps(n0, n1), n2));
+    }
+} // namespace
+
+void mapgen_fractal_noise_sse4_1(
+    const uint8_t* perm, int32_t x, int32_t y, int32_t count, float frequency, int32_t octaves, float lacunarity,
+    float persistence, float* dst)
+{
+    const int32_t simdCount = count > 0 ? (count & ~3) : 0;
+    for (int32_t xx = 0; xx < simdCount; xx += 4)
+    {
+        const __m128 pointX = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x + xx), _mm_setr_epi32(0, 1, 2, 3)));
+        const __m128 pointY = _mm_cvtepi32_ps(_mm_set1_epi32(y));
+        __m128 total = _mm_setzero_ps();
+        float octaveFrequency = frequency;
+        float amplitude = persistence;
+        for (int32_t i = 0; i < octaves; i++)
+        {
+            const __m128 noise = simplex_noise_sse4_1(
+                perm, _mm_mul_ps(pointX, _mm_set1_ps(octaveFrequency)), _mm_mul_ps(pointY, _mm_set1_ps(octaveFrequency)));
+            total = _mm_add_ps(total, _mm_mul_ps(noise, _mm_set1_ps(amplitude)));
+            octaveFrequency *= lacunarity;
+            amplitude *= persistence;
+        }
+        _mm_storeu_ps(dst + xx, total);
+    }
+    if (simdCount != count)
+    {
+        mapgen_fractal_noise_scalar(
+            perm, x + simdCount, y, count - simdCount, frequency, octaves, lacunarity, persistence, dst + simdCount);
+    }
+}
+
+#else
+
+#    ifdef OPENRCT2_X86
+#        error You have to compile this file with SSE4.1 enabled, when targetting x86!
+#    endif
+
+void mapgen_fractal_noise_sse4_1(
+    const uint8_t* perm, int32_t x, int32_t y, int32_t count, float frequency, int32_t octaves, float lacunarity,
+    float persistence, float* dst)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+#endif // __SSE4_1__
@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iterator>
+#include <vector>
 
 uint16_t gSpriteListHead[SPRITE_LIST_COUNT];
 uint16_t gSpriteListCount[SPRITE_LIST_COUNT];
@@ -35,6 +36,13 @@ static bool _spriteFlashingList[MAX_SPRITES];
 
 uint16_t gSpriteSpatialIndex[0x10001];
 
+// A copy of the spatial index that only links vehicles, in the same order as they appear in gSpriteSpatialIndex.
+// It is rebuilt at the start of each vehicle update and kept in sync by sprite_move and sprite_remove while active.
+static std::vector<uint16_t> _vehicleSpatialIndex;
+static uint16_t _vehicleNextInQuadrant[MAX_SPRITES];
+static std::vector<size_t> _vehicleSpatialIndexUsed;
+static bool _vehicleSpatialIndexActive;
+
 const rct_string_id litterNames[12] = { STR_LITTER_VOMIT,
                                         STR_LITTER_VOMIT,
                                         STR_SHOP_ITEM_SINGULAR_EMPTY_CAN,
@@ -98,6 +106,115 @@ uint16_t sprite_get_first_in_quadrant(int32_t x, int32_t y)
     return gSpriteSpatialIndex[offset];
 }
 
+static uint16_t sprite_find_vehicle_in_quadrant(uint16_t spriteIndex)
+{
+    while (spriteIndex != SPRITE_INDEX_NULL)
+    {
+        rct_sprite* sprite = get_sprite(spriteIndex);
+        if (sprite->generic.sprite_identifier == SPRITE_IDENTIFIER_VEHICLE)
+            break;
+        spriteIndex = sprite->generic.next_in_quadrant;
+    }
+    return spriteIndex;
+}
+
+/**
+ * Returns the first vehicle in the quadrant, in the same order as sprite_get_first_in_quadrant but skipping any
+ * other sprites.
+ */
+uint16_t sprite_get_first_vehicle_in_quadrant(int32_t x, int32_t y)
+{
+    int32_t offset = ((x & 0x1FE0) << 3) | (y >> 5);
+    if (_vehicleSpatialIndexActive)
+    {
+        return _vehicleSpatialIndex[offset];
+    }
+    return sprite_find_vehicle_in_quadrant(gSpriteSpatialIndex[offset]);
+}
+
+uint16_t sprite_get_next_vehicle_in_quadrant(uint16_t spriteIndex)
+{
+    if (_vehicleSpatialIndexActive)
+    {
+        return _vehicleNextInQuadrant[spriteIndex];
+    }
+    return sprite_find_vehicle_in_quadrant(get_sprite(spriteIndex)->generic.next_in_quadrant);
+}
+
+static void vehicle_spatial_index_link_quadrant(size_t index)
+{
+    uint16_t* tail = &_vehicleSpatialIndex[index];
+    for (uint16_t spriteIndex = sprite_find_vehicle_in_quadrant(gSpriteSpatialIndex[index]); spriteIndex != SPRITE_INDEX_NULL;
+         spriteIndex = sprite_find_vehicle_in_quadrant(get_sprite(spriteIndex)->generic.next_in_quadrant))
+    {
+        *tail = spriteIndex;
+        tail = &_vehicleNextInQuadrant[spriteIndex];
+    }
+    *tail = SPRITE_INDEX_NULL;
+}
+
+/**
+ * Builds the vehicle only spatial index from the current sprite spatial index and keeps it up to date until
+ * sprite_vehicle_spatial_index_end is called.
+ */
+void sprite_vehicle_spatial_index_begin()
+{
+    if (_vehicleSpatialIndex.empty())
+    {
+        _vehicleSpatialIndex.resize(std::size(gSpriteSpatialIndex), SPRITE_INDEX_NULL);
+    }
+    for (size_t index : _vehicleSpatialIndexUsed)
+    {
+        _vehicleSpatialIndex[index] = SPRITE_INDEX_NULL;
+    }
+    _vehicleSpatialIndexUsed.clear();
+
+    for (auto list : { SPRITE_LIST_VEHICLE_HEAD, SPRITE_LIST_VEHICLE })
+    {
+        for (uint16_t spriteIndex = gSpriteListHead[list]; spriteIndex != SPRITE_INDEX_NULL;
+             spriteIndex = get_sprite(spriteIndex)->generic.next)
+        {
+            rct_sprite* sprite = get_sprite(spriteIndex);
+            size_t index = GetSpatialIndexOffset(sprite->generic.x, sprite->generic.y);
+            // Quadrants that have already been linked contain at least this vehicle.
+            if (_vehicleSpatialIndex[index] == SPRITE_INDEX_NULL)
+            {
+                _vehicleSpatialIndexUsed.push_back(index);
+                vehicle_spatial_index_link_quadrant(index);
+            }
+        }
+    }
+    _vehicleSpatialIndexActive = true;
+}
+
+void sprite_vehicle_spatial_index_end()
+{
+    _vehicleSpatialIndexActive = false;
+}
+
+static void vehicle_spatial_index_remove(size_t index, uint16_t spriteIndex)
+{
+    uint16_t* link = &_vehicleSpatialIndex[index];
+    while (*link != SPRITE_INDEX_NULL && *link != spriteIndex)
+    {
+        link = &_vehicleNextInQuadrant[*link];
+    }
+    if (*link != SPRITE_INDEX_NULL)
+    {
+        *link = _vehicleNextInQuadrant[spriteIndex];
+    }
+}
+
+static void vehicle_spatial_index_move(size_t currentIndex, size_t newIndex, uint16_t spriteIndex)
+{
+    vehicle_spatial_index_remove(currentIndex, spriteIndex);
+
+    // Matches sprite_move, which inserts the sprite at the front of its new quadrant.
+    _vehicleNextInQuadrant[spriteIndex] = _vehicleSpatialIndex[newIndex];
+    _vehicleSpatialIndex[newIndex] = spriteIndex;
+    _vehicleSpatialIndexUsed.push_back(newIndex);
+}
+
 static void invalidate_sprite_max_zoom(rct_sprite* sprite, int32_t maxZoom)
 {
     if (sprite->generic.sprite_left == LOCATION_NULL)
@@ -648,6 +765,11 @@ void sprite_move(int16_t x, int16_t y, int16_t z, rct_sprite* sprite)
         int32_t tempSpriteIndex = gSpriteSpatialIndex[newIndex];
         gSpriteSpatialIndex[newIndex] = sprite->generic.sprite_index;
         sprite->generic.next_in_quadrant = tempSpriteIndex;
+
+        if (_vehicleSpatialIndexActive && sprite->generic.sprite_identifier == SPRITE_IDENTIFIER_VEHICLE)
+        {
+            vehicle_spatial_index_move(currentIndex, newIndex, sprite->generic.sprite_index);
+        }
     }
 
     if (x == LOCATION_NULL)
@@ -689,11 +811,16 @@ void sprite_remove(rct_sprite* sprite)
         peep->SetName({});
     }
 
+    size_t quadrantIndex = GetSpatialIndexOffset(sprite->generic.x, sprite->generic.y);
+    if (_vehicleSpatialIndexActive && sprite->generic.sprite_identifier == SPRITE_IDENTIFIER_VEHICLE)
+    {
+        vehicle_spatial_index_remove(quadrantIndex, sprite->generic.sprite_index);
+    }
+
     move_sprite_to_list(sprite, SPRITE_LIST_FREE);
     sprite->generic.sprite_identifier = SPRITE_IDENTIFIER_NULL;
     _spriteFlashingList[sprite->generic.sprite_index] = false;
 
-    size_t quadrantIndex = GetSpatialIndexOffset(sprite->generic.x, sprite->generic.y);
     uint16_t* spriteIndex = &gSpriteSpatialIndex[quadrantIndex];
     rct_sprite* quadrantSprite;
     while (*spriteIndex != SPRITE_INDEX_NULL && (quadrantSprite = get_sprite(*spriteIndex)) != sprite)
@@ -212,6 +212,10 @@ void litter_remove_at(int32_t x, int32_t y, int32_t z);
 void sprite_misc_explosion_cloud_create(int32_t x, int32_t y, int32_t z);
 void sprite_misc_explosion_flare_create(int32_t x, int32_t y, int32_t z);
 uint16_t sprite_get_first_in_quadrant(int32_t x, int32_t y);
+uint16_t sprite_get_first_vehicle_in_quadrant(int32_t x, int32_t y);
+uint16_t sprite_get_next_vehicle_in_quadrant(uint16_t spriteIndex);
+void sprite_vehicle_spatial_index_begin();
+void sprite_vehicle_spatial_index_end();
 void sprite_position_tween_store_a();
 void sprite_position_tween_store_b();
 void sprite_position_tween_all(float nudge);
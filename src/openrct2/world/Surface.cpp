@@ -13,6 +13,7 @@
 #include "../object/ObjectManager.h"
 #include "../object/TerrainSurfaceObject.h"
 #include "../scenario/Scenario.h"
+#include "Footpath.h"
 #include "Location.hpp"
 #include "Map.h"
 
@@ -185,6 +186,11 @@ uint8_t SurfaceElement::GetOwnership() const
 
 void SurfaceElement::SetOwnership(uint8_t newOwnership)
 {
+    // Staff only walk on owned land, so ownership is part of their path network.
+    if ((Ownership & TILE_ELEMENT_SURFACE_OWNERSHIP_MASK) != (newOwnership & TILE_ELEMENT_SURFACE_OWNERSHIP_MASK))
+    {
+        gFootpathNetworkVersion++;
+    }
     Ownership &= ~TILE_ELEMENT_SURFACE_OWNERSHIP_MASK;
     Ownership |= (newOwnership & TILE_ELEMENT_SURFACE_OWNERSHIP_MASK);
 }
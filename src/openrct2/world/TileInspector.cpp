@@ -69,6 +69,8 @@ static bool map_swap_elements_at(CoordsXY loc, int16_t first, int16_t second)
         secondElement->SetLastForTile(!secondElement->IsLastForTile());
     }
 
+    // Which of several paths on a tile gets used depends on their order
+    gFootpathNetworkVersion++;
     return true;
 }
 
@@ -281,6 +283,7 @@ GameActionResult::Ptr tile_inspector_rotate_element_at(CoordsXY loc, int32_t ele
             }
         }
 
+        gFootpathNetworkVersion++;
         map_invalidate_tile_full(loc.x, loc.y);
 
         if ((uint32_t)(loc.x / 32) == windowTileInspectorTileX && (uint32_t)(loc.y / 32) == windowTileInspectorTileY)
@@ -453,6 +456,7 @@ GameActionResult::Ptr tile_inspector_any_base_height_offset(
 
         tileElement->base_height += heightOffset;
         tileElement->clearance_height += heightOffset;
+        gFootpathNetworkVersion++;
 
         map_invalidate_tile_full(loc.x, loc.y);
 
@@ -610,6 +614,7 @@ GameActionResult::Ptr tile_inspector_path_set_sloped(CoordsXY loc, int32_t eleme
     if (isExecuting)
     {
         pathElement->AsPath()->SetSloped(sloped);
+        gFootpathNetworkVersion++;
 
         map_invalidate_tile_full(loc.x, loc.y);
 
@@ -659,6 +664,7 @@ GameActionResult::Ptr tile_inspector_path_toggle_edge(CoordsXY loc, int32_t elem
     {
         uint8_t newEdges = pathElement->AsPath()->GetEdgesAndCorners() ^ (1 << edgeIndex);
         pathElement->AsPath()->SetEdgesAndCorners(newEdges);
+        gFootpathNetworkVersion++;
 
         map_invalidate_tile_full(loc.x, loc.y);
 
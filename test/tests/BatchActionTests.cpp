@@ -0,0 +1,92 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/Game.h>
+#include <openrct2/actions/BatchAction.hpp>
+#include <openrct2/actions/FootpathSceneryPlaceAction.hpp>
+#include <openrct2/actions/SmallSceneryPlaceAction.hpp>
+#include <openrct2/core/DataSerialiser.h>
+#include <vector>
+
+static std::vector<uint8_t> SerialiseAction(const GameAction& action)
+{
+    DataSerialiser stream(true);
+    action.Serialise(stream);
+    const auto& data = stream.GetStream();
+    const auto* bytes = static_cast<const uint8_t*>(data.GetData());
+    return std::vector<uint8_t>(bytes, bytes + data.GetLength());
+}
+
+// Reads an action back the way the server does when it receives one
+static GameAction::Ptr DeserialiseAction(uint32_t type, const std::vector<uint8_t>& data)
+{
+    auto action = GameActions::Create(type);
+    DataSerialiser stream(false);
+    stream.GetStream().WriteArray(data.data(), data.size());
+    stream.GetStream().SetPosition(0);
+    action->Serialise(stream);
+    return action;
+}
+
+TEST(BatchAction, SerialiseRoundTrip)
+{
+    BatchAction batch;
+    batch.SetFlags(GAME_COMMAND_FLAG_ALLOW_DURING_PAUSED);
+    batch.AddAction(std::make_unique<SmallSceneryPlaceAction>(CoordsXYZD{ 64, 96, 48, 2 }, 1, 12, 3, 4));
+    batch.AddAction(std::make_unique<FootpathSceneryPlaceAction>(CoordsXYZ{ 320, 128, 80 }, 5));
+    batch.AddAction(std::make_unique<SmallSceneryPlaceAction>(CoordsXYZD{ 0, 32, 0, 0 }, 3, 200, 9, 10));
+    auto data = SerialiseAction(batch);
+
+    auto loaded = DeserialiseAction(GAME_COMMAND_BATCH, data);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->GetFlags(), (uint32_t)GAME_COMMAND_FLAG_ALLOW_DURING_PAUSED);
+
+    const auto& actions = static_cast<const BatchAction&>(*loaded).GetActions();
+    ASSERT_EQ(actions.size(), 3u);
+    EXPECT_EQ(actions[0]->GetType(), (uint32_t)GAME_COMMAND_PLACE_SCENERY);
+    EXPECT_EQ(actions[1]->GetType(), (uint32_t)GAME_COMMAND_PLACE_FOOTPATH_SCENERY);
+    EXPECT_EQ(actions[2]->GetType(), (uint32_t)GAME_COMMAND_PLACE_SCENERY);
+
+    // Everything that was read is written out again unchanged
+    EXPECT_EQ(SerialiseAction(*loaded), data);
+}
+
+TEST(BatchAction, RejectsNestedBatch)
+{
+    BatchAction batch;
+    batch.AddAction(std::make_unique<SmallSceneryPlaceAction>(CoordsXYZD{ 64, 96, 48, 2 }, 1, 12, 3, 4));
+    batch.AddAction(std::make_unique<BatchAction>());
+
+    auto loaded = DeserialiseAction(GAME_COMMAND_BATCH, SerialiseAction(batch));
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->Query()->Error, GA_ERROR::INVALID_PARAMETERS);
+}
+
+TEST(BatchAction, RejectsTooManyActions)
+{
+    BatchAction batch;
+    for (size_t i = 0; i <= BatchAction::MaxActions; i++)
+    {
+        batch.AddAction(std::make_unique<SmallSceneryPlaceAction>(CoordsXYZD{ 64, 96, 48, 2 }, 1, 12, 3, 4));
+    }
+
+    auto loaded = DeserialiseAction(GAME_COMMAND_BATCH, SerialiseAction(batch));
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_TRUE(static_cast<const BatchAction&>(*loaded).GetActions().empty());
+    EXPECT_EQ(loaded->Query()->Error, GA_ERROR::INVALID_PARAMETERS);
+}
+
+TEST(BatchAction, RejectsEmptyBatch)
+{
+    BatchAction batch;
+    auto loaded = DeserialiseAction(GAME_COMMAND_BATCH, SerialiseAction(batch));
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->Query()->Error, GA_ERROR::INVALID_PARAMETERS);
+}
@@ -0,0 +1,172 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/localisation/Currency.h>
+#include <openrct2/localisation/Localisation.h>
+#include <openrct2/localisation/StringIds.h>
+
+using namespace OpenRCT2;
+
+// The expected strings are the output of the formatting code from before language strings were compiled into templates
+class FormatString : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+    }
+
+    static void TearDownTestCase()
+    {
+        if (_context)
+            _context.reset();
+    }
+
+    void SetUp() override
+    {
+        _currencyFormat = gConfigGeneral.currency_format;
+    }
+
+    void TearDown() override
+    {
+        gConfigGeneral.currency_format = _currencyFormat;
+    }
+
+    // Formats the language string both from its compiled template and by walking the raw string
+    static std::string FormatArgs(rct_string_id format, const void* args)
+    {
+        char compiled[256];
+        format_string(compiled, sizeof(compiled), format, args);
+        char raw[256];
+        format_string_raw(raw, sizeof(raw), language_get_string(format), args);
+        EXPECT_STREQ(raw, compiled);
+        return compiled;
+    }
+
+    template<typename T> static std::string Format(rct_string_id format, T value)
+    {
+        uint8_t args[sizeof(T)];
+        set_format_arg_on(args, 0, T, value);
+        return FormatArgs(format, args);
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+    int32_t _currencyFormat{};
+};
+
+std::shared_ptr<IContext> FormatString::_context;
+
+TEST_F(FormatString, Integer)
+{
+    ASSERT_EQ("0", Format<int32_t>(STR_FORMAT_INTEGER, 0));
+    ASSERT_EQ("1234567", Format<int32_t>(STR_FORMAT_INTEGER, 1234567));
+    ASSERT_EQ("-1234567", Format<int32_t>(STR_FORMAT_INTEGER, -1234567));
+    ASSERT_EQ("2147483647", Format<int32_t>(STR_FORMAT_INTEGER, INT32_MAX));
+    ASSERT_EQ("-2147483648", Format<int32_t>(STR_FORMAT_INTEGER, INT32_MIN));
+}
+
+TEST_F(FormatString, GroupingSeparators)
+{
+    ASSERT_EQ("0", Format<int16_t>(STR_COMMA16, 0));
+    ASSERT_EQ("999", Format<int16_t>(STR_COMMA16, 999));
+    ASSERT_EQ("1,000", Format<int16_t>(STR_COMMA16, 1000));
+    ASSERT_EQ("12,345", Format<int16_t>(STR_COMMA16, 12345));
+    ASSERT_EQ("32,767", Format<int16_t>(STR_COMMA16, 32767));
+    ASSERT_EQ("1,000 players online", Format<int32_t>(STR_X_PLAYERS_ONLINE, 1000));
+    ASSERT_EQ("1,234,567 players online", Format<int32_t>(STR_X_PLAYERS_ONLINE, 1234567));
+}
+
+TEST_F(FormatString, NegativeNumbers)
+{
+    ASSERT_EQ("-1", Format<int16_t>(STR_COMMA16, -1));
+    ASSERT_EQ("-999", Format<int16_t>(STR_COMMA16, -999));
+    ASSERT_EQ("-1,000", Format<int16_t>(STR_COMMA16, -1000));
+    ASSERT_EQ("-32,768", Format<int16_t>(STR_COMMA16, -32768));
+    ASSERT_EQ("-1,234,567 players online", Format<int32_t>(STR_X_PLAYERS_ONLINE, -1234567));
+    ASSERT_EQ("-2,147,483,648 players online", Format<int32_t>(STR_X_PLAYERS_ONLINE, INT32_MIN));
+}
+
+TEST_F(FormatString, Decimals)
+{
+    ASSERT_EQ("0.00m", Format<int32_t>(STR_UNIT2DP_SUFFIX_METRES, 0));
+    ASSERT_EQ("0.05m", Format<int32_t>(STR_UNIT2DP_SUFFIX_METRES, 5));
+    ASSERT_EQ("1.00m", Format<int32_t>(STR_UNIT2DP_SUFFIX_METRES, 100));
+    ASSERT_EQ("1,234.56m", Format<int32_t>(STR_UNIT2DP_SUFFIX_METRES, 123456));
+    ASSERT_EQ("-0.05m", Format<int32_t>(STR_UNIT2DP_SUFFIX_METRES, -5));
+    ASSERT_EQ("-1,234.56m", Format<int32_t>(STR_UNIT2DP_SUFFIX_METRES, -123456));
+    ASSERT_EQ("-21,474,836.48m", Format<int32_t>(STR_UNIT2DP_SUFFIX_METRES, INT32_MIN));
+    ASSERT_EQ("0.0ft", Format<int16_t>(STR_UNIT1DP_SUFFIX_FEET, 0));
+    ASSERT_EQ("0.7ft", Format<int16_t>(STR_UNIT1DP_SUFFIX_FEET, 7));
+    ASSERT_EQ("1,234.5ft", Format<int16_t>(STR_UNIT1DP_SUFFIX_FEET, 12345));
+    ASSERT_EQ("-0.5ft", Format<int16_t>(STR_UNIT1DP_SUFFIX_FEET, -5));
+    ASSERT_EQ("-3,276.8ft", Format<int16_t>(STR_UNIT1DP_SUFFIX_FEET, -32768));
+}
+
+TEST_F(FormatString, Currency)
+{
+    gConfigGeneral.currency_format = CURRENCY_DOLLARS;
+    ASSERT_EQ("$0", Format<int32_t>(STR_CHEAT_CURRENCY_FORMAT, 0));
+    ASSERT_EQ("$1,235", Format<int32_t>(STR_CHEAT_CURRENCY_FORMAT, 12345));
+    ASSERT_EQ("-$1,235", Format<int32_t>(STR_CHEAT_CURRENCY_FORMAT, -12345));
+
+    gConfigGeneral.currency_format = CURRENCY_KRONA;
+    ASSERT_EQ("1 kr", Format<int32_t>(STR_CHEAT_CURRENCY_FORMAT, 1));
+    ASSERT_EQ("-1,235 kr", Format<int32_t>(STR_CHEAT_CURRENCY_FORMAT, -12345));
+
+    gConfigGeneral.currency_format = CURRENCY_LIRA;
+    ASSERT_EQ("L123,450", Format<int32_t>(STR_CHEAT_CURRENCY_FORMAT, 12345));
+}
+
+TEST_F(FormatString, CurrencyDecimals)
+{
+    gConfigGeneral.currency_format = CURRENCY_DOLLARS;
+    ASSERT_EQ("Profit: $0.00 per hour", Format<int32_t>(STR_PROFIT_LABEL, 0));
+    ASSERT_EQ("Profit: $0.50 per hour", Format<int32_t>(STR_PROFIT_LABEL, 5));
+    ASSERT_EQ("Profit: $1,234.50 per hour", Format<int32_t>(STR_PROFIT_LABEL, 12345));
+    ASSERT_EQ("Profit: -$1,234.50 per hour", Format<int32_t>(STR_PROFIT_LABEL, -12345));
+
+    gConfigGeneral.currency_format = CURRENCY_KRONA;
+    ASSERT_EQ("Profit: 123,456.70 kr per hour", Format<int32_t>(STR_PROFIT_LABEL, 1234567));
+    ASSERT_EQ("Profit: -0.50 kr per hour", Format<int32_t>(STR_PROFIT_LABEL, -5));
+
+    // The pennies are dropped for currencies with a high rate
+    gConfigGeneral.currency_format = CURRENCY_LIRA;
+    ASSERT_EQ("Profit: L12,345,670 per hour", Format<int32_t>(STR_PROFIT_LABEL, 1234567));
+    ASSERT_EQ("Profit: -L50 per hour", Format<int32_t>(STR_PROFIT_LABEL, -5));
+}
+
+TEST_F(FormatString, NestedStrings)
+{
+    uint8_t args[12];
+    set_format_arg_on(args, 0, rct_string_id, STR_COMMA16);
+    set_format_arg_on(args, 2, int16_t, 1234);
+    set_format_arg_on(args, 4, rct_string_id, STR_UNIT2DP_SUFFIX_METRES);
+    set_format_arg_on(args, 6, int32_t, -123456);
+    set_format_arg_on(args, 10, int16_t, 5000);
+    ASSERT_EQ("1,234 - -1,234.56m 5,000", FormatArgs(STR_MAP_TOOLTIP_STRINGID_STRINGID, args));
+}
+
+TEST_F(FormatString, NestedStringsAfterPoppedArguments)
+{
+    // The first five arguments are skipped
+    uint8_t args[18] = {};
+    set_format_arg_on(args, 10, rct_string_id, STR_X_PLAYERS_ONLINE);
+    set_format_arg_on(args, 12, int32_t, 1234567);
+    set_format_arg_on(args, 16, int16_t, -4321);
+    ASSERT_EQ("1,234,567 players online -4,321", FormatArgs(STR_RIDE_COLOUR_TRAIN_VALUE, args));
+}
@@ -0,0 +1,99 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/Imaging.h>
+#include <openrct2/drawing/Drawing.h>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+class ImagingTests : public testing::Test
+{
+protected:
+    static constexpr const char* Path = "test_imaging_stream.png";
+    static constexpr uint32_t Width = 13;
+    static constexpr uint32_t Height = 10;
+
+    Image _image;
+    std::vector<uint8_t> _pixels;
+
+    void SetUp() override
+    {
+        _image.Width = Width;
+        _image.Height = Height;
+        _image.Depth = 8;
+        _image.Palette = std::make_unique<rct_palette>();
+        for (size_t i = 0; i < std::size(_image.Palette->entries); i++)
+        {
+            _image.Palette->entries[i] = { (uint8_t)i, (uint8_t)(255 - i), (uint8_t)(i * 7), 0 };
+        }
+
+        _pixels.resize(Width * Height);
+        for (size_t i = 0; i < _pixels.size(); i++)
+        {
+            _pixels[i] = (uint8_t)(i * 31);
+        }
+    }
+
+    void TearDown() override
+    {
+        File::Delete(Path);
+    }
+};
+
+TEST_F(ImagingTests, StreamWriterWritesRowsInStrips)
+{
+    {
+        auto writer = Imaging::CreateStreamWriter(Path, _image, IMAGE_FORMAT::PNG);
+        for (uint32_t y = 0; y < Height; y += 3)
+        {
+            const uint32_t numRows = std::min<uint32_t>(3, Height - y);
+            writer->WriteRows(_pixels.data() + y * Width, numRows, Width);
+        }
+        writer->Finish();
+    }
+
+    auto image = Imaging::ReadFromFile(Path, IMAGE_FORMAT::PNG);
+    ASSERT_EQ(image.Width, Width);
+    ASSERT_EQ(image.Height, Height);
+    ASSERT_EQ(image.Depth, 8u);
+    for (uint32_t y = 0; y < Height; y++)
+    {
+        for (uint32_t x = 0; x < Width; x++)
+        {
+            ASSERT_EQ(image.Pixels[y * image.Stride + x], _pixels[y * Width + x]) << "at " << x << ", " << y;
+        }
+    }
+}
+
+TEST_F(ImagingTests, StreamWriterRejectsTooManyRows)
+{
+    auto writer = Imaging::CreateStreamWriter(Path, _image, IMAGE_FORMAT::PNG);
+    writer->WriteRows(_pixels.data(), Height - 1, Width);
+    EXPECT_THROW(writer->WriteRows(_pixels.data(), 2, Width), std::runtime_error);
+}
+
+TEST_F(ImagingTests, StreamWriterRejectsShortStride)
+{
+    auto writer = Imaging::CreateStreamWriter(Path, _image, IMAGE_FORMAT::PNG);
+    EXPECT_THROW(writer->WriteRows(_pixels.data(), 1, Width - 1), std::invalid_argument);
+}
+
+TEST_F(ImagingTests, StreamWriterFinishRequiresAllRows)
+{
+    auto writer = Imaging::CreateStreamWriter(Path, _image, IMAGE_FORMAT::PNG);
+    EXPECT_THROW(writer->Finish(), std::runtime_error);
+    writer->WriteRows(_pixels.data(), Height - 1, Width);
+    EXPECT_THROW(writer->Finish(), std::runtime_error);
+    writer->WriteRows(_pixels.data() + (Height - 1) * Width, 1, Width);
+    EXPECT_NO_THROW(writer->Finish());
+}
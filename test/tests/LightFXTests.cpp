@@ -0,0 +1,171 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifdef __ENABLE_LIGHTFX__
+
+#    include "SimdHelpers.hpp"
+
+#    include <gtest/gtest.h>
+#    include <openrct2/drawing/LightFX.h>
+#    include <openrct2/interface/Viewport.h>
+#    include <openrct2/util/Util.h>
+#    include <openrct2/world/Map.h>
+#    include <random>
+#    include <vector>
+
+using AddLightFunc = void (*)(int32_t, int32_t, const uint8_t*, uint8_t*, int32_t, int32_t, uint8_t);
+using MixLineFunc = void (*)(int32_t, const uint8_t*, const uint8_t*, uint32_t*, const uint32_t*, const uint32_t*);
+
+static std::vector<uint8_t> RandomBytes(std::mt19937& random, size_t count)
+{
+    std::uniform_int_distribution<int32_t> distribution(0, 255);
+    std::vector<uint8_t> bytes(count);
+    for (auto& byte : bytes)
+    {
+        byte = (uint8_t)distribution(random);
+    }
+    return bytes;
+}
+
+static void TestAddLight(AddLightFunc addLight)
+{
+    std::mt19937 random(1234);
+    for (int32_t width : SimdTestCounts)
+    {
+        for (uint8_t intensity : { 0, 1, 127, 200, 254, 255 })
+        {
+            const int32_t height = 5;
+            const int32_t srcStride = width + 3;
+            const int32_t dstStride = width + 11;
+            auto src = RandomBytes(random, (size_t)srcStride * height);
+            ASSERT_TRUE(SimdMatchesScalar(
+                RandomBytes(random, (size_t)dstStride * height), (uint8_t)0x5A,
+                [&](uint8_t* dst) {
+                    lightfx_add_light_scalar(width, height, src.data(), dst, srcStride, dstStride, intensity);
+                },
+                [&](uint8_t* dst) { addLight(width, height, src.data(), dst, srcStride, dstStride, intensity); }))
+                << "width " << width << ", intensity " << (int32_t)intensity;
+        }
+    }
+}
+
+static void TestMixLine(MixLineFunc mixLine)
+{
+    std::mt19937 random(5678);
+    std::vector<uint32_t> palette(256);
+    std::vector<uint32_t> lightPalette(256);
+    for (size_t i = 0; i < 256; i++)
+    {
+        palette[i] = random();
+        lightPalette[i] = random();
+    }
+
+    for (int32_t width : SimdTestCounts)
+    {
+        auto bits = RandomBytes(random, width);
+        auto lightBits = RandomBytes(random, width);
+        ASSERT_TRUE(SimdMatchesScalar(
+            std::vector<uint32_t>(width, 0), 0x12345678u,
+            [&](uint32_t* dst) {
+                lightfx_mix_line_scalar(width, bits.data(), lightBits.data(), dst, palette.data(), lightPalette.data());
+            },
+            [&](uint32_t* dst) { mixLine(width, bits.data(), lightBits.data(), dst, palette.data(), lightPalette.data()); }))
+            << "width " << width;
+    }
+}
+
+TEST(LightFX, AddLightSSE41MatchesScalar)
+{
+    SIMD_TEST_REQUIRE(sse41_available(), "SSE4.1");
+    TestAddLight(lightfx_add_light_sse4_1);
+}
+
+TEST(LightFX, AddLightAVX2MatchesScalar)
+{
+    SIMD_TEST_REQUIRE(avx2_available(), "AVX2");
+    TestAddLight(lightfx_add_light_avx2);
+}
+
+TEST(LightFX, MixLineSSE41MatchesScalar)
+{
+    SIMD_TEST_REQUIRE(sse41_available(), "SSE4.1");
+    TestMixLine(lightfx_mix_line_sse4_1);
+}
+
+TEST(LightFX, MixLineAVX2MatchesScalar)
+{
+    SIMD_TEST_REQUIRE(avx2_available(), "AVX2");
+    TestMixLine(lightfx_mix_line_avx2);
+}
+
+static bool IsOcclusionCached(LightOcclusionCache& cache, uint32_t lightID, const ScreenCoordsXY& viewCoords)
+{
+    uint32_t occluded;
+    int32_t samplePoints;
+    return cache.TryGet(lightID, LIGHTFX_LIGHT_QUALIFIER_MAP, viewCoords, &occluded, &samplePoints);
+}
+
+TEST(LightFX, OcclusionCacheInvalidatesArea)
+{
+    LightOcclusionCache cache;
+    cache.Set(1, LIGHTFX_LIGHT_QUALIFIER_MAP, { 100, 100 }, 300, 5);
+    cache.Set(2, LIGHTFX_LIGHT_QUALIFIER_MAP, { 500, 100 }, 200, 5);
+
+    uint32_t occluded;
+    int32_t samplePoints;
+    ASSERT_TRUE(cache.TryGet(1, LIGHTFX_LIGHT_QUALIFIER_MAP, { 100, 100 }, &occluded, &samplePoints));
+    EXPECT_EQ(occluded, 300u);
+    EXPECT_EQ(samplePoints, 5);
+
+    // A light that moved on the screen is sampled again
+    EXPECT_FALSE(IsOcclusionCached(cache, 1, { 101, 100 }));
+
+    // The sample points around a light just outside the area are changed as well
+    cache.Invalidate(0, 0, 98, 200);
+    EXPECT_FALSE(IsOcclusionCached(cache, 1, { 100, 100 }));
+    EXPECT_TRUE(IsOcclusionCached(cache, 2, { 500, 100 }));
+}
+
+TEST(LightFX, OcclusionCacheForgetsUnusedLights)
+{
+    LightOcclusionCache cache;
+    cache.BeginFrame();
+    cache.Set(1, LIGHTFX_LIGHT_QUALIFIER_MAP, { 0, 0 }, 100, 1);
+    cache.Set(2, LIGHTFX_LIGHT_QUALIFIER_MAP, { 64, 0 }, 100, 1);
+
+    cache.BeginFrame();
+    EXPECT_TRUE(IsOcclusionCached(cache, 1, { 0, 0 }));
+    cache.ForgetUnused();
+    EXPECT_EQ(cache.GetCount(), 1u);
+    EXPECT_TRUE(IsOcclusionCached(cache, 1, { 0, 0 }));
+}
+
+TEST(LightFX, OcclusionInvalidatedByMapChange)
+{
+    // The tile at 320, 320 is drawn around x = 0 and y = 336 of the view in the default rotation
+    gCurrentRotation = 0;
+    auto& cache = lightfx_get_occlusion_cache();
+    const ScreenCoordsXY onTile = { 0, 300 };
+    const ScreenCoordsXY offTile = { 200, 300 };
+
+    cache.Clear();
+    cache.Set(1, LIGHTFX_LIGHT_QUALIFIER_MAP, onTile, 100, 1);
+    cache.Set(2, LIGHTFX_LIGHT_QUALIFIER_MAP, offTile, 100, 1);
+    map_invalidate_tile_full(320, 320);
+    EXPECT_FALSE(IsOcclusionCached(cache, 1, onTile));
+    EXPECT_TRUE(IsOcclusionCached(cache, 2, offTile));
+
+    cache.Set(1, LIGHTFX_LIGHT_QUALIFIER_MAP, onTile, 100, 1);
+    map_invalidate_region({ 320, 320 }, { 320, 320 });
+    EXPECT_FALSE(IsOcclusionCached(cache, 1, onTile));
+    EXPECT_TRUE(IsOcclusionCached(cache, 2, offTile));
+    cache.Clear();
+}
+
+#endif // __ENABLE_LIGHTFX__
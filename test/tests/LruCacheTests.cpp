@@ -0,0 +1,83 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/core/LruCache.hpp>
+#include <string>
+
+TEST(LruCache, DropsLeastRecentlyUsed)
+{
+    LruCache<int32_t, std::string> cache(3);
+    cache.Set(1, "one");
+    cache.Set(2, "two");
+    cache.Set(3, "three");
+
+    // Using 1 makes 2 the least recently used
+    ASSERT_NE(cache.Find(1), nullptr);
+    cache.Set(4, "four");
+
+    EXPECT_EQ(cache.GetCount(), 3u);
+    EXPECT_EQ(cache.Find(2), nullptr);
+    ASSERT_NE(cache.Find(1), nullptr);
+    EXPECT_EQ(*cache.Find(1), "one");
+    ASSERT_NE(cache.Find(3), nullptr);
+    ASSERT_NE(cache.Find(4), nullptr);
+}
+
+TEST(LruCache, ReplacesValue)
+{
+    LruCache<int32_t, std::string> cache(2);
+    cache.Set(1, "one");
+    cache.Set(2, "two");
+    cache.Set(1, "uno");
+    cache.Set(3, "three");
+
+    EXPECT_EQ(cache.GetCount(), 2u);
+    EXPECT_EQ(cache.Find(2), nullptr);
+    ASSERT_NE(cache.Find(1), nullptr);
+    EXPECT_EQ(*cache.Find(1), "uno");
+}
+
+TEST(LruCache, AccountsCost)
+{
+    LruCache<int32_t, int32_t> cache(100);
+    cache.Set(1, 1, 40);
+    cache.Set(2, 2, 40);
+    EXPECT_EQ(cache.GetCost(), 80u);
+
+    cache.Set(3, 3, 30);
+    EXPECT_EQ(cache.GetCost(), 70u);
+    EXPECT_EQ(cache.Find(1), nullptr);
+
+    EXPECT_TRUE(cache.Remove(2));
+    EXPECT_FALSE(cache.Remove(2));
+    EXPECT_EQ(cache.GetCost(), 30u);
+
+    // A value over the capacity on its own is still kept
+    cache.Set(4, 4, 500);
+    EXPECT_EQ(cache.GetCount(), 1u);
+    EXPECT_EQ(cache.GetCost(), 500u);
+    ASSERT_NE(cache.Find(4), nullptr);
+
+    cache.Clear();
+    EXPECT_EQ(cache.GetCount(), 0u);
+    EXPECT_EQ(cache.GetCost(), 0u);
+}
+
+TEST(LruCache, DestroysDroppedValues)
+{
+    auto value = std::make_shared<int32_t>(5);
+    LruCache<int32_t, std::shared_ptr<int32_t>> cache(1);
+    cache.Set(1, value);
+    EXPECT_EQ(value.use_count(), 2);
+
+    cache.Set(2, std::make_shared<int32_t>(6));
+    EXPECT_EQ(value.use_count(), 1);
+}
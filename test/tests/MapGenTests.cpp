@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "SimdHelpers.hpp"
+
+#include <gtest/gtest.h>
+#include <openrct2/util/Util.h>
+#include <openrct2/world/MapGen.h>
+#include <random>
+#include <vector>
+
+using FractalNoiseFunc = void (*)(const uint8_t*, int32_t, int32_t, int32_t, float, int32_t, float, float, float*);
+
+static void TestFractalNoise(FractalNoiseFunc fractalNoise)
+{
+    std::mt19937 random(4321);
+    std::uniform_int_distribution<int32_t> byteDistribution(0, 255);
+    std::uniform_int_distribution<int32_t> coordDistribution(-512, 512);
+    std::uniform_int_distribution<int32_t> octaveDistribution(1, 8);
+    std::uniform_real_distribution<float> frequencyDistribution(0.001f, 0.5f);
+    for (int32_t table = 0; table < 16; table++)
+    {
+        // Same layout as the map generator's table, every entry random
+        std::vector<uint8_t> perm(512);
+        for (auto& entry : perm)
+        {
+            entry = (uint8_t)byteDistribution(random);
+        }
+
+        for (int32_t count : SimdTestCounts)
+        {
+            const int32_t x = coordDistribution(random);
+            const int32_t y = coordDistribution(random);
+            const float frequency = frequencyDistribution(random);
+            const int32_t octaves = octaveDistribution(random);
+            ASSERT_TRUE(SimdMatchesScalar(
+                std::vector<float>(count, 0.0f), 123.0f,
+                [&](float* dst) {
+                    mapgen_fractal_noise_scalar(perm.data(), x, y, count, frequency, octaves, 2.0f, 0.65f, dst);
+                },
+                [&](float* dst) { fractalNoise(perm.data(), x, y, count, frequency, octaves, 2.0f, 0.65f, dst); }))
+                << "table " << table << ", x " << x << ", y " << y << ", frequency " << frequency << ", octaves "
+                << octaves;
+        }
+    }
+}
+
+TEST(MapGen, FractalNoiseSSE41MatchesScalar)
+{
+    SIMD_TEST_REQUIRE(sse41_available(), "SSE4.1");
+    TestFractalNoise(mapgen_fractal_noise_sse4_1);
+}
+
+TEST(MapGen, FractalNoiseAVX2MatchesScalar)
+{
+    SIMD_TEST_REQUIRE(avx2_available(), "AVX2");
+    TestFractalNoise(mapgen_fractal_noise_avx2);
+}
@@ -0,0 +1,240 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/peep/Peep.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/scenario/Scenario.h>
+#include <openrct2/world/Sprite.h>
+#include <utility>
+#include <vector>
+
+using namespace OpenRCT2;
+
+// A peep identified by its sprite index and id, so a reused sprite is not mistaken for the same peep
+using PeepKey = std::pair<uint16_t, uint32_t>;
+
+class PeepTickScheduler : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        core_init();
+
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        const bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        std::string parkPath = TestData::GetParkPath("bpb.sv6");
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+    }
+
+    static void TearDownTestCase()
+    {
+        _context = nullptr;
+    }
+
+    void SetUp() override
+    {
+        _slotScheduler = gConfigGeneral.peep_slot_scheduler;
+        _tickBudget = gConfigGeneral.peep_tick_budget;
+        gConfigGeneral.peep_slot_scheduler = true;
+        gConfigGeneral.peep_tick_budget = 0;
+        peep_tick_scheduler_reset();
+        scenario_rand_seed(0x12345678, 0x87654321);
+    }
+
+    void TearDown() override
+    {
+        gConfigGeneral.peep_slot_scheduler = _slotScheduler;
+        gConfigGeneral.peep_tick_budget = _tickBudget;
+        peep_tick_scheduler_reset();
+    }
+
+    // The peeps whose 128 tick update falls on the given tick
+    static std::vector<PeepKey> GetPeepsDueOn(uint32_t tick)
+    {
+        std::vector<PeepKey> peeps;
+        uint16_t spriteIndex;
+        Peep* peep;
+        FOR_ALL_PEEPS (spriteIndex, peep)
+        {
+            if ((peep->sprite_index & 0x7F) == (tick & 0x7F))
+            {
+                peeps.emplace_back(peep->sprite_index, peep->id);
+            }
+        }
+        return peeps;
+    }
+
+    static size_t CountRemaining(const std::vector<PeepKey>& peeps)
+    {
+        size_t count = 0;
+        for (const auto& key : peeps)
+        {
+            auto sprite = get_sprite(key.first);
+            if (sprite->generic.sprite_identifier == SPRITE_IDENTIFIER_PEEP && sprite->peep.id == key.second)
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // The tick with the most peeps due out of the next 128
+    static uint32_t FindBusiestTick()
+    {
+        uint32_t busiestTick = gCurrentTicks + 1;
+        size_t busiestCount = 0;
+        for (uint32_t tick = gCurrentTicks + 1; tick <= gCurrentTicks + 128; tick++)
+        {
+            const size_t count = GetPeepsDueOn(tick).size();
+            if (count > busiestCount)
+            {
+                busiestTick = tick;
+                busiestCount = count;
+            }
+        }
+        return busiestTick;
+    }
+
+    // Runs the peep updates of the given tick and returns the number of 128 tick updates
+    static uint32_t UpdatePeeps(uint32_t tick)
+    {
+        gCurrentTicks = tick;
+        peep_update_all();
+        return gPeepTickStats.Tick128Updates;
+    }
+
+    // Peeps that update after a peep leaving the park still do their 128 tick update, unless they left too
+    static void ExpectUpdatesOfDuePeeps(uint32_t updates, const std::vector<PeepKey>& due)
+    {
+        EXPECT_LE(updates, due.size());
+        EXPECT_GE(updates, CountRemaining(due));
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+    bool _slotScheduler{};
+    int32_t _tickBudget{};
+};
+
+std::shared_ptr<IContext> PeepTickScheduler::_context;
+
+TEST_F(PeepTickScheduler, SlotsStayStableWhenPeepsAreAddedAndRemoved)
+{
+    ASSERT_NE(gSpriteListHead[SPRITE_LIST_PEEP], SPRITE_INDEX_NULL);
+
+    // The original schedule gives every following peep a different tick when the first peep in the list is removed
+    Peep* first = GET_PEEP(gSpriteListHead[SPRITE_LIST_PEEP]);
+    const CoordsXYZ spawn = { first->x, first->y, first->z };
+    first->Remove();
+    for (int32_t i = 0; i < 5; i++)
+    {
+        ASSERT_NE(Peep::Generate(spawn), nullptr);
+    }
+
+    const uint32_t startTick = gCurrentTicks + 1;
+    for (uint32_t tick = startTick; tick < startTick + 128; tick++)
+    {
+        const auto due = GetPeepsDueOn(tick);
+        const uint32_t updates = UpdatePeeps(tick);
+        ExpectUpdatesOfDuePeeps(updates, due);
+        EXPECT_EQ(gPeepTickStats.Deferred, 0u);
+    }
+}
+
+TEST_F(PeepTickScheduler, BudgetCarriesUpdatesOverToFollowingTicks)
+{
+    // One less than the busiest tick needs, so the quieter ticks after it have room for what is carried over
+    const uint32_t busiestTick = FindBusiestTick();
+    const size_t numDue = GetPeepsDueOn(busiestTick).size();
+    ASSERT_GT(numDue, 1u);
+    const uint32_t budget = (uint32_t)numDue - 1;
+    gConfigGeneral.peep_tick_budget = budget;
+
+    EXPECT_EQ(UpdatePeeps(busiestTick), budget);
+    EXPECT_EQ(gPeepTickStats.Deferred, numDue - budget);
+
+    // The backlog is run before the peeps due on each tick, and never more than the budget allows
+    uint32_t tick = busiestTick + 1;
+    for (; gPeepTickStats.Deferred != 0 && tick < busiestTick + 128; tick++)
+    {
+        EXPECT_LE(UpdatePeeps(tick), budget);
+    }
+    EXPECT_EQ(gPeepTickStats.Deferred, 0u);
+
+    // Without a budget, everything carried over is run on the next tick
+    gConfigGeneral.peep_tick_budget = 1;
+    UpdatePeeps(FindBusiestTick());
+    EXPECT_GT(gPeepTickStats.Deferred, 0u);
+    const uint32_t deferred = gPeepTickStats.Deferred;
+    gConfigGeneral.peep_tick_budget = 0;
+    tick = gCurrentTicks + 1;
+    const auto due = GetPeepsDueOn(tick);
+    const uint32_t updates = UpdatePeeps(tick);
+    EXPECT_EQ(gPeepTickStats.Deferred, 0u);
+    EXPECT_GE(updates, deferred);
+    EXPECT_LE(updates, deferred + due.size());
+}
+
+TEST_F(PeepTickScheduler, DeferredUpdateOfRemovedPeepIsDropped)
+{
+    gConfigGeneral.peep_tick_budget = 1;
+
+    const uint32_t busiestTick = FindBusiestTick();
+    const auto due = GetPeepsDueOn(busiestTick);
+    ASSERT_GT(due.size(), 1u);
+    EXPECT_EQ(UpdatePeeps(busiestTick), 1u);
+    EXPECT_GT(gPeepTickStats.Deferred, 0u);
+
+    // New peeps may be given the freed sprites, they must not take over the deferred updates
+    CoordsXYZ spawn{};
+    for (const auto& key : due)
+    {
+        Peep* peep = GET_PEEP(key.first);
+        if (peep->sprite_identifier == SPRITE_IDENTIFIER_PEEP && peep->id == key.second)
+        {
+            spawn = { peep->x, peep->y, peep->z };
+            peep->Remove();
+        }
+    }
+    for (size_t i = 0; i < due.size(); i++)
+    {
+        ASSERT_NE(Peep::Generate(spawn), nullptr);
+    }
+
+    gConfigGeneral.peep_tick_budget = 0;
+    const uint32_t tick = busiestTick + 1;
+    const auto nextDue = GetPeepsDueOn(tick);
+    ExpectUpdatesOfDuePeeps(UpdatePeeps(tick), nextDue);
+    EXPECT_EQ(gPeepTickStats.Deferred, 0u);
+}
+
+TEST_F(PeepTickScheduler, OriginalScheduleKeepsNoBacklog)
+{
+    gConfigGeneral.peep_tick_budget = 1;
+    UpdatePeeps(FindBusiestTick());
+    EXPECT_GT(gPeepTickStats.Deferred, 0u);
+
+    // Switching back to the original schedule drops anything carried over, it updates every due peep itself
+    gConfigGeneral.peep_slot_scheduler = false;
+    UpdatePeeps(gCurrentTicks + 1);
+    EXPECT_EQ(gPeepTickStats.Deferred, 0u);
+}
@@ -22,6 +22,7 @@
 #include <openrct2/core/String.hpp>
 #include <openrct2/platform/platform.h>
 #include <openrct2/ride/Ride.h>
+#include <algorithm>
 #include <string>
 
 using namespace OpenRCT2;
@@ -98,6 +99,54 @@ TEST_P(ReplayTests, RunReplay)
     }
 }
 
+TEST_P(ReplayTests, SeekToKeyframe)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto testData = GetParam();
+    auto replayFile = testData.filePath;
+
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    auto gs = context->GetGameState();
+    ASSERT_NE(gs, nullptr);
+
+    IReplayManager* replayManager = context->GetReplayManager();
+    ASSERT_NE(replayManager, nullptr);
+
+    // Normalising puts one command on each tick, so a few keyframes land on ticks with a command
+    ASSERT_TRUE(replayManager->StartPlayback(replayFile));
+    ReplayRecordInfo info;
+    ASSERT_TRUE(replayManager->GetCurrentReplayInfo(info));
+    replayManager->StopPlayback();
+    uint32_t keyframeInterval = std::max<uint32_t>(info.NumCommands / 4, 1);
+
+    std::string keyframedFile = "test-keyframes-" + testData.name;
+    ASSERT_TRUE(replayManager->NormaliseReplay(replayFile, keyframedFile, keyframeInterval));
+    while (replayManager->IsNormalising())
+    {
+        gs->UpdateLogic();
+    }
+
+    bool startedReplay = replayManager->StartPlayback(keyframedFile);
+    ASSERT_TRUE(startedReplay);
+    ASSERT_TRUE(replayManager->GetCurrentReplayInfo(info));
+    ASSERT_GT(info.NumKeyframes, 0u);
+
+    // The game state is loaded from the keyframe, the checksums from there on have to match
+    ASSERT_TRUE(replayManager->SeekPlayback(keyframeInterval));
+    ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+    while (replayManager->IsReplaying())
+    {
+        gs->UpdateLogic();
+        ASSERT_TRUE(replayManager->IsPlaybackStateMismatching() == false);
+    }
+}
+
 static void PrintTo(const ReplayTestData& testData, std::ostream* os)
 {
     *os << testData.filePath;
@@ -0,0 +1,114 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/core/File.h>
+#include <openrct2/drawing/NewDrawing.h>
+#include <openrct2/interface/Screenshot.h>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class ScreenshotBatch : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = false;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+        drawing_engine_init();
+    }
+
+    static void TearDownTestCase()
+    {
+        drawing_engine_dispose();
+        if (_context)
+            _context.reset();
+    }
+
+    void SetUp() override
+    {
+        _multithreading = gConfigGeneral.multithreading;
+    }
+
+    void TearDown() override
+    {
+        gConfigGeneral.multithreading = _multithreading;
+    }
+
+    // Renders the views with the batch command and returns the bytes of the images in the same order
+    static std::vector<std::vector<uint8_t>> RenderBatch(
+        const std::string& name, const std::vector<std::string>& views, bool multithreading, int32_t jobs)
+    {
+        auto parkPath = TestData::GetParkPath("bpb.sv6");
+        auto batchPath = "test_screenshot_batch_" + name + ".txt";
+        std::vector<std::string> imagePaths;
+        {
+            std::ofstream fs(batchPath);
+            for (size_t i = 0; i < views.size(); i++)
+            {
+                imagePaths.push_back("test_screenshot_batch_" + name + "_" + std::to_string(i) + ".png");
+                fs << '"' << parkPath << "\" \"" << imagePaths.back() << "\" " << views[i] << '\n';
+            }
+        }
+
+        gConfigGeneral.multithreading = multithreading;
+        ScreenshotOptions options;
+        EXPECT_EQ(screenshot_render_batch(batchPath.c_str(), jobs, &options), 0);
+        File::Delete(batchPath);
+
+        std::vector<std::vector<uint8_t>> images;
+        for (const auto& imagePath : imagePaths)
+        {
+            images.push_back(File::Exists(imagePath) ? File::ReadAllBytes(imagePath) : std::vector<uint8_t>());
+            File::Delete(imagePath);
+        }
+        return images;
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+    bool _multithreading{};
+};
+
+std::shared_ptr<IContext> ScreenshotBatch::_context;
+
+TEST_F(ScreenshotBatch, ConcurrentViewsMatchSequentialViews)
+{
+    // Several views of each rotation, so they are painted at the same time, with scrolling text on the ride entrances
+    const std::vector<std::string> views = {
+        "640 480",
+        "640 480 2400 2400 0 0",
+        "1024 768 1600 3000 1 0",
+        "giant 2 0",
+        "800 600 2000 2000 0 1",
+        "800 600 3000 1500 0 1",
+        "giant 3 1",
+    };
+    auto sequential = RenderBatch("sequential", views, false, 0);
+    auto concurrent = RenderBatch("concurrent", views, true, 4);
+
+    ASSERT_EQ(sequential.size(), views.size());
+    ASSERT_EQ(concurrent.size(), views.size());
+    for (size_t i = 0; i < views.size(); i++)
+    {
+        EXPECT_FALSE(sequential[i].empty()) << views[i];
+        EXPECT_EQ(sequential[i], concurrent[i]) << views[i];
+    }
+}
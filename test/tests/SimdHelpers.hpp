@@ -0,0 +1,71 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+// Counts that leave a tail for the scalar code after whole SSE or AVX vectors of any element size, or have no whole
+// vector at all
+static constexpr int32_t SimdTestCounts[] = { 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 47, 63, 64, 65, 127, 255, 256, 257 };
+
+// Values appended to the output of the tested functions, which they must not change
+static constexpr size_t SIMD_TEST_GUARD_COUNT = 4;
+
+/**
+ * Skips a test of vectorised code when the CPU running the tests does not support its instruction set. Versions of
+ * googletest without skipping print the skip and let the test pass.
+ */
+#ifdef GTEST_SKIP
+#    define SIMD_TEST_REQUIRE(available, name)                                                                             \
+        if (!(available))                                                                                                  \
+        {                                                                                                                  \
+            GTEST_SKIP() << name " is not supported by this CPU";                                                          \
+        }
+#else
+#    define SIMD_TEST_REQUIRE(available, name)                                                                             \
+        if (!(available))                                                                                                  \
+        {                                                                                                                  \
+            std::printf("[  SKIPPED ] " name " is not supported by this CPU\n");                                            \
+            return;                                                                                                        \
+        }
+#endif
+
+/**
+ * Runs a scalar function and a vectorised version of it on copies of the same output, with guard values appended, and
+ * checks they produce the same bits and neither writes past the output.
+ */
+template<typename T, typename TScalar, typename TVector>
+static ::testing::AssertionResult SimdMatchesScalar(std::vector<T> output, T guard, TScalar scalar, TVector vector)
+{
+    const size_t size = output.size();
+    output.resize(size + SIMD_TEST_GUARD_COUNT, guard);
+    std::vector<T> expected = output;
+    std::vector<T> actual = output;
+    scalar(expected.data());
+    vector(actual.data());
+
+    for (size_t i = 0; i < output.size(); i++)
+    {
+        // Bitwise equal, floating point results must not depend on the CPU either
+        if (std::memcmp(&expected[i], &actual[i], sizeof(T)) != 0)
+        {
+            return ::testing::AssertionFailure() << "differs at " << i << " of " << size << ": expected " << +expected[i]
+                                                 << ", actual " << +actual[i];
+        }
+        if (i >= size && std::memcmp(&actual[i], &guard, sizeof(T)) != 0)
+        {
+            return ::testing::AssertionFailure() << "wrote past the end at " << i << " of " << size;
+        }
+    }
+    return ::testing::AssertionSuccess();
+}
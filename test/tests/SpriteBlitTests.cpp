@@ -0,0 +1,67 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "SimdHelpers.hpp"
+
+#include <gtest/gtest.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <vector>
+
+using BitmapBlitFunc = void (*)(BitmapBlitMode, int32_t, int32_t, const uint8_t*, uint8_t*, int32_t, int32_t, const uint8_t*);
+
+// Bytes where about a third are 0, which is transparent in a sprite and in a remap palette
+static std::vector<uint8_t> RandomPixels(std::mt19937& random, size_t count)
+{
+    std::uniform_int_distribution<int32_t> distribution(-127, 255);
+    std::vector<uint8_t> pixels(count);
+    for (auto& pixel : pixels)
+    {
+        pixel = (uint8_t)std::max(0, distribution(random));
+    }
+    return pixels;
+}
+
+static void TestBitmapBlit(BitmapBlitFunc bitmapBlit)
+{
+    std::mt19937 random(8765);
+    std::uniform_int_distribution<int32_t> wrapDistribution(0, 40);
+    for (auto mode : { BitmapBlitMode::Copy, BitmapBlitMode::Remap, BitmapBlitMode::Blend })
+    {
+        for (int32_t width : SimdTestCounts)
+        {
+            const int32_t height = 4;
+            const int32_t srcWrap = wrapDistribution(random);
+            const int32_t dstWrap = wrapDistribution(random);
+            auto src = RandomPixels(random, (size_t)(width + srcWrap) * height);
+            auto palette = RandomPixels(random, 256);
+            ASSERT_TRUE(SimdMatchesScalar(
+                RandomPixels(random, (size_t)(width + dstWrap) * height), (uint8_t)0x5A,
+                [&](uint8_t* dst) {
+                    bitmap_blit_scalar(mode, width, height, src.data(), dst, srcWrap, dstWrap, palette.data());
+                },
+                [&](uint8_t* dst) { bitmapBlit(mode, width, height, src.data(), dst, srcWrap, dstWrap, palette.data()); }))
+                << "mode " << (int32_t)mode << ", width " << width << ", source wrap " << srcWrap << ", destination wrap "
+                << dstWrap;
+        }
+    }
+}
+
+TEST(SpriteBlit, SSE41MatchesScalar)
+{
+    SIMD_TEST_REQUIRE(sse41_available(), "SSE4.1");
+    TestBitmapBlit(bitmap_blit_sse4_1);
+}
+
+TEST(SpriteBlit, AVX2MatchesScalar)
+{
+    SIMD_TEST_REQUIRE(avx2_available(), "AVX2");
+    TestBitmapBlit(bitmap_blit_avx2);
+}
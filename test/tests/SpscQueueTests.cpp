@@ -0,0 +1,99 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/core/SpscQueue.hpp>
+#include <thread>
+
+TEST(SpscQueue, PopsInPushOrder)
+{
+    SpscQueue<int32_t, 4> queue;
+    int32_t value = 0;
+    EXPECT_FALSE(queue.TryPop(value));
+
+    // Wraps around the end of the ring a few times
+    for (int32_t i = 0; i < 10; i++)
+    {
+        ASSERT_TRUE(queue.TryPush(i * 2));
+        ASSERT_TRUE(queue.TryPush(i * 2 + 1));
+        ASSERT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(value, i * 2);
+        ASSERT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(value, i * 2 + 1);
+    }
+    EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST(SpscQueue, FullQueueKeepsValue)
+{
+    SpscQueue<std::unique_ptr<int32_t>, 2> queue;
+    ASSERT_TRUE(queue.TryPush(std::make_unique<int32_t>(1)));
+    ASSERT_TRUE(queue.TryPush(std::make_unique<int32_t>(2)));
+
+    auto third = std::make_unique<int32_t>(3);
+    EXPECT_FALSE(queue.TryPush(std::move(third)));
+    ASSERT_NE(third, nullptr);
+
+    std::unique_ptr<int32_t> value;
+    ASSERT_TRUE(queue.TryPop(value));
+    EXPECT_EQ(*value, 1);
+    EXPECT_TRUE(queue.TryPush(std::move(third)));
+    EXPECT_EQ(third, nullptr);
+
+    ASSERT_TRUE(queue.TryPop(value));
+    EXPECT_EQ(*value, 2);
+    ASSERT_TRUE(queue.TryPop(value));
+    EXPECT_EQ(*value, 3);
+    EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST(SpscQueue, PopReleasesValue)
+{
+    SpscQueue<std::shared_ptr<int32_t>, 2> queue;
+    auto shared = std::make_shared<int32_t>(1);
+    ASSERT_TRUE(queue.TryPush(std::shared_ptr<int32_t>(shared)));
+    EXPECT_EQ(shared.use_count(), 2);
+
+    std::shared_ptr<int32_t> value;
+    ASSERT_TRUE(queue.TryPop(value));
+    value = nullptr;
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(SpscQueue, PassesValuesBetweenThreads)
+{
+    constexpr int32_t Count = 200000;
+    SpscQueue<int32_t, 64> queue;
+    std::thread producer([&queue] {
+        for (int32_t i = 0; i < Count; i++)
+        {
+            while (!queue.TryPush(int32_t(i)))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int32_t expected = 0;
+    while (expected < Count)
+    {
+        int32_t value;
+        if (queue.TryPop(value))
+        {
+            ASSERT_EQ(value, expected);
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
@@ -0,0 +1,195 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Cheats.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/actions/FootpathPlaceAction.hpp>
+#include <openrct2/actions/FootpathRemoveAction.hpp>
+#include <openrct2/peep/Peep.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/ride/Ride.h>
+#include <openrct2/world/Footpath.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Sprite.h>
+#include <openrct2/world/Surface.h>
+#include <openrct2/world/TileInspector.h>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class StaffPathCache : public testing::Test
+{
+protected:
+    struct PathTile
+    {
+        CoordsXY Loc;
+        int32_t ElementIndex = -1;
+        TileElement* Element = nullptr;
+    };
+
+    static void SetUpTestCase()
+    {
+        core_init();
+
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        const bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+    }
+
+    static void TearDownTestCase()
+    {
+        _context = nullptr;
+    }
+
+    void SetUp() override
+    {
+        // Every test edits the map, so each starts from a freshly loaded park
+        std::string parkPath = TestData::GetParkPath("bpb.sv6");
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+        gCheatsSandboxMode = true;
+    }
+
+    void TearDown() override
+    {
+        gCheatsSandboxMode = false;
+    }
+
+    // The first flat footpath that is not a queue, which every kind of edit can be made to
+    static PathTile FindPathTile()
+    {
+        for (int32_t y = 1; y < gMapSize - 1; y++)
+        {
+            for (int32_t x = 1; x < gMapSize - 1; x++)
+            {
+                TileElement* tileElement = map_get_first_element_at(x, y);
+                for (int32_t i = 0; tileElement != nullptr; i++, tileElement++)
+                {
+                    if (tileElement->GetType() == TILE_ELEMENT_TYPE_PATH && !tileElement->AsPath()->IsQueue()
+                        && !tileElement->AsPath()->IsSloped())
+                    {
+                        return { { x * 32, y * 32 }, i, tileElement };
+                    }
+                    if (tileElement->IsLastForTile())
+                        break;
+                }
+            }
+        }
+        return {};
+    }
+
+    template<typename TEdit> static ::testing::AssertionResult ChangesNetworkVersion(TEdit edit)
+    {
+        const uint32_t version = gFootpathNetworkVersion;
+        edit();
+        if (gFootpathNetworkVersion == version)
+            return ::testing::AssertionFailure() << "gFootpathNetworkVersion is still " << version;
+        return ::testing::AssertionSuccess();
+    }
+
+    // The direction every staff member standing on a path picks towards the goal, searched from their current state
+    static std::vector<Direction> ChooseStaffDirections(const TileCoordsXYZ& goal)
+    {
+        std::vector<Direction> directions;
+        uint16_t spriteIndex;
+        Peep* peep;
+        FOR_ALL_STAFF (spriteIndex, peep)
+        {
+            const TileCoordsXYZ loc = { peep->next_x / 32, peep->next_y / 32, peep->next_z };
+            if (map_get_footpath_element(loc.x, loc.y, loc.z) == nullptr)
+                continue;
+
+            // Choosing a direction records the junction in the history, which is part of the search
+            const Peep saved = *peep;
+            gPeepPathFindGoalPosition = goal;
+            gPeepPathFindIgnoreForeignQueues = false;
+            gPeepPathFindQueueRideIndex = RIDE_ID_NULL;
+            directions.push_back(peep_pathfind_choose_direction(loc, peep));
+            *peep = saved;
+        }
+        return directions;
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> StaffPathCache::_context;
+
+TEST_F(StaffPathCache, FootpathEditsChangeNetworkVersion)
+{
+    auto path = FindPathTile();
+    ASSERT_NE(path.Element, nullptr);
+    const CoordsXY loc = path.Loc;
+    const int32_t index = path.ElementIndex;
+    const CoordsXYZ pathLoc = { loc.x, loc.y, path.Element->base_height * 8 };
+    const uint8_t pathType = path.Element->AsPath()->GetPathEntryIndex();
+
+    EXPECT_TRUE(ChangesNetworkVersion([&] { tile_inspector_path_toggle_edge(loc, index, 0, true); })) << "toggle edge";
+    EXPECT_TRUE(ChangesNetworkVersion([&] { tile_inspector_path_toggle_edge(loc, index, 0, true); })) << "toggle edge";
+    EXPECT_TRUE(ChangesNetworkVersion([&] { tile_inspector_path_set_sloped(loc, index, true, true); })) << "set sloped";
+    EXPECT_TRUE(ChangesNetworkVersion([&] { tile_inspector_path_set_sloped(loc, index, false, true); })) << "set flat";
+    EXPECT_TRUE(ChangesNetworkVersion([&] { tile_inspector_rotate_element_at(loc, index, true); })) << "rotate";
+    EXPECT_TRUE(ChangesNetworkVersion([&] { tile_inspector_any_base_height_offset(loc, index, 1, true); })) << "raise";
+    EXPECT_TRUE(ChangesNetworkVersion([&] { tile_inspector_any_base_height_offset(loc, index, -1, true); })) << "lower";
+    if (index > 0)
+    {
+        EXPECT_TRUE(ChangesNetworkVersion([&] { tile_inspector_swap_elements_at(loc, index - 1, index, true); }))
+            << "swap";
+        EXPECT_TRUE(ChangesNetworkVersion([&] { tile_inspector_swap_elements_at(loc, index - 1, index, true); }))
+            << "swap";
+    }
+
+    EXPECT_TRUE(ChangesNetworkVersion([&] {
+        auto action = FootpathRemoveAction(pathLoc);
+        EXPECT_EQ(GameActions::Execute(&action)->Error, GA_ERROR::OK);
+    })) << "remove footpath";
+    EXPECT_TRUE(ChangesNetworkVersion([&] {
+        auto action = FootpathPlaceAction(pathLoc, 0, pathType);
+        EXPECT_EQ(GameActions::Execute(&action)->Error, GA_ERROR::OK);
+    })) << "place footpath";
+
+    auto surfaceElement = map_get_surface_element_at(loc);
+    ASSERT_NE(surfaceElement, nullptr);
+    const uint8_t ownership = surfaceElement->GetOwnership();
+    EXPECT_TRUE(ChangesNetworkVersion([&] { surfaceElement->SetOwnership(OWNERSHIP_UNOWNED); })) << "sell land";
+    EXPECT_TRUE(ChangesNetworkVersion([&] { surfaceElement->SetOwnership(ownership); })) << "buy land";
+
+    EXPECT_TRUE(ChangesNetworkVersion([] { map_remove_all_rides(); })) << "remove all rides";
+}
+
+TEST_F(StaffPathCache, CachedSearchMatchesFreshSearchAfterFootpathEdit)
+{
+    // A goal on the paths of the park, which is then removed so the best route changes
+    auto path = FindPathTile();
+    ASSERT_NE(path.Element, nullptr);
+    const TileCoordsXYZ goal = { path.Loc.x / 32, path.Loc.y / 32, path.Element->base_height };
+    const CoordsXYZ pathLoc = { path.Loc.x, path.Loc.y, path.Element->base_height * 8 };
+
+    const auto before = ChooseStaffDirections(goal);
+    ASSERT_FALSE(before.empty());
+    // Taken from the cache this time
+    EXPECT_EQ(ChooseStaffDirections(goal), before);
+
+    auto action = FootpathRemoveAction(pathLoc);
+    ASSERT_EQ(GameActions::Execute(&action)->Error, GA_ERROR::OK);
+    const auto afterEdit = ChooseStaffDirections(goal);
+
+    // Searched again from scratch
+    gFootpathNetworkVersion++;
+    EXPECT_EQ(ChooseStaffDirections(goal), afterEdit);
+}
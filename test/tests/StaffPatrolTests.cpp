@@ -0,0 +1,193 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/peep/Peep.h>
+#include <openrct2/peep/Staff.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Surface.h>
+#include <random>
+
+using namespace OpenRCT2;
+
+class StaffPatrolTests : public testing::Test
+{
+protected:
+    static constexpr int32_t MapSize = 64;
+    static constexpr int32_t StaffIndex = 3;
+
+    std::unique_ptr<IContext> _context;
+    std::mt19937 _random{ 1234 };
+    Peep _staff{};
+
+    void SetUp() override
+    {
+        _context = CreateContext();
+        map_init(MapSize);
+        _staff.type = PEEP_TYPE_STAFF;
+        _staff.staff_id = StaffIndex;
+        gStaffModes[StaffIndex] = STAFF_MODE_WALK | (1 << 1);
+    }
+
+    void TearDown() override
+    {
+        std::fill_n(&gStaffPatrolAreas[StaffIndex * STAFF_PATROL_AREA_SIZE], STAFF_PATROL_AREA_SIZE, 0);
+        gStaffModes[StaffIndex] = STAFF_MODE_NONE;
+        _context = nullptr;
+    }
+
+    // Sets each patrol quad with the given chance, high chances leave whole blocks of quads for the covering checks
+    void RandomisePatrolArea(double chance)
+    {
+        std::bernoulli_distribution distribution(chance);
+        for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL * 32; y += 128)
+        {
+            for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL * 32; x += 128)
+            {
+                staff_set_patrol_area(StaffIndex, x, y, distribution(_random));
+            }
+        }
+    }
+
+    void RandomiseOwnership(double chance)
+    {
+        std::bernoulli_distribution distribution(chance);
+        for (int32_t y = 0; y < MapSize; y++)
+        {
+            for (int32_t x = 0; x < MapSize; x++)
+            {
+                auto surfaceElement = map_get_surface_element_at(CoordsXY{ x * 32, y * 32 });
+                ASSERT_NE(surfaceElement, nullptr);
+                surfaceElement->SetOwnership(distribution(_random) ? OWNERSHIP_OWNED : OWNERSHIP_UNOWNED);
+            }
+        }
+    }
+
+    // Whether the predicate holds for every tile in the range, checked one tile at a time
+    template<typename TPredicate> static bool AllTilesInRange(const MapRange& range, bool emptyResult, TPredicate predicate)
+    {
+        auto normalised = range.Normalise();
+        const int32_t left = std::max(normalised.GetLeft(), 0) >> 5;
+        const int32_t top = std::max(normalised.GetTop(), 0) >> 5;
+        const int32_t right = std::min(normalised.GetRight(), (MAXIMUM_MAP_SIZE_TECHNICAL * 32) - 1) >> 5;
+        const int32_t bottom = std::min(normalised.GetBottom(), (MAXIMUM_MAP_SIZE_TECHNICAL * 32) - 1) >> 5;
+        if (left > right || top > bottom)
+            return emptyResult;
+
+        for (int32_t y = top; y <= bottom; y++)
+        {
+            for (int32_t x = left; x <= right; x++)
+            {
+                if (!predicate(x * 32, y * 32))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    static bool IsCoveringPerTile(const MapRange& range)
+    {
+        return AllTilesInRange(range, false, [](int32_t x, int32_t y) { return staff_is_patrol_area_set(StaffIndex, x, y); });
+    }
+
+    static bool IsIntersectingPerTile(const MapRange& range)
+    {
+        return !AllTilesInRange(
+            range, true, [](int32_t x, int32_t y) { return !staff_is_patrol_area_set(StaffIndex, x, y); });
+    }
+
+    // The check staff_is_location_on_patrol_edge made before it used the covering query
+    bool IsOnPatrolEdgePerTile(int32_t x, int32_t y)
+    {
+        for (int32_t neighbourDir = 0; neighbourDir <= 7; neighbourDir++)
+        {
+            if (!staff_is_location_in_patrol(
+                    &_staff, x + CoordsDirectionDelta[neighbourDir].x, y + CoordsDirectionDelta[neighbourDir].y))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    MapRange GetRandomRange()
+    {
+        // Reaches past the edges of the technical map size as well
+        std::uniform_int_distribution<int32_t> start(-256, MAXIMUM_MAP_SIZE_TECHNICAL * 32 + 256);
+        std::uniform_int_distribution<int32_t> size(0, 640);
+        const int32_t left = start(_random);
+        const int32_t top = start(_random);
+        return { left, top, left + size(_random), top + size(_random) };
+    }
+};
+
+TEST_F(StaffPatrolTests, CoveringMatchesPerTileCheck)
+{
+    for (double chance : { 0.5, 0.9, 0.98 })
+    {
+        RandomisePatrolArea(chance);
+        for (int32_t i = 0; i < 2000; i++)
+        {
+            auto range = GetRandomRange();
+            ASSERT_EQ(staff_is_patrol_area_covering(StaffIndex, range), IsCoveringPerTile(range))
+                << range.GetLeft() << ", " << range.GetTop() << ", " << range.GetRight() << ", " << range.GetBottom();
+        }
+    }
+}
+
+TEST_F(StaffPatrolTests, IntersectingMatchesPerTileCheck)
+{
+    for (double chance : { 0.02, 0.1, 0.5 })
+    {
+        RandomisePatrolArea(chance);
+        for (int32_t i = 0; i < 2000; i++)
+        {
+            auto range = GetRandomRange();
+            // Given right to left as well, the range is normalised
+            MapRange flipped(range.GetRight(), range.GetBottom(), range.GetLeft(), range.GetTop());
+            ASSERT_EQ(staff_is_patrol_area_intersecting(StaffIndex, range), IsIntersectingPerTile(range))
+                << range.GetLeft() << ", " << range.GetTop() << ", " << range.GetRight() << ", " << range.GetBottom();
+            ASSERT_EQ(staff_is_patrol_area_intersecting(StaffIndex, flipped), IsIntersectingPerTile(range));
+        }
+    }
+}
+
+TEST_F(StaffPatrolTests, PatrolEdgeMatchesPerTileCheck)
+{
+    for (double chance : { 0.5, 0.9 })
+    {
+        RandomisePatrolArea(chance);
+        RandomiseOwnership(0.95);
+        for (bool hasPatrolArea : { true, false })
+        {
+            gStaffModes[StaffIndex] = STAFF_MODE_WALK | (hasPatrolArea ? (1 << 1) : 0);
+            for (int32_t y = 0; y < MapSize * 32; y += 32)
+            {
+                for (int32_t x = 0; x < MapSize * 32; x += 32)
+                {
+                    ASSERT_EQ(staff_is_location_on_patrol_edge(&_staff, x, y), IsOnPatrolEdgePerTile(x, y))
+                        << x / 32 << ", " << y / 32 << (hasPatrolArea ? " with" : " without") << " patrol area";
+                }
+            }
+        }
+    }
+}
+
+TEST_F(StaffPatrolTests, HasPatrolArea)
+{
+    EXPECT_FALSE(staff_has_patrol_area(StaffIndex));
+    staff_toggle_patrol_area(StaffIndex, 40 * 32, 60 * 32);
+    EXPECT_TRUE(staff_has_patrol_area(StaffIndex));
+    EXPECT_TRUE(staff_is_patrol_area_set(StaffIndex, 41 * 32, 62 * 32));
+    staff_toggle_patrol_area(StaffIndex, 40 * 32, 60 * 32);
+    EXPECT_FALSE(staff_has_patrol_area(StaffIndex));
+}
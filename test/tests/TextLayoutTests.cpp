@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/Context.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/drawing/Font.h>
+#include <openrct2/drawing/TTF.h>
+#include <openrct2/localisation/FormatCodes.h>
+#include <openrct2/localisation/LocalisationService.h>
+#include <string>
+
+using namespace OpenRCT2;
+
+#ifndef NO_TTF
+
+// clang-format off
+static TTFFontSetDescriptor TestFontSmall = { {
+    { "DejaVuSans.ttf", "DejaVu Sans",  8, 0, 0,  9, 0, nullptr },
+    { "DejaVuSans.ttf", "DejaVu Sans",  9, 0, 0, 12, 0, nullptr },
+    { "DejaVuSans.ttf", "DejaVu Sans", 10, 0, 0, 12, 0, nullptr },
+} };
+
+static TTFFontSetDescriptor TestFontLarge = { {
+    { "DejaVuSans.ttf", "DejaVu Sans", 16, 0, 0, 18, 0, nullptr },
+    { "DejaVuSans.ttf", "DejaVu Sans", 18, 0, 0, 24, 0, nullptr },
+    { "DejaVuSans.ttf", "DejaVu Sans", 20, 0, 0, 24, 0, nullptr },
+} };
+// clang-format on
+
+class TextLayoutTests : public testing::Test
+{
+protected:
+    std::unique_ptr<IContext> _context;
+
+    void SetUp() override
+    {
+        _context = CreateContext();
+        gCurrentFontSpriteBase = FONT_SPRITE_BASE_MEDIUM;
+        gCurrentFontFlags = 0;
+    }
+
+    void TearDown() override
+    {
+        ttf_dispose();
+        gCurrentTTFFontSet = nullptr;
+        _context = nullptr;
+    }
+
+    // Loads a font the same way a language or font change does
+    bool LoadFont(TTFFontSetDescriptor& fontSet)
+    {
+        ttf_dispose();
+        _context->GetLocalisationService().UseTrueTypeFont(true);
+        gCurrentTTFFontSet = &fontSet;
+        return ttf_initialise();
+    }
+
+    void LoadSpriteFont()
+    {
+        ttf_dispose();
+        _context->GetLocalisationService().UseTrueTypeFont(false);
+        gCurrentTTFFontSet = nullptr;
+    }
+
+    // Measured straight from the font, without any of the caches
+    static int32_t GetUncachedWidth(const std::string& text)
+    {
+        int32_t width = 0;
+        int32_t height = 0;
+        TTF_SizeUTF8(ttf_get_font_from_sprite_base(FONT_SPRITE_BASE_MEDIUM)->font, text.c_str(), &width, &height);
+        return width;
+    }
+};
+
+// Skips a test when the font used for the tests is not installed
+#    ifdef GTEST_SKIP
+#        define REQUIRE_FONT(fontSet)                                                                                      \
+            if (!LoadFont(fontSet))                                                                                        \
+            {                                                                                                              \
+                GTEST_SKIP() << "The DejaVu Sans font is not installed";                                                   \
+            }
+#    else
+#        define REQUIRE_FONT(fontSet)                                                                                      \
+            if (!LoadFont(fontSet))                                                                                        \
+            {                                                                                                              \
+                std::printf("[  SKIPPED ] The DejaVu Sans font is not installed\n");                                       \
+                return;                                                                                                    \
+            }
+#    endif
+
+TEST_F(TextLayoutTests, CachedWidthMatchesUncachedWidth)
+{
+    REQUIRE_FONT(TestFontSmall);
+
+    const std::string text = "Merry-go-round 12";
+    const int32_t expected = GetUncachedWidth(text);
+    ASSERT_GT(expected, 0);
+    EXPECT_EQ(gfx_get_string_width(text.c_str()), expected);
+    // Taken from the cached layout this time
+    EXPECT_EQ(gfx_get_string_width(text.c_str()), expected);
+}
+
+TEST_F(TextLayoutTests, CachedWidthOfLinesIsWidestLine)
+{
+    REQUIRE_FONT(TestFontSmall);
+
+    const std::string first = "Short";
+    const std::string second = "A much longer second line";
+    const std::string text = first + (char)FORMAT_NEWLINE + second + (char)FORMAT_NEWLINE_SMALLER + first;
+    const int32_t expected = std::max(GetUncachedWidth(first), GetUncachedWidth(second));
+    EXPECT_EQ(gfx_get_string_width(text.c_str()), expected);
+    EXPECT_EQ(gfx_get_string_width(text.c_str()), expected);
+}
+
+TEST_F(TextLayoutTests, CachedWidthIncludesMoveX)
+{
+    REQUIRE_FONT(TestFontSmall);
+
+    const std::string run = "Queue";
+    const std::string text = std::string(1, (char)FORMAT_MOVE_X) + (char)40 + run;
+    const int32_t expected = 40 + GetUncachedWidth(run);
+    EXPECT_EQ(gfx_get_string_width(text.c_str()), expected);
+    EXPECT_EQ(gfx_get_string_width(text.c_str()), expected);
+}
+
+TEST_F(TextLayoutTests, FontChangeInvalidatesLayouts)
+{
+    REQUIRE_FONT(TestFontSmall);
+
+    const std::string text = "Roller Coaster";
+    const int32_t smallWidth = gfx_get_string_width(text.c_str());
+    EXPECT_EQ(smallWidth, GetUncachedWidth(text));
+
+    ASSERT_TRUE(LoadFont(TestFontLarge));
+    const int32_t largeWidth = gfx_get_string_width(text.c_str());
+    EXPECT_EQ(largeWidth, GetUncachedWidth(text));
+    EXPECT_GT(largeWidth, smallWidth);
+
+    ASSERT_TRUE(LoadFont(TestFontSmall));
+    EXPECT_EQ(gfx_get_string_width(text.c_str()), smallWidth);
+}
+
+TEST_F(TextLayoutTests, LanguageChangeToSpriteFontMeasuresSprites)
+{
+    REQUIRE_FONT(TestFontSmall);
+
+    const std::string text = "Roller Coaster";
+    EXPECT_EQ(gfx_get_string_width(text.c_str()), GetUncachedWidth(text));
+
+    LoadSpriteFont();
+    int32_t expected = 0;
+    for (char ch : text)
+    {
+        expected += font_sprite_get_codepoint_width(FONT_SPRITE_BASE_MEDIUM, ch);
+    }
+    EXPECT_EQ(gfx_get_string_width(text.c_str()), expected);
+}
+
+#endif // NO_TTF
@@ -0,0 +1,193 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2019 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <iterator>
+#include <openrct2/world/Sprite.h>
+#include <random>
+#include <vector>
+
+class VehicleSpatialIndexTests : public testing::Test
+{
+protected:
+    // Sprites are only placed on these tiles, so every quadrant in use can be checked after each change
+    static constexpr int32_t AreaSize = 12;
+
+    std::mt19937 _random{ 4321 };
+
+    void SetUp() override
+    {
+        reset_sprite_list();
+    }
+
+    void TearDown() override
+    {
+        sprite_vehicle_spatial_index_end();
+        reset_sprite_list();
+    }
+
+    rct_sprite* CreateSprite(SPRITE_IDENTIFIER identifier)
+    {
+        rct_sprite* sprite = create_sprite(identifier);
+        if (sprite != nullptr)
+        {
+            MoveToRandomTile(sprite);
+        }
+        return sprite;
+    }
+
+    void MoveToRandomTile(rct_sprite* sprite)
+    {
+        // Now and then off the map, which takes the sprite out of every quadrant that can be looked up
+        std::uniform_int_distribution<int32_t> coord(-16, AreaSize * 32 - 1);
+        sprite_move(coord(_random), coord(_random), 0, sprite);
+    }
+
+    void CreateSprites(int32_t count)
+    {
+        static constexpr SPRITE_IDENTIFIER Identifiers[] = { SPRITE_IDENTIFIER_VEHICLE, SPRITE_IDENTIFIER_MISC,
+                                                             SPRITE_IDENTIFIER_LITTER };
+        std::uniform_int_distribution<size_t> identifier(0, std::size(Identifiers) - 1);
+        for (int32_t i = 0; i < count; i++)
+        {
+            CreateSprite(Identifiers[identifier(_random)]);
+        }
+    }
+
+    std::vector<rct_sprite*> GetSprites(SPRITE_LIST list)
+    {
+        std::vector<rct_sprite*> sprites;
+        for (uint16_t spriteIndex = gSpriteListHead[list]; spriteIndex != SPRITE_INDEX_NULL;
+             spriteIndex = get_sprite(spriteIndex)->generic.next)
+        {
+            sprites.push_back(get_sprite(spriteIndex));
+        }
+        return sprites;
+    }
+
+    rct_sprite* GetRandomSprite(SPRITE_LIST list)
+    {
+        auto sprites = GetSprites(list);
+        if (sprites.empty())
+            return nullptr;
+        std::uniform_int_distribution<size_t> index(0, sprites.size() - 1);
+        return sprites[index(_random)];
+    }
+
+    // The vehicles of the quadrant as found in the full sprite spatial index
+    static std::vector<uint16_t> GetVehiclesInQuadrant(int32_t x, int32_t y)
+    {
+        std::vector<uint16_t> vehicles;
+        for (uint16_t spriteIndex = sprite_get_first_in_quadrant(x, y); spriteIndex != SPRITE_INDEX_NULL;
+             spriteIndex = get_sprite(spriteIndex)->generic.next_in_quadrant)
+        {
+            if (get_sprite(spriteIndex)->generic.sprite_identifier == SPRITE_IDENTIFIER_VEHICLE)
+            {
+                vehicles.push_back(spriteIndex);
+            }
+        }
+        return vehicles;
+    }
+
+    static std::vector<uint16_t> GetIndexedVehiclesInQuadrant(int32_t x, int32_t y)
+    {
+        std::vector<uint16_t> vehicles;
+        for (uint16_t spriteIndex = sprite_get_first_vehicle_in_quadrant(x, y); spriteIndex != SPRITE_INDEX_NULL;
+             spriteIndex = sprite_get_next_vehicle_in_quadrant(spriteIndex))
+        {
+            vehicles.push_back(spriteIndex);
+            if (vehicles.size() > MAX_SPRITES)
+                break;
+        }
+        return vehicles;
+    }
+
+    static ::testing::AssertionResult IndexMatchesSpatialIndex()
+    {
+        for (int32_t y = 0; y < AreaSize * 32; y += 32)
+        {
+            for (int32_t x = 0; x < AreaSize * 32; x += 32)
+            {
+                if (GetIndexedVehiclesInQuadrant(x, y) != GetVehiclesInQuadrant(x, y))
+                    return ::testing::AssertionFailure() << "vehicles differ on tile " << x / 32 << ", " << y / 32;
+            }
+        }
+        return ::testing::AssertionSuccess();
+    }
+};
+
+TEST_F(VehicleSpatialIndexTests, MatchesSpatialIndexWhenBuilt)
+{
+    CreateSprites(600);
+    EXPECT_TRUE(IndexMatchesSpatialIndex()) << "before the index is built";
+    sprite_vehicle_spatial_index_begin();
+    EXPECT_TRUE(IndexMatchesSpatialIndex());
+    sprite_vehicle_spatial_index_end();
+    EXPECT_TRUE(IndexMatchesSpatialIndex()) << "after the index is no longer used";
+}
+
+TEST_F(VehicleSpatialIndexTests, StaysInSyncWhenSpritesMoveAndAreRemoved)
+{
+    CreateSprites(600);
+    sprite_vehicle_spatial_index_begin();
+
+    std::uniform_int_distribution<int32_t> operation(0, 9);
+    for (int32_t i = 0; i < 3000; i++)
+    {
+        const int32_t op = operation(_random);
+        rct_sprite* sprite = nullptr;
+        if (op < 5)
+        {
+            if ((sprite = GetRandomSprite(SPRITE_LIST_VEHICLE)) != nullptr)
+                MoveToRandomTile(sprite);
+        }
+        else if (op == 5)
+        {
+            if ((sprite = GetRandomSprite(SPRITE_LIST_LITTER)) != nullptr)
+                MoveToRandomTile(sprite);
+        }
+        else if (op == 6)
+        {
+            if ((sprite = GetRandomSprite(SPRITE_LIST_VEHICLE)) != nullptr)
+                sprite_remove(sprite);
+        }
+        else if (op == 7)
+        {
+            if ((sprite = GetRandomSprite(SPRITE_LIST_MISC)) != nullptr)
+                sprite_remove(sprite);
+        }
+        else
+        {
+            // Takes the sprite of a removed one again, as vehicles are created during the update
+            CreateSprite(op == 8 ? SPRITE_IDENTIFIER_VEHICLE : SPRITE_IDENTIFIER_MISC);
+        }
+        ASSERT_TRUE(IndexMatchesSpatialIndex()) << "after operation " << i << " of type " << op;
+    }
+}
+
+TEST_F(VehicleSpatialIndexTests, RebuildDropsChangesMadeWhileNotUsed)
+{
+    CreateSprites(300);
+    sprite_vehicle_spatial_index_begin();
+    sprite_vehicle_spatial_index_end();
+
+    // Not tracked, the next update has to start from the sprite spatial index again
+    for (auto sprite : GetSprites(SPRITE_LIST_VEHICLE))
+    {
+        MoveToRandomTile(sprite);
+    }
+    for (int32_t i = 0; i < 20; i++)
+    {
+        if (auto sprite = GetRandomSprite(SPRITE_LIST_VEHICLE))
+            sprite_remove(sprite);
+    }
+
+    sprite_vehicle_spatial_index_begin();
+    EXPECT_TRUE(IndexMatchesSpatialIndex());
+}